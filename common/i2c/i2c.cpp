@@ -1,7 +1,14 @@
 #include "i2c.hpp"
 
+#include "i2c_trace.hpp"
+
 #include <unistd.h>
 
+#include <phosphor-logging/lg2.hpp>
+
+#include <array>
+#include <limits>
+
 extern "C"
 {
 #include <i2c/smbus.h>
@@ -12,10 +19,59 @@ extern "C"
 namespace phosphor::i2c
 {
 
+static std::shared_ptr<Backend>& installedBackend()
+{
+    static std::shared_ptr<Backend> backend;
+    return backend;
+}
+
+void Backend::install(std::shared_ptr<Backend> backend)
+{
+    installedBackend() = std::move(backend);
+}
+
+std::shared_ptr<Backend> Backend::installed()
+{
+    return installedBackend();
+}
+
+Target::Target(uint16_t bus, int fd, std::shared_ptr<Backend> backend) :
+    bus(bus), fd(fd), backend(std::move(backend))
+{}
+
+Target::~Target()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+}
+
+bool Target::transfer(struct i2c_msg* msgs, uint32_t nmsgs) const
+{
+    if (backend)
+    {
+        return backend->transfer(bus, msgs, nmsgs);
+    }
+
+    struct i2c_rdwr_ioctl_data readWriteData;
+    readWriteData.msgs = msgs;
+    readWriteData.nmsgs = nmsgs;
+
+    return ioctl(fd, I2C_RDWR, &readWriteData) >= 0;
+}
+
 int I2C::open()
 {
+    auto backend = Backend::installed();
+    if (backend)
+    {
+        target = std::make_shared<Target>(busId, -1, std::move(backend));
+        return 0;
+    }
+
     int ret = 0;
-    fd = ::open(busStr.c_str(), O_RDWR);
+    int fd = ::open(busStr.c_str(), O_RDWR);
     if (fd < 0)
     {
         return fd;
@@ -24,28 +80,29 @@ int I2C::open()
     ret = ioctl(fd, I2C_SLAVE_FORCE, deviceNode);
     if (ret < 0)
     {
-        close();
+        ::close(fd);
         return ret;
     }
 
+    target = std::make_shared<Target>(busId, fd, nullptr);
+
     return 0;
 }
 
 sdbusplus::async::task<bool> I2C::sendReceive(
-    uint8_t* writeData, uint8_t writeSize, uint8_t* readData,
-    uint8_t readSize) const
+    uint8_t* writeData, uint8_t writeSize, uint8_t* readData, uint8_t readSize,
+    Priority priority) const
 {
     bool result = true;
 
-    if (fd <= 0)
+    if (!canTransfer())
     {
         result = false;
     }
     else
     {
         struct i2c_msg msg[2];
-        struct i2c_rdwr_ioctl_data readWriteData;
-        int msgIndex = 0;
+        uint32_t msgIndex = 0;
 
         if (writeSize)
         {
@@ -65,69 +122,171 @@ sdbusplus::async::task<bool> I2C::sendReceive(
             msgIndex++;
         }
 
-        readWriteData.msgs = msg;
-        readWriteData.nmsgs = msgIndex;
-
-        if (ioctl(fd, I2C_RDWR, &readWriteData) < 0)
-        {
-            result = false;
-        }
+        const auto start = std::chrono::steady_clock::now();
+        result = co_await I2CScheduler::instance().transfer(*this, msg,
+                                                            msgIndex, priority);
+        I2CTrace::instance().record(busId, deviceNode, msg, msgIndex, result,
+                                    start);
     }
     co_return result;
 }
 
 bool I2C::sendReceive(const std::vector<uint8_t>& writeData,
-                      std::vector<uint8_t>& readData) const
+                      std::vector<uint8_t>& readData, Priority priority) const
 {
-    bool result = true;
+    return sendReceive(std::span<const uint8_t>(writeData),
+                       std::span<uint8_t>(readData), priority);
+}
 
-    if (fd <= 0)
+bool I2C::sendReceive(std::span<const uint8_t> writeData,
+                      std::span<uint8_t> readData, Priority priority) const
+{
+    if (!canTransfer())
     {
         return false;
     }
-    else
+
+    struct i2c_msg msg[2];
+    uint32_t msgIndex = 0;
+
+    if (!writeData.empty())
     {
-        struct i2c_msg msg[2];
-        struct i2c_rdwr_ioctl_data readWriteData;
-        int msgIndex = 0;
+        msg[msgIndex].addr = deviceNode;
+        msg[msgIndex].flags = 0;
+        msg[msgIndex].len = writeData.size();
+        msg[msgIndex].buf = const_cast<uint8_t*>(writeData.data());
+        msgIndex++;
+    }
 
-        if (!writeData.empty())
-        {
-            msg[msgIndex].addr = deviceNode;
-            msg[msgIndex].flags = 0;
-            msg[msgIndex].len = writeData.size();
-            msg[msgIndex].buf = const_cast<uint8_t*>(writeData.data());
-            msgIndex++;
-        }
+    if (!readData.empty())
+    {
+        msg[msgIndex].addr = deviceNode;
+        msg[msgIndex].flags = I2C_M_RD;
+        msg[msgIndex].len = readData.size();
+        msg[msgIndex].buf = readData.data();
+        msgIndex++;
+    }
 
-        if (!readData.empty())
-        {
-            msg[msgIndex].addr = deviceNode;
-            msg[msgIndex].flags = I2C_M_RD;
-            msg[msgIndex].len = readData.size();
-            msg[msgIndex].buf = readData.data();
-            msgIndex++;
-        }
+    const auto start = std::chrono::steady_clock::now();
+    const bool result = I2CScheduler::instance().transferBlocking(
+        *this, msg, msgIndex, priority);
+    I2CTrace::instance().record(busId, deviceNode, msg, msgIndex, result,
+                                start);
 
-        readWriteData.msgs = msg;
-        readWriteData.nmsgs = msgIndex;
+    return result;
+}
 
-        if (ioctl(fd, I2C_RDWR, &readWriteData) < 0)
-        {
-            result = false;
-        }
+sdbusplus::async::task<bool> I2C::sendBatch(I2CBatch& batch,
+                                            Priority priority) const
+{
+    if (!canTransfer())
+    {
+        co_return false;
     }
 
-    return result;
+    if (batch.size() > I2CBatch::maxMessages)
+    {
+        // Splitting it would put a stop condition between the messages
+        lg2::error("I2C batch of {COUNT} messages exceeds {MAX}", "COUNT",
+                   batch.size(), "MAX", I2CBatch::maxMessages);
+        co_return false;
+    }
+
+    if (batch.empty())
+    {
+        co_return true;
+    }
+
+    std::array<struct i2c_msg, I2CBatch::maxMessages> msgs;
+
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        auto& message = batch.messages[i];
+        msgs[i] = {.addr = deviceNode,
+                   .flags = message.flags,
+                   .len = message.len,
+                   .buf = batch.storage.data() + message.offset};
+    }
+
+    const auto issued = std::chrono::steady_clock::now();
+    const bool result = co_await I2CScheduler::instance().transfer(
+        *this, msgs.data(), batch.size(), priority);
+    I2CTrace::instance().record(busId, deviceNode, msgs.data(), batch.size(),
+                                result, issued);
+
+    if (!result)
+    {
+        co_return false;
+    }
+
+    for (auto& message : batch.messages)
+    {
+        message.done = true;
+    }
+
+    co_return true;
 }
 
-void I2C::close()
+std::optional<size_t> I2CBatch::write(std::span<const uint8_t> data)
 {
-    if (fd != invalidFd)
+    if (data.size() > std::numeric_limits<uint16_t>::max() ||
+        messages.size() >= maxMessages)
     {
-        ::close(fd);
-        fd = invalidFd;
+        return std::nullopt;
     }
+
+    messages.push_back({.flags = 0,
+                        .len = static_cast<uint16_t>(data.size()),
+                        .offset = storage.size(),
+                        .done = false});
+    storage.insert(storage.end(), data.begin(), data.end());
+    return messages.size() - 1;
+}
+
+std::optional<size_t> I2CBatch::read(uint16_t size)
+{
+    if (messages.size() >= maxMessages)
+    {
+        return std::nullopt;
+    }
+
+    messages.push_back({.flags = I2C_M_RD,
+                        .len = size,
+                        .offset = storage.size(),
+                        .done = false});
+    storage.resize(storage.size() + size, 0);
+    return messages.size() - 1;
+}
+
+bool I2CBatch::succeeded(size_t index) const
+{
+    return index < messages.size() && messages[index].done;
+}
+
+std::span<const uint8_t> I2CBatch::readData(size_t index) const
+{
+    if (!succeeded(index) || (messages[index].flags & I2C_M_RD) == 0)
+    {
+        return {};
+    }
+
+    return {storage.data() + messages[index].offset, messages[index].len};
+}
+
+void I2CBatch::clear()
+{
+    messages.clear();
+    storage.clear();
+}
+
+bool I2C::transfer(struct i2c_msg* msgs, uint32_t nmsgs) const
+{
+    return target && target->transfer(msgs, nmsgs);
+}
+
+void I2C::close()
+{
+    target.reset();
 }
 
 } // namespace phosphor::i2c
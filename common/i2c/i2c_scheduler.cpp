@@ -0,0 +1,493 @@
+#include "i2c_scheduler.hpp"
+
+#include "i2c.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/async/fdio.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <optional>
+
+namespace phosphor::i2c
+{
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+// time after which a queued job is served regardless of its priority
+constexpr auto maxPriorityWait = std::chrono::milliseconds(100);
+
+I2CScheduler& I2CScheduler::instance()
+{
+    static I2CScheduler scheduler;
+    return scheduler;
+}
+
+I2CScheduler::~I2CScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    for (auto& [_, bus] : buses)
+    {
+        bus->cv.notify_all();
+        if (bus->thread.joinable())
+        {
+            bus->thread.join();
+        }
+    }
+}
+
+void I2CScheduler::attach(sdbusplus::async::context& ctxIn)
+{
+    ctx = &ctxIn;
+}
+
+I2CScheduler::Job::Job() : eventFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {}
+
+I2CScheduler::Job::~Job()
+{
+    if (eventFd >= 0)
+    {
+        ::close(eventFd);
+    }
+}
+
+void I2CScheduler::Job::assign(const I2C& device, const struct i2c_msg* msgsIn,
+                               uint32_t nmsgs)
+{
+    target = device.getTarget();
+    bus = device.bus();
+    address = device.address();
+    msgs.assign(msgsIn, msgsIn + nmsgs);
+
+    size_t size = 0;
+    for (const auto& msg : msgs)
+    {
+        size += msg.len;
+    }
+
+    // Keeps the capacity of earlier transfers, so a reused job only
+    // allocates for a transfer larger than all it did before.
+    data.resize(size);
+
+    uint8_t* buf = data.data();
+    for (auto& msg : msgs)
+    {
+        if ((msg.flags & I2C_M_RD) == 0)
+        {
+            std::copy_n(msg.buf, msg.len, buf);
+        }
+
+        msg.buf = buf;
+        buf += msg.len;
+    }
+}
+
+void I2CScheduler::Job::copyReadData(struct i2c_msg* msgsOut) const
+{
+    for (size_t i = 0; i < msgs.size(); i++)
+    {
+        if ((msgs[i].flags & I2C_M_RD) != 0)
+        {
+            std::copy_n(msgs[i].buf, msgs[i].len, msgsOut[i].buf);
+        }
+    }
+}
+
+I2CScheduler::JobLease I2CScheduler::acquire(
+    const I2C& device, const struct i2c_msg* msgs, uint32_t nmsgs)
+{
+    std::unique_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!freeJobs.empty())
+        {
+            job = std::move(freeJobs.back());
+            freeJobs.pop_back();
+        }
+    }
+
+    if (!job)
+    {
+        job = std::make_unique<Job>();
+        if (job->eventFd < 0)
+        {
+            return JobLease(nullptr, JobRelease{this});
+        }
+    }
+
+    job->assign(device, msgs, nmsgs);
+    job->state = Job::State::queued;
+    job->result = false;
+    job->abandoned = false;
+
+    return JobLease(job.release(), JobRelease{this});
+}
+
+void I2CScheduler::release(Job* job)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (job->state != Job::State::done)
+    {
+        // The I/O thread still holds it, and recycles it when it gets to it
+        job->abandoned = true;
+        return;
+    }
+
+    // Drop a completion the caller did not consume, e.g. after a timeout or
+    // when the coroutine was cancelled.
+    uint64_t count = 0;
+    [[maybe_unused]] ssize_t drained =
+        ::read(job->eventFd, &count, sizeof(count));
+
+    recycle(job);
+}
+
+void I2CScheduler::recycle(Job* job)
+{
+    job->target.reset();
+
+    if (freeJobs.size() < maxFreeJobs)
+    {
+        freeJobs.emplace_back(job);
+    }
+    else
+    {
+        delete job;
+    }
+}
+
+sdbusplus::async::task<bool> I2CScheduler::transfer(
+    const I2C& device, struct i2c_msg* msgs, uint32_t nmsgs, Priority priority)
+{
+    auto* context = ctx.load();
+    if (context == nullptr)
+    {
+        co_return device.transfer(msgs, nmsgs);
+    }
+
+    auto job = acquire(device, msgs, nmsgs);
+    if (!job)
+    {
+        co_return device.transfer(msgs, nmsgs);
+    }
+
+    enqueue(*job, priority);
+
+    // The eventfd is level triggered, so a completion which happens before
+    // we start waiting is not lost.
+    sdbusplus::async::fdio fdio(*context, job->eventFd);
+    co_await fdio.next();
+
+    uint64_t count = 0;
+    if (::read(job->eventFd, &count, sizeof(count)) != sizeof(count))
+    {
+        co_return false;
+    }
+
+    bool result = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        result = job->result;
+    }
+
+    job->copyReadData(msgs);
+
+    co_return result;
+}
+
+bool I2CScheduler::transferBlocking(const I2C& device, struct i2c_msg* msgs,
+                                    uint32_t nmsgs, Priority priority)
+{
+    if (ctx.load() == nullptr)
+    {
+        return device.transfer(msgs, nmsgs);
+    }
+
+    Bus* bus = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        bus = &getBus(device.bus());
+        if (bus->busy || bus->stats.queueDepth != 0)
+        {
+            bus = nullptr;
+        }
+        else
+        {
+            // Nothing to wait for, so skip the queue and the I/O thread
+            bus->busy = true;
+            bus->stats.queueDepth++;
+            bus->stats.maxQueueDepth =
+                std::max<size_t>(bus->stats.maxQueueDepth, 1);
+        }
+    }
+
+    if (bus != nullptr)
+    {
+        const auto start = steady_clock::now();
+        const bool result = device.transfer(msgs, nmsgs);
+        const auto end = steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            bus->busy = false;
+            bus->stats.queueDepth--;
+            bus->stats.transactions++;
+            bus->stats.totalBusy += duration_cast<microseconds>(end - start);
+        }
+
+        bus->cv.notify_one();
+
+        return result;
+    }
+
+    auto job = acquire(device, msgs, nmsgs);
+    if (!job)
+    {
+        return device.transfer(msgs, nmsgs);
+    }
+
+    enqueue(*job, priority);
+
+    struct pollfd pollFd{};
+    pollFd.fd = job->eventFd;
+    pollFd.events = POLLIN;
+
+    const auto deadline = steady_clock::now() + maxBlockingWait;
+    int timeout = static_cast<int>(
+        duration_cast<milliseconds>(maxBlockingWait).count());
+
+    while (true)
+    {
+        const int ret = ::poll(&pollFd, 1, timeout);
+        if (ret > 0)
+        {
+            break;
+        }
+
+        if (ret < 0 && errno != EINTR)
+        {
+            return false;
+        }
+
+        if (timeout < 0)
+        {
+            continue;
+        }
+
+        const auto left = deadline - steady_clock::now();
+        if (left > steady_clock::duration::zero())
+        {
+            timeout = static_cast<int>(
+                duration_cast<milliseconds>(left).count() + 1);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (job->state == Job::State::queued)
+        {
+            // The I/O thread skips it, and recycles it once the lease is gone
+            job->abandoned = true;
+            lg2::error(
+                "I2C transfer to {BUS}-{ADDR} not started within {MS} ms",
+                "BUS", job->bus, "ADDR", lg2::hex, job->address, "MS",
+                duration_cast<milliseconds>(maxBlockingWait).count());
+            return false;
+        }
+
+        // Once on the bus, the adapter timeout bounds the transfer
+        timeout = -1;
+    }
+
+    uint64_t count = 0;
+    if (::read(job->eventFd, &count, sizeof(count)) != sizeof(count))
+    {
+        return false;
+    }
+
+    bool result = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        result = job->result;
+    }
+
+    job->copyReadData(msgs);
+
+    return result;
+}
+
+I2CScheduler::Bus& I2CScheduler::getBus(uint16_t busId)
+{
+    auto& bus = buses[busId];
+    if (!bus)
+    {
+        bus = std::make_unique<Bus>();
+        bus->thread = std::thread(&I2CScheduler::run, this, std::ref(*bus));
+    }
+
+    return *bus;
+}
+
+void I2CScheduler::enqueue(Job& job, Priority priority)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto& bus = getBus(job.bus);
+
+    job.queued = steady_clock::now();
+
+    const auto level = static_cast<size_t>(priority);
+    auto& device = bus.pending[level][job.address];
+    if (device.jobs.empty())
+    {
+        bus.ready[level].push(&device);
+    }
+    device.jobs.push(&job);
+
+    bus.stats.queueDepth++;
+    bus.stats.maxQueueDepth =
+        std::max(bus.stats.maxQueueDepth, bus.stats.queueDepth);
+
+    bus.cv.notify_one();
+}
+
+BusStats I2CScheduler::stats(uint16_t busId)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = buses.find(busId);
+    if (it == buses.end())
+    {
+        return {};
+    }
+
+    return it->second->stats;
+}
+
+I2CScheduler::Job* I2CScheduler::dequeue(Bus& bus)
+{
+    const auto now = steady_clock::now();
+
+    std::optional<size_t> selected;
+    std::optional<steady_clock::time_point> oldest;
+
+    for (size_t level = 0; level < priorityCount; level++)
+    {
+        const auto& ready = bus.ready[level];
+        if (ready.empty())
+        {
+            continue;
+        }
+
+        if (!selected.has_value())
+        {
+            selected = level;
+        }
+
+        // A job which waited for too long is served before the jobs of
+        // higher priority, so a steady stream of them cannot starve it.
+        const auto queued = ready.head->jobs.head->queued;
+        if (now - queued >= maxPriorityWait &&
+            (!oldest.has_value() || queued < oldest.value()))
+        {
+            selected = level;
+            oldest = queued;
+        }
+    }
+
+    if (!selected.has_value())
+    {
+        return nullptr;
+    }
+
+    auto& ready = bus.ready[selected.value()];
+
+    DeviceQueue* device = ready.pop();
+    Job* job = device->jobs.pop();
+
+    // Go to the back of the line if there is more to do for this device
+    if (!device->jobs.empty())
+    {
+        ready.push(device);
+    }
+
+    return job;
+}
+
+void I2CScheduler::run(Bus& bus)
+{
+    while (true)
+    {
+        Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            bus.cv.wait(lock, [this, &bus, &job] {
+                return stopping ||
+                       (!bus.busy && (job = dequeue(bus)) != nullptr);
+            });
+
+            if (stopping)
+            {
+                return;
+            }
+
+            if (job->abandoned)
+            {
+                bus.stats.queueDepth--;
+                recycle(job);
+                continue;
+            }
+
+            job->state = Job::State::running;
+            bus.busy = true;
+        }
+
+        const auto start = steady_clock::now();
+        const bool result =
+            job->target && job->target->transfer(job->msgs.data(),
+                                                 job->msgs.size());
+        const auto end = steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            const auto wait = duration_cast<microseconds>(start - job->queued);
+            bus.busy = false;
+            bus.stats.queueDepth--;
+            bus.stats.transactions++;
+            bus.stats.totalWait += wait;
+            bus.stats.maxWait = std::max(bus.stats.maxWait, wait);
+            bus.stats.totalBusy += duration_cast<microseconds>(end - start);
+
+            if (job->abandoned)
+            {
+                recycle(job);
+                continue;
+            }
+
+            job->result = result;
+            job->state = Job::State::done;
+
+            // Writing to an eventfd only fails on counter overflow, which
+            // cannot happen with a single completion per job.
+            const uint64_t one = 1;
+            [[maybe_unused]] ssize_t written =
+                ::write(job->eventFd, &one, sizeof(one));
+        }
+    }
+}
+
+} // namespace phosphor::i2c
@@ -0,0 +1,134 @@
+#include "i2c_simulator.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace phosphor::i2c
+{
+
+void ScriptedDevice::respond(uint8_t cmd, std::vector<uint8_t> response)
+{
+    readHandlers[cmd] = [response = std::move(response)]() {
+        return response;
+    };
+}
+
+void ScriptedDevice::onRead(uint8_t cmd, ReadHandler handler)
+{
+    readHandlers[cmd] = std::move(handler);
+}
+
+void ScriptedDevice::onWrite(uint8_t cmd, WriteHandler handler)
+{
+    writeHandlers[cmd] = std::move(handler);
+}
+
+size_t ScriptedDevice::writeCount(uint8_t cmd) const
+{
+    auto it = writes.find(cmd);
+    return it == writes.end() ? 0 : it->second;
+}
+
+bool ScriptedDevice::write(std::span<const uint8_t> data)
+{
+    if (data.empty())
+    {
+        return true;
+    }
+
+    command = data[0];
+    writes[command]++;
+
+    auto it = writeHandlers.find(command);
+    if (it == writeHandlers.end())
+    {
+        return true;
+    }
+
+    return it->second(data.subspan(1));
+}
+
+bool ScriptedDevice::read(std::span<uint8_t> data)
+{
+    std::ranges::fill(data, 0);
+
+    auto it = readHandlers.find(command);
+    if (it == readHandlers.end())
+    {
+        return true;
+    }
+
+    const auto response = it->second();
+    std::copy_n(response.begin(), std::min(response.size(), data.size()),
+                data.begin());
+
+    return true;
+}
+
+void Simulator::addDevice(uint16_t bus, uint16_t address,
+                          std::shared_ptr<DeviceModel> device)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    devices[{bus, address}] = std::move(device);
+}
+
+void Simulator::setLatency(std::chrono::microseconds perTransfer,
+                           std::chrono::microseconds perByte)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    transferLatency = perTransfer;
+    byteLatency = perByte;
+}
+
+bool Simulator::transfer(uint16_t bus, struct i2c_msg* msgs, uint32_t nmsgs)
+{
+    std::chrono::microseconds latency{0};
+    bool result = true;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        transferCount++;
+        latency = transferLatency;
+
+        for (uint32_t i = 0; i < nmsgs; i++)
+        {
+            auto& msg = msgs[i];
+            latency += byteLatency * msg.len;
+
+            auto it = devices.find({bus, msg.addr});
+            if (it == devices.end())
+            {
+                result = false;
+                break;
+            }
+
+            if (msg.flags & I2C_M_RD)
+            {
+                result = it->second->read(std::span(msg.buf, msg.len));
+            }
+            else
+            {
+                result = it->second->write(std::span(msg.buf, msg.len));
+            }
+
+            // Like the adapter, stop at the first message which is NACKed
+            if (!result)
+            {
+                break;
+            }
+        }
+    }
+
+    std::this_thread::sleep_for(latency);
+
+    return result;
+}
+
+uint64_t Simulator::transfers() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return transferCount;
+}
+
+} // namespace phosphor::i2c
@@ -0,0 +1,210 @@
+#include "i2c_trace.hpp"
+
+#include "i2c_scheduler.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <set>
+
+namespace phosphor::i2c
+{
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+// How often the dump file is refreshed
+static constexpr auto dumpInterval = std::chrono::seconds(10);
+
+size_t DeviceTrace::bucket(microseconds value)
+{
+    size_t index = 0;
+    auto bound = firstBucket;
+
+    while (index < bucketCount - 1 && value > bound)
+    {
+        bound *= 2;
+        index++;
+    }
+
+    return index;
+}
+
+I2CTrace& I2CTrace::instance()
+{
+    static I2CTrace trace;
+    return trace;
+}
+
+void I2CTrace::enable()
+{
+    isEnabled = true;
+}
+
+void I2CTrace::enable(sdbusplus::async::context& ctx, const std::string& path)
+{
+    if (isEnabled.exchange(true))
+    {
+        return;
+    }
+
+    lg2::info("Tracing i2c transactions to {PATH}", "PATH", path);
+
+    ctx.spawn(dumpPeriodically(ctx, path));
+}
+
+void I2CTrace::record(uint16_t bus, uint16_t address,
+                      const struct i2c_msg* msgs, uint32_t nmsgs,
+                      bool success, steady_clock::time_point start)
+{
+    if (!isEnabled)
+    {
+        return;
+    }
+
+    const auto latency =
+        duration_cast<microseconds>(steady_clock::now() - start);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto& trace = devices[{bus, address}];
+    trace.transactions++;
+    if (!success)
+    {
+        trace.errors++;
+    }
+
+    for (uint32_t i = 0; i < nmsgs; i++)
+    {
+        if (msgs[i].flags & I2C_M_RD)
+        {
+            trace.bytesRead += msgs[i].len;
+        }
+        else
+        {
+            trace.bytesWritten += msgs[i].len;
+        }
+    }
+
+    trace.totalLatency += latency;
+    trace.maxLatency = std::max(trace.maxLatency, latency);
+    trace.latency[DeviceTrace::bucket(latency)]++;
+
+    generation++;
+}
+
+std::map<I2CTrace::DeviceKey, DeviceTrace> I2CTrace::snapshot()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return devices;
+}
+
+std::string I2CTrace::dump()
+{
+    std::string out;
+    std::set<uint16_t> buses;
+
+    for (const auto& [key, trace] : snapshot())
+    {
+        const auto& [bus, address] = key;
+        buses.insert(bus);
+
+        const uint64_t average =
+            trace.transactions ? trace.totalLatency.count() / trace.transactions
+                               : 0;
+
+        out += std::format(
+            "device {}-{:04x}: transactions {} errors {} written {} read {} "
+            "avg {}us max {}us\n",
+            bus, address, trace.transactions, trace.errors,
+            trace.bytesWritten, trace.bytesRead, average,
+            trace.maxLatency.count());
+
+        out += "  latency";
+        auto bound = DeviceTrace::firstBucket;
+        for (size_t i = 0; i < DeviceTrace::bucketCount; i++)
+        {
+            if (i == DeviceTrace::bucketCount - 1)
+            {
+                out += std::format(" >{}us:{}", bound.count() / 2,
+                                   trace.latency[i]);
+            }
+            else
+            {
+                out += std::format(" <={}us:{}", bound.count(),
+                                   trace.latency[i]);
+                bound *= 2;
+            }
+        }
+        out += "\n";
+    }
+
+    for (const auto bus : buses)
+    {
+        const auto stats = I2CScheduler::instance().stats(bus);
+        const uint64_t averageWait =
+            stats.transactions ? stats.totalWait.count() / stats.transactions
+                               : 0;
+
+        out += std::format(
+            "bus {}: queued {} max queued {} scheduled {} avg wait {}us "
+            "max wait {}us busy {}us\n",
+            bus, stats.queueDepth, stats.maxQueueDepth, stats.transactions,
+            averageWait, stats.maxWait.count(),
+            stats.totalBusy.count());
+    }
+
+    return out;
+}
+
+bool I2CTrace::dumpToFile(const std::string& path)
+{
+    const std::string tmpPath = path + ".tmp";
+
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        file << dump();
+        if (!file)
+        {
+            lg2::error("Failed to write i2c trace to {PATH}", "PATH", tmpPath);
+            return false;
+        }
+    }
+
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        lg2::error("Failed to move i2c trace to {PATH}", "PATH", path);
+        return false;
+    }
+
+    return true;
+}
+
+sdbusplus::async::task<> I2CTrace::dumpPeriodically(
+    sdbusplus::async::context& ctx, std::string path)
+{
+    uint64_t dumped = 0;
+
+    while (!ctx.stop_requested())
+    {
+        co_await sdbusplus::async::sleep_for(ctx, dumpInterval);
+
+        uint64_t current = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = generation;
+        }
+
+        if (current != dumped && dumpToFile(path))
+        {
+            dumped = current;
+        }
+    }
+
+    co_return;
+}
+
+} // namespace phosphor::i2c
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace phosphor::software
+{
+
+// A read-only mapping of a component image, backed by the package file. Its
+// pages are read on demand and can be reclaimed, unlike a heap copy.
+class ComponentMapping
+{
+  public:
+    ComponentMapping(void* base, size_t length, std::span<const uint8_t> data);
+    ~ComponentMapping();
+
+    ComponentMapping(const ComponentMapping&) = delete;
+    ComponentMapping& operator=(const ComponentMapping&) = delete;
+    ComponentMapping(ComponentMapping&&) = delete;
+    ComponentMapping& operator=(ComponentMapping&&) = delete;
+
+    std::span<const uint8_t> data() const
+    {
+        return image;
+    }
+
+  private:
+    void* base;
+    size_t length;
+    std::span<const uint8_t> image;
+};
+
+// Read access to one component image inside a PLDM package file. Only the
+// component's byte range is ever read, so the memory used by an update is
+// bounded by the buffers the driver passes in, not by the package size.
+class ComponentReader
+{
+  public:
+    // @param fd       file descriptor of the package, it is duplicated
+    // @param offset   offset of the component image in the package
+    // @param size     size of the component image
+    ComponentReader(int fd, off_t offset, size_t size);
+    ~ComponentReader();
+
+    ComponentReader(const ComponentReader&) = delete;
+    ComponentReader& operator=(const ComponentReader&) = delete;
+    ComponentReader(ComponentReader&&) = delete;
+    ComponentReader& operator=(ComponentReader&&) = delete;
+
+    size_t size() const
+    {
+        return componentSize;
+    }
+
+    // @param pos      offset within the component image
+    // @param buf      destination, at most 'buf.size()' bytes are read
+    // @returns        number of bytes read, 0 at the end of the component,
+    //                 -1 on error
+    ssize_t read(size_t pos, std::span<uint8_t> buf) const;
+
+    // @brief          Read the whole component image into 'out'.
+    // @returns        true on success
+    bool readAll(std::vector<uint8_t>& out) const;
+
+    // @brief          Map the component image, for drivers which need all of
+    //                 it at once but should not copy it to the heap.
+    // @returns        nullptr on failure
+    std::unique_ptr<ComponentMapping> map() const;
+
+  private:
+    int fd;
+    off_t componentOffset;
+    size_t componentSize;
+};
+
+} // namespace phosphor::software
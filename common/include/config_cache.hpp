@@ -0,0 +1,89 @@
+#pragma once
+
+#include <boost/container/flat_map.hpp>
+#include <sdbusplus/async/context.hpp>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace phosphor::software::config
+{
+
+using BasicVariantType =
+    std::variant<std::vector<std::string>, std::string, int64_t, uint64_t,
+                 double, int32_t, uint32_t, int16_t, uint16_t, uint8_t, bool>;
+using InterfacesMap = boost::container::flat_map<std::string, BasicVariantType>;
+using ConfigMap = boost::container::flat_map<std::string, InterfacesMap>;
+
+// Cache of the configuration interfaces read from entity-manager.
+// An interface is fetched with a single GetAll the first time one of its
+// properties is needed. The software manager keeps the cache current from the
+// InterfacesAdded / InterfacesRemoved signals.
+class ConfigCache
+{
+  public:
+    static ConfigCache& instance();
+
+    // @returns       the property, or std::nullopt if the interface could
+    //                not be fetched or does not have the property with
+    //                type 'T'
+    template <typename T>
+    sdbusplus::async::task<std::optional<T>> getProperty(
+        sdbusplus::async::context& ctx, const std::string& service,
+        const std::string& path, const std::string& interface,
+        const std::string& property)
+    {
+        if (!co_await fetch(ctx, service, path, interface))
+        {
+            co_return std::nullopt;
+        }
+
+        auto it = interfaces.find({path, interface});
+
+        if (it == interfaces.end())
+        {
+            co_return std::nullopt;
+        }
+
+        auto prop = it->second.find(property);
+
+        if (prop == it->second.end())
+        {
+            co_return std::nullopt;
+        }
+
+        if (const T* value = std::get_if<T>(&prop->second))
+        {
+            co_return *value;
+        }
+
+        co_return std::nullopt;
+    }
+
+    // @brief         Replace the cached properties of 'interface' at 'path'.
+    void update(const std::string& path, const std::string& interface,
+                const InterfacesMap& properties);
+
+    // @brief         Drop the cached properties of 'interface' at 'path'.
+    void remove(const std::string& path, const std::string& interface);
+
+  private:
+    ConfigCache() = default;
+
+    // @returns       true if the interface is cached, after fetching it with
+    //                GetAll if needed
+    sdbusplus::async::task<bool> fetch(sdbusplus::async::context& ctx,
+                                       const std::string& service,
+                                       const std::string& path,
+                                       const std::string& interface);
+
+    // (path, interface) -> properties
+    std::map<std::pair<std::string, std::string>, InterfacesMap> interfaces;
+};
+
+} // namespace phosphor::software::config
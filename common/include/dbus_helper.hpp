@@ -1,5 +1,7 @@
 #pragma once
 
+#include "config_cache.hpp"
+
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/async.hpp>
 #include <sdbusplus/async/context.hpp>
@@ -14,6 +16,16 @@ sdbusplus::async::task<std::optional<T>> dbusGetRequiredProperty(
     const std::string& path, const std::string& intf,
     const std::string& property)
 {
+    // Served from one GetAll of the interface in the common case.
+    std::optional<T> cached =
+        co_await phosphor::software::config::ConfigCache::instance()
+            .getProperty<T>(ctx, service, path, intf, property);
+
+    if (cached.has_value())
+    {
+        co_return cached;
+    }
+
     auto client =
         sdbusplus::async::proxy().service(service).path(path).interface(
             "org.freedesktop.DBus.Properties");
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "component_reader.hpp"
 #include "events.hpp"
+#include "progress_publisher.hpp"
 #include "software.hpp"
 #include "software_config.hpp"
+#include "update_timing.hpp"
 
 #include <sdbusplus/async/context.hpp>
 #include <xyz/openbmc_project/Association/Definitions/aserver.hpp>
@@ -10,11 +13,24 @@
 #include <xyz/openbmc_project/Software/Update/aserver.hpp>
 #include <xyz/openbmc_project/Software/Version/aserver.hpp>
 
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <string_view>
+#include <vector>
 
 using ActivationInterface =
     sdbusplus::common::xyz::openbmc_project::software::Activation;
 
+namespace pldm_package_util
+{
+class PackageIndex;
+struct ComponentLocation;
+} // namespace pldm_package_util
+
 namespace phosphor::software::manager
 {
 class SoftwareManager;
@@ -47,11 +63,39 @@ class Device
     virtual sdbusplus::async::task<bool> updateDevice(const uint8_t* image,
                                                       size_t image_size) = 0;
 
-    // @brief               Set the ActivationProgress properties on dbus
+    // @brief                      Applies the image to the device, reading
+    //                             it from the package on demand.
+    //                             Override this to update without holding
+    //                             the whole component in memory. The default
+    //                             copies the whole component to the heap
+    //                             with 'ComponentReader::readAll' and calls
+    //                             'updateDevice', which is only meant for
+    //                             small components, e.g. of VRs and CPLDs.
+    // @param component            reader for the component image
+    // @returns                    see 'updateDevice'
+    virtual sdbusplus::async::task<bool> updateDeviceStreaming(
+        const ComponentReader& component);
+
+    // @brief               Set the ActivationProgress properties on dbus.
+    // Updates are coalesced and rate limited before they are
+    // published, see 'ProgressPublisher'.
     // @param progress      progress value
-    // @returns             true on successful property update
+    // @returns             true if an update is in progress
     bool setUpdateProgress(uint8_t progress) const;
 
+    // @brief               Report the bytes written so far, to estimate the
+    //                      remaining time of the update.
+    // @param done          bytes written
+    // @param total         bytes to write in total
+    void setUpdateBytes(uint64_t done, uint64_t total) const;
+
+    // @brief               Mark the start of a driver specific stage of the
+    //                      update, e.g. "erase", "program" or "verify".
+    //                      The previous stage marked by the driver ends here,
+    //                      the last one when the update function returns.
+    // @param stage         name of the stage
+    void markUpdateStage(std::string_view stage);
+
     // @brief                      This coroutine is spawned to perform the
     // async update of the device.
     // @param image                The memory fd with the pldm package
@@ -65,6 +109,35 @@ class Device
     // Value of 'Type' field for the configuration in EM exposes record
     std::string getEMConfigType() const;
 
+    // @brief     Physical bus the update of the device is performed on.
+    //            When several devices are updated at once, devices sharing
+    //            a bus are updated one after the other.
+    // @returns   bus identifier, std::nullopt if the update does not
+    //            contend with other devices
+    virtual std::optional<std::string> getUpdateBus() const;
+
+    // @returns   true if an OnReset update has been staged, which is
+    //            waiting to be programmed by 'applyStagedUpdate'
+    bool hasStagedUpdate() const;
+
+    // @brief     Programs the staged image into the device and resets it.
+    //            Used with the 'staged-updates' option, once the host is off.
+    // @returns   true on success
+    sdbusplus::async::task<bool> applyStagedUpdate();
+
+    // @brief     Resources the update of the device needs exclusively, e.g.
+    //            its bus or mux GPIO lines. Updates of devices sharing a
+    //            resource are not run at the same time, see
+    //            'update::UpdateScheduler'.
+    // @returns   the update bus, if any, unless overridden
+    virtual std::set<std::string> getUpdateResources() const;
+
+    // @brief     Resources the update of the device can share with other
+    //            updates, e.g. 'update::hostPowerResource' for updates which
+    //            only run while the host is held off.
+    // @returns   none, unless overridden
+    virtual std::set<std::string> getSharedUpdateResources() const;
+
   protected:
     // The apply times for updates which are supported by the device
     // Override this if your device deviates from the default set of apply
@@ -87,6 +160,33 @@ class Device
     // apply it. This method is optional to implement for that reason.
     virtual sdbusplus::async::task<bool> resetDevice();
 
+    // @brief     Checks if the device already holds the component image, by
+    //            comparing the checksum expected from the image with the
+    //            one the device reports. The update then skips programming
+    //            the device. The default never skips.
+    // @param component    reader for the component image
+    // @returns   true if the image is programmed on the device
+    virtual sdbusplus::async::task<bool> isImageProgrammed(
+        const ComponentReader& component);
+
+    // @brief     Prepares the image of a staged update, when the update is
+    //            requested. Parse and validate the image here, so that
+    //            'updateDeviceStaged' only has to program it later.
+    //            The default keeps the component image as is.
+    // @param image        the component image
+    // @param image_size   size of 'image'
+    // @param staged       the device-ready image, kept in the staging
+    //                     directory until the update is applied
+    // @returns   true if the image is valid for the device
+    virtual sdbusplus::async::task<bool> stageImage(
+        const uint8_t* image, size_t image_size, std::vector<uint8_t>& staged);
+
+    // @brief     Programs an image prepared by 'stageImage'.
+    //            The default calls 'updateDevice'.
+    // @returns   true on success
+    virtual sdbusplus::async::task<bool> updateDeviceStaged(
+        const uint8_t* image, size_t image_size);
+
     // The common configuration that all devices share.
     // We get this from EM configuration.
     config::SoftwareConfig config;
@@ -99,24 +199,70 @@ class Device
 
     bool updateInProgress = false;
 
+    // Called with every progress update, while the device is part of an
+    // update of several devices.
+    std::function<void(uint8_t)> progressListener;
+
+    // Publishes the progress of the update in progress. Shared with the
+    // timer which publishes a value held back by the rate limit.
+    mutable std::shared_ptr<ProgressPublisher> progressPublisher;
+
   private:
-    // @param componentImage       component image as extracted from update pkg
-    // @param componentImageSize   size of 'componentImage'
+    // @brief     Validates the component and keeps the device-ready image
+    //            in the staging directory, instead of programming it.
+    // @returns   true on success
+    sdbusplus::async::task<bool> stageUpdate(const ComponentReader& component,
+                                             const std::string& version);
+
+    // @brief     Drops the staged image, if any.
+    void discardStagedUpdate();
+
+    // @returns   where the staged image of this device is kept
+    std::filesystem::path stagedImagePath() const;
+
+    // @brief     Publishes ActivationProgress for the pending software.
+    void startActivationProgress();
+
+    // @brief     Publishes the final progress and removes ActivationProgress.
+    void stopActivationProgress();
+
+    // @brief     Publishes the progress held back by 'publisher' after
+    //            'delay', unless the update has finished by then.
+    static sdbusplus::async::task<> flushProgressAfter(
+        sdbusplus::async::context& ctx,
+        std::weak_ptr<ProgressPublisher> publisher,
+        std::chrono::milliseconds delay);
+
+    // Version of the staged image, if an update has been staged
+    std::optional<std::string> stagedVersion;
+
+    // @brief     Record the timeline of the update which just completed.
+    // @param success   if the update was successful
+    void finishUpdateTimeline(bool success);
+
+    // Stage timings of the update in progress
+    std::optional<timing::UpdateTimeline> updateTimeline;
+
+    // Timelines of the last updates, logged and dumped for debugging
+    std::unique_ptr<timing::UpdateTimingHistory> timingHistory;
+
+    // @param component            component image as located in update pkg
+    // @param componentVersion     version of 'component'
     // @param applyTime            when the update should be applied
-    // @param softwarePendingIn    the pending software instance
     // @returns                    the return value of the device specific
     // update function
-    sdbusplus::async::task<bool> continueUpdateWithMappedPackage(
-        const uint8_t* componentImage, size_t componentImageSize,
-        const std::string& componentVersion, RequestedApplyTimes applyTime);
+    sdbusplus::async::task<bool> continueUpdateWithComponent(
+        const ComponentReader& component, const std::string& componentVersion,
+        RequestedApplyTimes applyTime);
 
-    // @brief     extracts the information we need from the pldm package
+    // @brief     looks up the component for this device in the package index
+    // @param packageIndex   index of the package, nullptr if it could not
+    //                       be parsed
     // @returns   true on success
     sdbusplus::async::task<bool> getImageInfo(
         const sdbusplus::object_path& objectPath,
-        std::unique_ptr<void, std::function<void(void*)>>& pldmPackage,
-        size_t pldmPackageSize, uint8_t** matchingComponentImage,
-        size_t* componentImageSize, std::string& componentVersion);
+        const pldm_package_util::PackageIndex* packageIndex,
+        pldm_package_util::ComponentLocation& component);
 
     friend update::SoftwareUpdate;
     friend Software;
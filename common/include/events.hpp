@@ -5,7 +5,8 @@
 #include <sdbusplus/message/native_types.hpp>
 #include <xyz/openbmc_project/State/Host/client.hpp>
 
-#include <map>
+#include <cstddef>
+#include <memory>
 #include <string>
 
 namespace phosphor::software::events
@@ -14,53 +15,49 @@ namespace phosphor::software::events
 using HostTransition =
     sdbusplus::common::xyz::openbmc_project::state::Host::Transition;
 
+// The generate* functions only queue the event and return right away, so
+// they can be called from the update flow without waiting for the logging
+// service. The queued events are committed in the background, in the order
+// they were generated for each target. Each event is still committed with a
+// call of its own, queueing only moves the calls off the update flow.
 class Events
 {
   public:
     Events() = delete;
 
-    explicit Events(sdbusplus::async::context& ctx) : ctx(ctx) {}
+    explicit Events(sdbusplus::async::context& ctx);
 
-    auto generateVerificationFailed(sdbusplus::object_path targetName,
-                                    std::string imageIdentifier, bool asserted)
-        -> sdbusplus::async::task<>;
+    void generateVerificationFailed(sdbusplus::object_path targetName,
+                                    std::string imageIdentifier, bool asserted);
 
-    auto generateActivateFailed(sdbusplus::object_path targetName,
-                                std::string imageIdentifier, bool asserted)
-        -> sdbusplus::async::task<>;
+    void generateActivateFailed(sdbusplus::object_path targetName,
+                                std::string imageIdentifier, bool asserted);
 
-    auto generateUpdateNotApplicable(sdbusplus::object_path targetName,
-                                     std::string imageIdentifier, bool asserted)
-        -> sdbusplus::async::task<>;
+    void generateUpdateNotApplicable(sdbusplus::object_path targetName,
+                                     std::string imageIdentifier,
+                                     bool asserted);
 
-    auto generateTargetDetermined(sdbusplus::object_path targetName,
-                                  std::string imageIdentifier)
-        -> sdbusplus::async::task<>;
+    void generateTargetDetermined(sdbusplus::object_path targetName,
+                                  std::string imageIdentifier);
 
-    auto generateUpdateSuccessful(sdbusplus::object_path targetName,
-                                  std::string imageIdentifier)
-        -> sdbusplus::async::task<>;
+    void generateUpdateSuccessful(sdbusplus::object_path targetName,
+                                  std::string imageIdentifier);
 
-    auto generateResetRequired(sdbusplus::object_path targetName,
-                               HostTransition resetType)
-        -> sdbusplus::async::task<>;
+    void generateResetRequired(sdbusplus::object_path targetName,
+                               HostTransition resetType);
 
-  private:
-    using event_map_t = std::map<std::string, sdbusplus::object_path>;
+    // @brief       Wait until all queued events have been committed,
+    //              including those queued while waiting
+    auto flush() -> sdbusplus::async::task<>;
 
-    template <typename ErrorType>
-    auto generateError(std::string_view errorName,
-                       sdbusplus::object_path targetName,
-                       std::string imageIdentifier, bool asserted)
-        -> sdbusplus::async::task<>;
+    // @returns     the number of queued events not yet committed
+    size_t queued() const;
 
-    template <typename EventType>
-    auto generateEvent(std::string_view eventName,
-                       sdbusplus::object_path targetName,
-                       std::string imageIdentifier) -> sdbusplus::async::task<>;
+  private:
+    class Queue;
 
-    sdbusplus::async::context& ctx;
-    event_map_t pendingEvents;
+    // Shared with the background commits, which may outlive this object.
+    std::shared_ptr<Queue> queue;
 };
 
 } // namespace phosphor::software::events
@@ -3,6 +3,7 @@
 #include <gpiod.hpp>
 
 #include <string>
+#include <vector>
 
 std::vector<std::unique_ptr<::gpiod::line_bulk>> requestMuxGPIOs(
     const std::vector<std::string>& gpioLines,
@@ -28,6 +29,8 @@ class GPIOGroup
 
     bool hasGPIOs() const;
 
+    const std::vector<std::string>& getLines() const;
+
     GPIOGroup(const GPIOGroup&) = delete;
     GPIOGroup& operator=(const GPIOGroup&) = delete;
     GPIOGroup(GPIOGroup&& /*other*/) noexcept;
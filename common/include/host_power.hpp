@@ -4,6 +4,11 @@
 #include <sdbusplus/async/match.hpp>
 #include <xyz/openbmc_project/State/Host/client.hpp>
 
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
 namespace phosphor::software::host_power
 {
 
@@ -15,6 +20,12 @@ const auto stateOff =
 using HostState =
     sdbusplus::client::xyz::openbmc_project::state::Host<>::HostState;
 
+// Properties of a PropertiesChanged signal of the host state interface, with
+// the variant of all its property types, so that any property decodes.
+using HostPropertiesChanged = std::map<
+    std::string,
+    sdbusplus::client::xyz::openbmc_project::state::Host<>::PropertiesVariant>;
+
 class HostPower
 {
   public:
@@ -32,4 +43,64 @@ class HostPower
     sdbusplus::async::match stateChangedMatch;
 };
 
+// Keeps the host off while updates need it off. The first update to acquire
+// it powers the host off, the last one to release it restores the state the
+// host was in before. Updates of several flashes of the host, e.g. dual
+// BIOS, can so run in parallel. Updates which arrive while the host is
+// powered off or on for the hold wait until that transition is done.
+// The holding updates claim 'update::hostPowerResource' with the scheduler.
+class HostOffHold
+{
+  public:
+    explicit HostOffHold(sdbusplus::async::context& ctx) : ctx(ctx) {}
+
+    HostOffHold(const HostOffHold&) = delete;
+    HostOffHold& operator=(const HostOffHold&) = delete;
+    HostOffHold(HostOffHold&&) = delete;
+    HostOffHold& operator=(HostOffHold&&) = delete;
+
+    // @returns       true if the host is off, the hold has to be released
+    //                then
+    sdbusplus::async::task<bool> acquire();
+
+    // @brief         Like 'acquire', but does not power the host off.
+    // @returns       true if the host is already off, the hold has to be
+    //                released then
+    sdbusplus::async::task<bool> acquireIfOff();
+
+    // @returns       true if the host state was restored, or other updates
+    //                still hold it off
+    sdbusplus::async::task<bool> release();
+
+    // @returns       true while an update holds the host off, or powers it
+    //                off or on for a hold
+    bool held() const
+    {
+        return holders > 0 || transitioning;
+    }
+
+  private:
+    struct Transition;
+    struct TransitionWaiter;
+
+    // @param powerOff  whether to power the host off if it is on
+    sdbusplus::async::task<bool> hold(bool powerOff);
+
+    // @brief         Wait until no power transition of a hold is running.
+    // @returns       false if the wait failed
+    sdbusplus::async::task<bool> waitForTransition();
+
+    sdbusplus::async::context& ctx;
+
+    size_t holders = 0;
+
+    // the first acquire or the last release changes the host state
+    bool transitioning = false;
+
+    HostState previous = stateOff;
+
+    // eventfds of the coroutines waiting for the transition to finish
+    std::vector<int> waiters;
+};
+
 }; // namespace phosphor::software::host_power
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace phosphor::i2c
+{
+
+/*
+ * @class Frame
+ * @brief Inline, fixed-capacity byte buffer for a single I2C/PMBus frame.
+ * It offers the subset of the std::vector interface the drivers use, so
+ * building a request or receiving a response does not touch the heap.
+ */
+class Frame
+{
+  public:
+    // PMBus block transfers are limited to 255 bytes
+    static constexpr size_t capacity = 255;
+
+    using value_type = uint8_t;
+    using size_type = size_t;
+    using iterator = uint8_t*;
+    using const_iterator = const uint8_t*;
+
+    Frame() = default;
+
+    Frame(size_t count, uint8_t value)
+    {
+        resize(count, value);
+    }
+
+    Frame(std::initializer_list<uint8_t> init)
+    {
+        insert(end(), init.begin(), init.end());
+    }
+
+    uint8_t* data()
+    {
+        return buf.data();
+    }
+
+    const uint8_t* data() const
+    {
+        return buf.data();
+    }
+
+    size_t size() const
+    {
+        return len;
+    }
+
+    bool empty() const
+    {
+        return len == 0;
+    }
+
+    iterator begin()
+    {
+        return buf.data();
+    }
+
+    iterator end()
+    {
+        return buf.data() + len;
+    }
+
+    const_iterator begin() const
+    {
+        return buf.data();
+    }
+
+    const_iterator end() const
+    {
+        return buf.data() + len;
+    }
+
+    uint8_t& operator[](size_t index)
+    {
+        return buf[index];
+    }
+
+    const uint8_t& operator[](size_t index) const
+    {
+        return buf[index];
+    }
+
+    uint8_t& at(size_t index)
+    {
+        if (index >= len)
+        {
+            throw std::out_of_range("i2c frame index out of range");
+        }
+        return buf[index];
+    }
+
+    const uint8_t& at(size_t index) const
+    {
+        if (index >= len)
+        {
+            throw std::out_of_range("i2c frame index out of range");
+        }
+        return buf[index];
+    }
+
+    void clear()
+    {
+        len = 0;
+    }
+
+    void resize(size_t count, uint8_t value = 0)
+    {
+        checkCapacity(count);
+        if (count > len)
+        {
+            std::fill(buf.begin() + len, buf.begin() + count, value);
+        }
+        len = count;
+    }
+
+    void push_back(uint8_t value)
+    {
+        checkCapacity(len + 1);
+        buf[len++] = value;
+    }
+
+    template <typename InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        const size_t index = pos - begin();
+        const size_t count = std::distance(first, last);
+
+        checkCapacity(len + count);
+        std::copy_backward(begin() + index, end(), end() + count);
+        std::copy(first, last, begin() + index);
+        len += count;
+
+        return begin() + index;
+    }
+
+  private:
+    static void checkCapacity(size_t count)
+    {
+        if (count > capacity)
+        {
+            throw std::length_error("i2c frame exceeds its capacity");
+        }
+    }
+
+    std::array<uint8_t, capacity> buf{};
+    size_t len = 0;
+};
+
+} // namespace phosphor::i2c
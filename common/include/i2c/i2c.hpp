@@ -1,5 +1,8 @@
 #pragma once
 
+#include "i2c_backend.hpp"
+#include "i2c_scheduler.hpp"
+
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
@@ -8,7 +11,11 @@
 
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
 
 extern "C"
 {
@@ -20,11 +27,67 @@ extern "C"
 namespace phosphor::i2c
 {
 
+/*
+ * @class I2CBatch
+ * @brief Write and read messages to one device which are submitted together.
+ * Messages are joined by a repeated start, so only batch messages the device
+ * accepts without a stop condition in between. A batch is submitted in a
+ * single ioctl, so it holds at most I2C_RDWR_IOCTL_MAX_MSGS messages.
+ */
+class I2CBatch
+{
+  public:
+    static constexpr size_t maxMessages = I2C_RDWR_IOCTL_MAX_MSGS;
+
+    // @param data    data to write, it is copied into the batch
+    // @returns       index of the queued message, std::nullopt if 'data' is
+    //                longer than a message can be or the batch is full
+    std::optional<size_t> write(std::span<const uint8_t> data);
+
+    // @param size    number of bytes to read
+    // @returns       index of the queued message, std::nullopt if the batch
+    //                is full
+    std::optional<size_t> read(uint16_t size);
+
+    // @returns       true if the message at 'index' has been transferred
+    bool succeeded(size_t index) const;
+
+    // @returns       the bytes received by the read message at 'index'
+    std::span<const uint8_t> readData(size_t index) const;
+
+    size_t size() const
+    {
+        return messages.size();
+    }
+
+    bool empty() const
+    {
+        return messages.empty();
+    }
+
+    void clear();
+
+  private:
+    struct Message
+    {
+        uint16_t flags;
+        uint16_t len;
+        size_t offset;
+        bool done;
+    };
+
+    std::vector<Message> messages;
+    std::vector<uint8_t> storage;
+
+    friend class I2C;
+};
+
 class I2C
 {
   public:
     explicit I2C(uint16_t bus, uint16_t node) :
-        busStr("/dev/i2c-" + std::to_string(bus)), deviceNode(node)
+        busId(bus), busStr("/dev/i2c-" + std::to_string(bus)),
+        deviceNode(node)
     {
         open();
     }
@@ -39,25 +102,67 @@ class I2C
         this->close();
     }
 
+    // @brief         Write and/or read in one transaction, queued behind the
+    //                other transactions of the bus according to 'priority'.
     sdbusplus::async::task<bool> sendReceive(
         uint8_t* writeData, uint8_t writeSize, uint8_t* readData,
-        uint8_t readSize) const;
+        uint8_t readSize, Priority priority = Priority::normal) const;
+
+    // @brief         Blocking variant, queued like the coroutine one.
     bool sendReceive(const std::vector<uint8_t>& writeData,
-                     std::vector<uint8_t>& readData) const;
+                     std::vector<uint8_t>& readData,
+                     Priority priority = Priority::normal) const;
+
+    // @brief         Allocation free variant of the vector overload, e.g. for
+    //                use with 'Frame'. Reads 'readData.size()' bytes.
+    bool sendReceive(std::span<const uint8_t> writeData,
+                     std::span<uint8_t> readData,
+                     Priority priority = Priority::normal) const;
+
+    // @brief         Submit all messages of 'batch' in one I2C_RDWR ioctl.
+    // @returns       true if every message was transferred
+    sdbusplus::async::task<bool> sendBatch(
+        I2CBatch& batch, Priority priority = Priority::normal) const;
+
+    // @brief         Perform a transfer on the calling thread, through the
+    //                installed backend or the kernel driver.
+    bool transfer(struct i2c_msg* msgs, uint32_t nmsgs) const;
 
     bool isOpen() const
     {
-        return (fd != invalidFd);
+        return target != nullptr;
+    }
+
+    // @returns       the target of the transfers, nullptr if not open
+    const std::shared_ptr<Target>& getTarget() const
+    {
+        return target;
+    }
+
+    uint16_t bus() const
+    {
+        return busId;
+    }
+
+    uint16_t address() const
+    {
+        return deviceNode;
     }
 
     void close();
 
   private:
-    static constexpr int invalidFd = -1;
-    int fd = invalidFd;
+    uint16_t busId;
     std::string busStr;
     uint16_t deviceNode;
+    std::shared_ptr<Target> target;
     int open();
+
+    // @returns       true if transfers can be attempted
+    bool canTransfer() const
+    {
+        return target != nullptr;
+    }
 }; // end class I2C
 
 } // namespace phosphor::i2c
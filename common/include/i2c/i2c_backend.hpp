@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+extern "C"
+{
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+}
+
+namespace phosphor::i2c
+{
+
+/*
+ * @class Backend
+ * @brief Replaces the kernel i2c-dev driver as the target of I2C_RDWR style
+ * transfers, e.g. to run drivers against simulated devices. I2C objects pick
+ * up the backend which is installed when they are constructed.
+ */
+class Backend
+{
+  public:
+    virtual ~Backend() = default;
+
+    // @param bus     number of the i2c adapter
+    // @param msgs    messages of the transfer, addressed by 'msgs[i].addr'
+    // @param nmsgs   number of entries in 'msgs'
+    // @returns       true if all messages were acknowledged
+    virtual bool transfer(uint16_t bus, struct i2c_msg* msgs,
+                          uint32_t nmsgs) = 0;
+
+    // @brief         Route I2C objects created afterwards to 'backend'.
+    //                nullptr selects the kernel driver again.
+    static void install(std::shared_ptr<Backend> backend);
+
+    static std::shared_ptr<Backend> installed();
+};
+
+/*
+ * @class Target
+ * @brief Where the transfers of an I2C object go: the backend which was
+ * installed when it was created, or its open i2c-dev file. Queued transfers
+ * share it with the object, so a transfer which is still queued or in flight
+ * when its caller is cancelled does not use a closed or reused descriptor.
+ */
+class Target
+{
+  public:
+    // @param fd      open i2c-dev file, owned by the target, or -1
+    Target(uint16_t bus, int fd, std::shared_ptr<Backend> backend);
+    ~Target();
+
+    Target(const Target&) = delete;
+    Target& operator=(const Target&) = delete;
+    Target(Target&&) = delete;
+    Target& operator=(Target&&) = delete;
+
+    // @returns       true if all messages were acknowledged
+    bool transfer(struct i2c_msg* msgs, uint32_t nmsgs) const;
+
+  private:
+    uint16_t bus;
+    int fd;
+    std::shared_ptr<Backend> backend;
+};
+
+} // namespace phosphor::i2c
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "i2c_backend.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+}
+
+namespace phosphor::i2c
+{
+
+class I2C;
+
+// Order in which queued transactions of one bus are served
+enum class Priority
+{
+    // e.g. identification or version reads which a client is waiting for
+    high,
+    normal,
+    // e.g. firmware programming, which may be delayed by everything else
+    bulk,
+};
+
+struct BusStats
+{
+    // transactions queued or in flight right now
+    size_t queueDepth = 0;
+    size_t maxQueueDepth = 0;
+    uint64_t transactions = 0;
+    // time between queueing a transaction and starting it on the bus
+    std::chrono::microseconds totalWait{0};
+    std::chrono::microseconds maxWait{0};
+    // time spent in the I2C_RDWR ioctl
+    std::chrono::microseconds totalBusy{0};
+};
+
+/*
+ * @class I2CScheduler
+ * @brief Queues the transactions of all devices and managers per i2c adapter
+ * and runs them on one I/O thread per bus. Transactions on the same bus are
+ * serialized, different buses run in parallel. Within a bus, queued
+ * transactions are served by priority, and round robin across devices of the
+ * same priority so one device doing bulk writes cannot starve its neighbours.
+ * A transaction which has waited for longer than 100 ms is served before
+ * those of higher priority, so a busy device polled at high priority cannot
+ * stall a firmware update either.
+ * The awaiting coroutine is resumed on the event loop through an eventfd once
+ * the transfer has completed. Synchronous callers run their transfer right
+ * away when the bus is idle, and otherwise wait on the same eventfd for a
+ * bounded time.
+ */
+class I2CScheduler
+{
+  public:
+    static I2CScheduler& instance();
+
+    ~I2CScheduler();
+
+    I2CScheduler(const I2CScheduler&) = delete;
+    I2CScheduler& operator=(const I2CScheduler&) = delete;
+    I2CScheduler(I2CScheduler&&) = delete;
+    I2CScheduler& operator=(I2CScheduler&&) = delete;
+
+    // @brief         Attach the scheduler to the event loop of the daemon.
+    //                Until this is called, transfers are done inline.
+    // @param ctx     the async context whose event loop awaits completions
+    void attach(sdbusplus::async::context& ctx);
+
+    // @param device  the device to transfer with
+    // @param msgs    messages of the transfer, copied while it is queued
+    // @param nmsgs   number of entries in 'msgs'
+    // @param priority  queueing priority of the transfer
+    // @returns       true if the transfer succeeded
+    sdbusplus::async::task<bool> transfer(const I2C& device,
+                                          struct i2c_msg* msgs, uint32_t nmsgs,
+                                          Priority priority = Priority::normal);
+
+    // @brief         Like 'transfer', for callers which cannot await. If the
+    //                bus is idle, the transfer is done on the calling thread.
+    //                Otherwise it is queued like the others, and fails if it
+    //                has not been started within 'maxBlockingWait'.
+    bool transferBlocking(const I2C& device, struct i2c_msg* msgs,
+                          uint32_t nmsgs, Priority priority = Priority::normal);
+
+    // @returns       queue depth and latency statistics of 'bus'
+    BusStats stats(uint16_t bus);
+
+    static constexpr auto maxBlockingWait = std::chrono::seconds(1);
+
+  private:
+    I2CScheduler() = default;
+
+    static constexpr size_t priorityCount =
+        static_cast<size_t>(Priority::bulk) + 1;
+
+    // number of idle jobs kept for reuse
+    static constexpr size_t maxFreeJobs = 16;
+
+    // Singly linked FIFO of items with a 'next' member, so queueing does not
+    // allocate.
+    template <typename T>
+    struct Fifo
+    {
+        T* head = nullptr;
+        T* tail = nullptr;
+
+        bool empty() const
+        {
+            return head == nullptr;
+        }
+
+        void push(T* item)
+        {
+            item->next = nullptr;
+            if (tail != nullptr)
+            {
+                tail->next = item;
+            }
+            else
+            {
+                head = item;
+            }
+            tail = item;
+        }
+
+        T* pop()
+        {
+            T* item = head;
+            head = item->next;
+            if (head == nullptr)
+            {
+                tail = nullptr;
+            }
+            return item;
+        }
+    };
+
+    // A queued transfer. It holds copies of the messages and their data and
+    // shares the target of the device, so the I/O thread neither touches the
+    // frame of a coroutine which has been cancelled while the job was queued
+    // or in flight, nor a closed file. Jobs and their eventfd are reused.
+    struct Job
+    {
+        enum class State
+        {
+            queued,
+            running,
+            done,
+        };
+
+        Job();
+        ~Job();
+
+        Job(const Job&) = delete;
+        Job& operator=(const Job&) = delete;
+        Job(Job&&) = delete;
+        Job& operator=(Job&&) = delete;
+
+        // @brief     Copy 'msgs' and the data they write for 'device'
+        void assign(const I2C& device, const struct i2c_msg* msgs,
+                    uint32_t nmsgs);
+
+        // @brief     Copy the data of the read messages back to 'msgs', the
+        //            messages the job was assigned from.
+        void copyReadData(struct i2c_msg* msgs) const;
+
+        std::shared_ptr<Target> target;
+        uint16_t bus = 0;
+        uint16_t address = 0;
+        std::vector<uint8_t> data;
+        std::vector<struct i2c_msg> msgs;
+        std::chrono::steady_clock::time_point queued;
+        // guarded by the mutex of the scheduler
+        State state = State::done;
+        bool result = false;
+        // set when the caller went away, the I/O thread recycles the job
+        bool abandoned = false;
+        int eventFd;
+        Job* next = nullptr;
+    };
+
+    // Returns a job to the scheduler when the caller is done with it
+    struct JobRelease
+    {
+        I2CScheduler* scheduler;
+
+        void operator()(Job* job) const
+        {
+            scheduler->release(job);
+        }
+    };
+
+    using JobLease = std::unique_ptr<Job, JobRelease>;
+
+    // pending jobs of one device address at one priority
+    struct DeviceQueue
+    {
+        Fifo<Job> jobs;
+        DeviceQueue* next = nullptr;
+    };
+
+    struct Bus
+    {
+        // pending jobs per priority and device address. Entries are kept
+        // when they run empty, so queueing a job does not allocate.
+        std::array<std::map<uint16_t, DeviceQueue>, priorityCount> pending;
+        // devices with pending jobs, in round robin order
+        std::array<Fifo<DeviceQueue>, priorityCount> ready;
+        // a transfer is on the bus
+        bool busy = false;
+        std::condition_variable cv;
+        BusStats stats;
+        std::thread thread;
+    };
+
+    // @returns       an idle job holding a copy of 'msgs' for 'device', or
+    //                nullptr if no eventfd could be created
+    JobLease acquire(const I2C& device, const struct i2c_msg* msgs,
+                     uint32_t nmsgs);
+
+    // @brief         Recycle 'job' once the I/O thread is done with it
+    void release(Job* job);
+
+    // @brief         Put 'job' on the free list, must hold 'mutex'
+    void recycle(Job* job);
+
+    // @returns       the bus 'busId', started if needed, must hold 'mutex'
+    Bus& getBus(uint16_t busId);
+
+    // @brief         Queue 'job' on the bus of its device.
+    void enqueue(Job& job, Priority priority);
+
+    // @returns       the next job of 'bus' or nullptr, must hold 'mutex'
+    static Job* dequeue(Bus& bus);
+
+    void run(Bus& bus);
+
+    std::atomic<sdbusplus::async::context*> ctx = nullptr;
+
+    std::mutex mutex;
+    std::map<uint16_t, std::unique_ptr<Bus>> buses;
+    std::vector<std::unique_ptr<Job>> freeJobs;
+    bool stopping = false;
+};
+
+} // namespace phosphor::i2c
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "i2c_backend.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace phosphor::i2c
+{
+
+/*
+ * @class DeviceModel
+ * @brief In-process model of an i2c device for the simulator backend.
+ */
+class DeviceModel
+{
+  public:
+    virtual ~DeviceModel() = default;
+
+    // @param data    the bytes written by the controller
+    // @returns       false to NACK the message
+    virtual bool write(std::span<const uint8_t> data) = 0;
+
+    // @param data    buffer to fill with the response
+    // @returns       false to NACK the message
+    virtual bool read(std::span<uint8_t> data) = 0;
+};
+
+/*
+ * @class ScriptedDevice
+ * @brief Command oriented (SMBus/PMBus style) device model. The first byte of
+ * a write selects the command, and a following read returns the response
+ * scripted for that command. Responses may be fixed or computed by a handler,
+ * which can keep whatever state the model needs.
+ */
+class ScriptedDevice : public DeviceModel
+{
+  public:
+    using WriteHandler = std::function<bool(std::span<const uint8_t> payload)>;
+    using ReadHandler = std::function<std::vector<uint8_t>()>;
+
+    // @brief         Answer reads after 'command' with 'response'
+    void respond(uint8_t command, std::vector<uint8_t> response);
+
+    // @brief         Compute the response to reads after 'command'
+    void onRead(uint8_t command, ReadHandler handler);
+
+    // @brief         Called with the bytes following 'command' on writes
+    void onWrite(uint8_t command, WriteHandler handler);
+
+    // @returns       number of writes of 'command' seen so far
+    size_t writeCount(uint8_t command) const;
+
+    bool write(std::span<const uint8_t> data) override;
+    bool read(std::span<uint8_t> data) override;
+
+  private:
+    uint8_t command = 0;
+    std::map<uint8_t, ReadHandler> readHandlers;
+    std::map<uint8_t, WriteHandler> writeHandlers;
+    std::map<uint8_t, size_t> writes;
+};
+
+/*
+ * @class Simulator
+ * @brief Backend which routes transfers to device models, addressed by bus
+ * and address. Each transfer blocks for the configured latency to mimic the
+ * time it takes on a real bus. Messages to addresses without a model are
+ * NACKed.
+ */
+class Simulator : public Backend
+{
+  public:
+    void addDevice(uint16_t bus, uint16_t address,
+                   std::shared_ptr<DeviceModel> device);
+
+    // @param perTransfer  fixed cost of every transfer, e.g. start and stop
+    // @param perByte      cost of each transferred byte, e.g. 9 clocks
+    void setLatency(std::chrono::microseconds perTransfer,
+                    std::chrono::microseconds perByte);
+
+    bool transfer(uint16_t bus, struct i2c_msg* msgs, uint32_t nmsgs) override;
+
+    // @returns       number of transfers handled so far
+    uint64_t transfers() const;
+
+  private:
+    mutable std::mutex mutex;
+    std::map<std::pair<uint16_t, uint16_t>, std::shared_ptr<DeviceModel>>
+        devices;
+    std::chrono::microseconds transferLatency{0};
+    std::chrono::microseconds byteLatency{0};
+    uint64_t transferCount = 0;
+};
+
+} // namespace phosphor::i2c
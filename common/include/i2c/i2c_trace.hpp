@@ -0,0 +1,96 @@
+#pragma once
+
+#include <sdbusplus/async.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+extern "C"
+{
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+}
+
+namespace phosphor::i2c
+{
+
+struct DeviceTrace
+{
+    // Upper bound of the first latency bucket, each further bucket doubles
+    // it. The last bucket collects everything above.
+    static constexpr std::chrono::microseconds firstBucket{32};
+    static constexpr size_t bucketCount = 16;
+
+    uint64_t transactions = 0;
+    uint64_t errors = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t bytesRead = 0;
+    std::chrono::microseconds totalLatency{0};
+    std::chrono::microseconds maxLatency{0};
+    std::array<uint64_t, bucketCount> latency{};
+
+    // @returns       index of the latency bucket for 'value'
+    static size_t bucket(std::chrono::microseconds value);
+};
+
+/*
+ * @class I2CTrace
+ * @brief Optional per device statistics of i2c transactions: counts, bytes,
+ * errors and a latency histogram. Recording is a no-op until enabled. When
+ * enabled, the statistics are written to a dump file whenever they changed.
+ */
+class I2CTrace
+{
+  public:
+    // (bus, address)
+    using DeviceKey = std::pair<uint16_t, uint16_t>;
+
+    static I2CTrace& instance();
+
+    // @brief         Start recording and periodically dump to 'path'
+    // @param ctx     context to run the dump task on
+    // @param path    the dump file, replaced atomically
+    void enable(sdbusplus::async::context& ctx, const std::string& path);
+
+    // @brief         Start recording without dumping to a file
+    void enable();
+
+    bool enabled() const
+    {
+        return isEnabled;
+    }
+
+    // @param start   when the transaction was issued, including queueing
+    void record(uint16_t bus, uint16_t address, const struct i2c_msg* msgs,
+                uint32_t nmsgs, bool success,
+                std::chrono::steady_clock::time_point start);
+
+    std::map<DeviceKey, DeviceTrace> snapshot();
+
+    // @returns       human readable statistics of all devices and buses
+    std::string dump();
+
+    // @returns       true if the dump was written to 'path'
+    bool dumpToFile(const std::string& path);
+
+  private:
+    I2CTrace() = default;
+
+    sdbusplus::async::task<> dumpPeriodically(sdbusplus::async::context& ctx,
+                                              std::string path);
+
+    std::atomic<bool> isEnabled = false;
+
+    std::mutex mutex;
+    std::map<DeviceKey, DeviceTrace> devices;
+    // bumped on every record, to skip dumping unchanged statistics
+    uint64_t generation = 0;
+};
+
+} // namespace phosphor::i2c
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <sdbusplus/async.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace phosphor::software::mtd
+{
+
+struct FlashInfo
+{
+    // size of the flash in bytes
+    size_t size = 0;
+
+    // size of an erase block in bytes
+    size_t eraseSize = 0;
+};
+
+enum class WriteMode
+{
+    // erase and program every block of the image
+    full,
+    // read each block first, erase and program only the blocks which differ
+    incremental,
+};
+
+/*
+ * @class MTDFlash
+ * @brief Erases, programs and verifies an MTD device in process, with
+ * MEMGETINFO / MEMERASE and pwrite / pread on the mtd character device.
+ * The image is programmed straight from the caller's buffer, one erase block
+ * at a time, on a worker thread of the 'WorkerPool'. A second worker thread
+ * reads back each block as soon as it has been programmed, so verification
+ * runs while the following blocks are programmed. Flashes on different
+ * lanes, e.g. SPI controllers, are programmed in parallel. The awaiting
+ * coroutine is resumed on the event loop through an eventfd after each
+ * block, to report progress.
+ * In incremental mode, blocks which already hold their part of the image are
+ * neither erased nor programmed, which saves most of the time and wear of an
+ * update which only changes a few blocks.
+ * The image does not have to be aligned to erase blocks. The bytes of a block
+ * which lie outside of the image are read before the erase and written back,
+ * so e.g. a 4 KiB flash region can be updated on a flash with 64 KiB blocks.
+ */
+class MTDFlash
+{
+  public:
+    // @param done     bytes of the image which are programmed and verified
+    // @param total    bytes of the image
+    using Progress = std::function<void(size_t done, size_t total)>;
+
+    // @param path     e.g. /dev/mtd6
+    // @param lane     worker pool lane, e.g. the controller of the flash,
+    //                 'path' if empty
+    // @returns        nullptr if the device cannot be opened or queried
+    static std::unique_ptr<MTDFlash> open(const std::string& path,
+                                          const std::string& lane = "");
+
+    // @brief          Use a regular file like an MTD device, erasing sets
+    //                 all bytes of a block to 0xff. For tests and simulation.
+    // @param path     the file, its size is the size of the flash and a
+    //                 multiple of 'eraseSize'
+    // @param eraseSize  size of an emulated erase block
+    // @returns        nullptr if the file cannot be opened
+    static std::unique_ptr<MTDFlash> openFile(const std::string& path,
+                                              size_t eraseSize);
+
+    ~MTDFlash();
+
+    MTDFlash(const MTDFlash&) = delete;
+    MTDFlash& operator=(const MTDFlash&) = delete;
+    MTDFlash(MTDFlash&&) = delete;
+    MTDFlash& operator=(MTDFlash&&) = delete;
+
+    const FlashInfo& getInfo() const
+    {
+        return flashInfo;
+    }
+
+    // @param data     filled with the content of the flash at 'offset'
+    // @returns        true on success
+    bool read(std::span<uint8_t> data, size_t offset) const;
+
+    // @param ctx      the async context whose event loop awaits the workers
+    // @param image    the image, must outlive the call
+    // @param offset   offset on the flash
+    // @param progress called on the event loop after each block, may be empty
+    // @param mode     whether to skip the blocks which did not change
+    // @returns        true if the image is programmed and verified
+    sdbusplus::async::task<bool> write(
+        sdbusplus::async::context& ctx, std::span<const uint8_t> image,
+        size_t offset, Progress progress, WriteMode mode = WriteMode::full);
+
+  private:
+    MTDFlash(int fd, std::string path, FlashInfo info, bool emulated,
+             std::string lane);
+
+    struct Job;
+
+    // @brief          Erase and program the blocks of 'job', runs on the
+    //                 programming thread.
+    void program(Job& job) const;
+
+    // @brief          Read back the blocks of 'job' which are programmed,
+    //                 runs on the verification thread.
+    void verify(Job& job) const;
+
+    // @brief          Read a block which the image covers only partially and
+    //                 merge the image into it, in 'job.merged'.
+    // @param unchanged  set if the block already holds its part of the image
+    //                 and 'job' is incremental
+    // @returns        true on success
+    bool merge(Job& job, size_t block, bool& unchanged) const;
+
+    // @param data     the part of the image which goes to 'offset'
+    // @param buffer   scratch space for reading back
+    // @returns        true if the flash already holds 'data' at 'offset'
+    bool isProgrammed(std::span<const uint8_t> data, size_t offset,
+                      std::vector<uint8_t>& buffer) const;
+
+    // @param offset   offset on the flash, aligned to an erase block
+    // @returns        true on success
+    bool erase(size_t offset) const;
+
+    // @returns        true if all of 'data' was written at 'offset'
+    bool pwriteAll(std::span<const uint8_t> data, size_t offset) const;
+
+    // @returns        true if all of 'data' was read from 'offset'
+    bool preadAll(std::span<uint8_t> data, size_t offset) const;
+
+    int fd;
+    std::string path;
+    FlashInfo flashInfo;
+    bool emulated;
+    std::string lane;
+};
+
+} // namespace phosphor::software::mtd
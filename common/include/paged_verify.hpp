@@ -0,0 +1,141 @@
+#pragma once
+
+#include <sdbusplus/async/task.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace phosphor::software::paged
+{
+
+// Outcome of 'PagedVerifier::verify', for logging
+struct VerifyReport
+{
+    // pages of the image
+    size_t pages = 0;
+
+    // pages which did not match on the first read back
+    std::vector<size_t> mismatched;
+
+    // pages which were programmed again without erasing them
+    size_t reprogrammedPages = 0;
+
+    // sectors which were erased and programmed again
+    size_t rewrittenSectors = 0;
+
+    // passes of read back and repair
+    size_t passes = 0;
+
+    std::chrono::microseconds readTime{0};
+    std::chrono::microseconds repairTime{0};
+};
+
+// What programming does to the bits of a page, which the driver knows from
+// its flash technology. It decides whether a mismatching page can be
+// programmed again without erasing it.
+enum class ProgramBits
+{
+    // not known, a mismatching page is always erased first
+    unknown,
+    // programming clears bits and erasing sets them, e.g. NOR flash
+    clear,
+    // programming sets bits and erasing clears them
+    set,
+};
+
+// Verifies an image programmed into a paged flash device by reading it back,
+// and repairs the pages which do not match.
+// Pages are read back several at a time and compared byte by byte with the
+// image. A mismatching page is programmed again in place if flash
+// programming can turn its content into the expected one, according to the
+// 'ProgramBits' of the driver. Otherwise its sector is erased and all image
+// pages of the sector are programmed again. Repaired pages are read back
+// again, until all match or 'maxPasses' is reached.
+class PagedVerifier
+{
+  public:
+    // @param first    first page to read
+    // @param count    number of pages to read, at most 'pagesPerRead'
+    // @param data     'count' * 'pageSize' bytes read back
+    using ReadPages = std::function<sdbusplus::async::task<bool>(
+        size_t first, size_t count, std::vector<uint8_t>& data)>;
+
+    // @param page     page to program
+    // @param data     content of the page, may be shorter than a page
+    using ProgramPage = std::function<sdbusplus::async::task<bool>(
+        size_t page, std::span<const uint8_t> data)>;
+
+    // @param sector   sector to erase
+    using EraseSector =
+        std::function<sdbusplus::async::task<bool>(size_t sector)>;
+
+    // @param image            the programmed image, page 0 is at its start
+    // @param pageSize         size of a page in bytes
+    // @param pagesPerRead     pages read back with one 'ReadPages' call
+    // @param pagesPerSector   pages erased together, 0 if the device cannot
+    //                         erase part of the image
+    PagedVerifier(std::span<const uint8_t> image, size_t pageSize,
+                  size_t pagesPerRead, size_t pagesPerSector);
+
+    // @brief          Reprogram mismatching pages with 'program'.
+    //                 Without it, a mismatch fails the verification.
+    // @param bits     what programming does to the bits of a page
+    void setProgramPage(ProgramPage program, ProgramBits bits);
+
+    // @brief          Erase the sectors of mismatching pages, which cannot
+    //                 be reprogrammed in place, with 'erase'.
+    void setEraseSector(EraseSector erase);
+
+    // @param read         reads pages back from the device
+    // @param maxPasses    passes of read back and repair
+    // @param report       filled with what was found and repaired
+    // @returns            true if all pages match in the end
+    sdbusplus::async::task<bool> verify(ReadPages read, size_t maxPasses,
+                                        VerifyReport& report);
+
+    size_t pageCount() const
+    {
+        return imagePages;
+    }
+
+    // @returns        true if programming turns 'current' into 'expected'
+    //                 without erasing it, i.e. only bits have to change
+    //                 which 'bits' can change
+    static bool canProgramOver(std::span<const uint8_t> current,
+                               std::span<const uint8_t> expected,
+                               ProgramBits bits);
+
+  private:
+    // @returns        the content of 'page' in the image
+    std::span<const uint8_t> imagePage(size_t page) const;
+
+    // @brief          Read back 'pages' and collect the mismatching ones
+    //                 with their content.
+    sdbusplus::async::task<bool> readBack(
+        ReadPages& read, const std::vector<size_t>& pages,
+        std::vector<std::pair<size_t, std::vector<uint8_t>>>& mismatched);
+
+    // @brief          Program or rewrite the mismatching pages.
+    // @param touched  pages which have to be read back again
+    sdbusplus::async::task<bool> repair(
+        const std::vector<std::pair<size_t, std::vector<uint8_t>>>&
+            mismatched,
+        std::vector<size_t>& touched, VerifyReport& report);
+
+    std::span<const uint8_t> image;
+    size_t pageSize;
+    size_t pagesPerRead;
+    size_t pagesPerSector;
+    size_t imagePages;
+
+    ProgramPage programPage;
+    ProgramBits programBits = ProgramBits::unknown;
+    EraseSector eraseSector;
+};
+
+} // namespace phosphor::software::paged
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+namespace phosphor::software
+{
+
+// Coalesces the progress reported by a driver before it is published.
+// Only increasing values are published, at most once per 'minInterval'.
+// 100 is always published right away and 'flush' publishes a value which
+// was held back, so the final progress of an update is never lost. A value
+// held back is also published once the interval is over, through the
+// 'scheduleFlush' callback of the owner, even if no further value follows.
+class ProgressPublisher
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // @param publish      called with each progress value to publish
+    // @param minInterval  minimum time between two published values
+    // @param scheduleFlush  optional, called when a value is held back, with
+    //                     the time after which the owner should call 'flush'
+    ProgressPublisher(
+        std::function<void(uint8_t)> publish,
+        std::chrono::milliseconds minInterval,
+        std::function<void(std::chrono::milliseconds)> scheduleFlush = nullptr);
+
+    // @param progress     progress in percent
+    // @returns            true if the value was published right away
+    bool update(uint8_t progress);
+
+    // @brief              Record the bytes transferred so far, used to
+    //                     estimate the remaining time.
+    void updateBytes(uint64_t done, uint64_t total);
+
+    // @brief              Publish the value held back by the rate limit,
+    //                     if any.
+    void flush();
+
+    // @returns            the last published progress
+    uint8_t progress() const
+    {
+        return published.value_or(0);
+    }
+
+    uint64_t bytesDone() const
+    {
+        return bytesDoneCount;
+    }
+
+    uint64_t bytesTotal() const
+    {
+        return bytesTotalCount;
+    }
+
+    // @returns            the estimated time until all bytes are done,
+    //                     based on the throughput observed so far
+    std::optional<std::chrono::seconds> eta() const;
+
+  private:
+    void publishNow(uint8_t progress, Clock::time_point now);
+
+    std::function<void(uint8_t)> publish;
+    std::chrono::milliseconds minInterval;
+    std::function<void(std::chrono::milliseconds)> scheduleFlush;
+
+    std::optional<uint8_t> published;
+    std::optional<uint8_t> pending;
+    bool flushScheduled = false;
+    Clock::time_point lastPublished;
+
+    uint64_t bytesDoneCount = 0;
+    uint64_t bytesTotalCount = 0;
+    uint64_t bytesAtStart = 0;
+    std::optional<Clock::time_point> bytesStart;
+    Clock::time_point bytesLast;
+};
+
+} // namespace phosphor::software
@@ -10,6 +10,7 @@
 #include <xyz/openbmc_project/Software/Version/aserver.hpp>
 #include <xyz/openbmc_project/Software/Version/client.hpp>
 
+#include <cstdint>
 #include <string>
 
 namespace phosphor::software::device
@@ -17,6 +18,11 @@ namespace phosphor::software::device
 class Device;
 }
 
+namespace phosphor::software::manager
+{
+class SoftwareManager;
+}
+
 namespace phosphor::software
 {
 
@@ -37,6 +43,14 @@ class Software : private SoftwareActivation
   public:
     Software(sdbusplus::async::context& ctx, device::Device& parent);
 
+    // releases the software id
+    ~Software();
+
+    Software(const Software&) = delete;
+    Software& operator=(const Software&) = delete;
+    Software(Software&&) = delete;
+    Software& operator=(Software&&) = delete;
+
     // Set the activation status of this software
     // @param activation         The activation status
     void setActivation(SoftwareActivation::Activations activation);
@@ -79,7 +93,9 @@ class Software : private SoftwareActivation
                         ActivationProgress<Software>>
         softwareActivationProgress = nullptr;
 
-    static long int getRandomId();
+    // @returns        an id which is unique within the process,
+    //                 see 'SoftwareIdAllocator'
+    static uint64_t getRandomId();
 
   protected:
     // object path of this software
@@ -89,7 +105,8 @@ class Software : private SoftwareActivation
     // @returns std::nullopt in case the version has not been set
     std::optional<SoftwareVersion::VersionPurpose> getPurpose();
 
-    // @returns        a random software id (swid) for that device
+    // @returns        a unique software id (swid) for that device, which is
+    //                 in use until the software is destroyed
     static std::string getRandomSoftwareId(device::Device& parent);
 
     // @param isRunning             if the software version is currently running
@@ -128,6 +145,7 @@ class Software : private SoftwareActivation
 
     friend update::SoftwareUpdate;
     friend device::Device;
+    friend manager::SoftwareManager;
 };
 
 }; // namespace phosphor::software
@@ -10,6 +10,11 @@ namespace phosphor::software::device
 class Device;
 }
 
+namespace phosphor::software::manager
+{
+class SoftwareManager;
+}
+
 using namespace phosphor::software::device;
 
 namespace phosphor::software::config
@@ -53,6 +58,7 @@ class SoftwareConfig
                             // "com.meta.Hardware.Yosemite4.MedusaBoard.CPLD.LCMX02_2000HC"
 
     friend Device;
+    friend phosphor::software::manager::SoftwareManager;
 };
 
 }; // namespace phosphor::software::config
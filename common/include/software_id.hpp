@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+
+namespace phosphor::software
+{
+
+// Allocates the ids of software object paths and temporary files.
+// An id is a process-wide counter followed by a random suffix, from a PRNG
+// which is seeded once. The counter makes ids unique within the process,
+// the suffix makes ids of different processes unlikely to collide.
+// Software ids are tracked while in use, so an id which is still on dbus is
+// never handed out again.
+class SoftwareIdAllocator
+{
+  public:
+    static SoftwareIdAllocator& instance();
+
+    SoftwareIdAllocator(const SoftwareIdAllocator&) = delete;
+    SoftwareIdAllocator& operator=(const SoftwareIdAllocator&) = delete;
+
+    // @returns        a new id, which this process never returned before
+    uint64_t next();
+
+    // @param prefix   prefix of the software id, e.g. the config name
+    // @returns        a software id '<prefix>_<id>', which is in use until
+    //                 it is released
+    std::string acquire(const std::string& prefix);
+
+    // @brief          Mark a software id as no longer in use.
+    void release(const std::string& swid);
+
+    // @returns        true if the software id is in use
+    bool inUse(const std::string& swid) const;
+
+  private:
+    SoftwareIdAllocator();
+
+    mutable std::mutex mutex;
+
+    uint64_t counter = 0;
+
+    std::mt19937_64 prng;
+
+    std::set<std::string> live;
+};
+
+} // namespace phosphor::software
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "device.hpp"
+#include "host_power.hpp"
+#include "software_update.hpp"
+#include "update_scheduler.hpp"
 #include "sdbusplus/async/match.hpp"
 
 #include <boost/asio/steady_timer.hpp>
@@ -10,8 +13,12 @@
 #include <sdbusplus/async/context.hpp>
 #include <sdbusplus/timer.hpp>
 
+#include <functional>
+#include <memory>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace phosphor::software::config;
 using namespace phosphor::software::device;
@@ -29,6 +36,11 @@ class SoftwareManager
 
     // Fetches initial configuration from dbus and initializes devices.
     // This should be called once by a code updater at startup.
+    // The configuration interfaces are fetched concurrently into the
+    // 'ConfigCache'. Devices are initialized concurrently, except for devices
+    // on the same bus, which are initialized one after the other. The task
+    // completes once all devices have been initialized, so callers and tests
+    // can await it.
     // @param configurationInterfaces    the dbus interfaces from which to fetch
     // configuration
     sdbusplus::async::task<> initDevices(
@@ -37,6 +49,34 @@ class SoftwareManager
     // Map of EM config object path to device.
     std::map<sdbusplus::object_path, std::unique_ptr<Device>> devices;
 
+    // @brief                Update every device the package has a component
+    //                       for. Devices are updated concurrently, except for
+    //                       devices sharing a resource (see
+    //                       'Device::getUpdateResources'), which are updated
+    //                       one after the other.
+    // @param image          The memory fd with the pldm package
+    // @param applyTime      When the update should be applied
+    // @param onProgress     optional, called with the progress averaged over
+    //                       all devices being updated
+    // @param onDone         optional, called once all devices are done, with
+    //                       true if every update succeeded
+    // @returns              object paths of the new software versions, one
+    //                       per device being updated
+    std::vector<sdbusplus::object_path> startUpdateAll(
+        sdbusplus::message::unix_fd image, RequestedApplyTimes applyTime,
+        std::function<void(uint8_t)> onProgress = nullptr,
+        std::function<void(bool)> onDone = nullptr);
+
+    // @returns              the apply times at least one device allows
+    std::set<RequestedApplyTimes> getAllowedApplyTimes() const;
+
+    // Runs the updates of all devices, as far as the resources they need
+    // allow, and queues the others.
+    update::UpdateScheduler updateScheduler;
+
+    // Keeps the host off while the updates of any device need it off.
+    host_power::HostOffHold hostOffHold;
+
   protected:
     // This function receives a dbus name and object path for a single device,
     // which was configured.
@@ -57,6 +97,32 @@ class SoftwareManager
     sdbusplus::async::context& ctx;
 
   private:
+    struct InitEntry;
+    struct InitBatch;
+
+    // Calls the function of 'batch' for its next index until none is left.
+    static sdbusplus::async::task<> initWorker(
+        std::shared_ptr<InitBatch> batch);
+
+    // @brief   Calls 'fn' with each index below 'count', for at most
+    //          'maxConcurrentInits' indexes at a time.
+    // @returns once all calls have completed
+    sdbusplus::async::task<> forEachConcurrently(
+        size_t count, std::function<sdbusplus::async::task<>(size_t)> fn);
+
+    struct UpdateAll;
+
+    // Updates one device as part of 'startUpdateAll'.
+    sdbusplus::async::task<> updateOne(std::shared_ptr<UpdateAll> state,
+                                       Device* device,
+                                       std::unique_ptr<Software> software);
+
+    // Applies the staged updates of all devices whenever the host has
+    // powered off, see 'staged-updates'.
+    sdbusplus::async::task<> applyStagedUpdatesOnHostOff();
+
+    sdbusplus::async::task<> applyStagedUpdate(Device* device);
+
     sdbusplus::async::task<void> handleInterfaceAdded(
         const std::string& service, const sdbusplus::object_path& path,
         const std::string& interface);
@@ -82,6 +148,10 @@ class SoftwareManager
 
     sdbusplus::server::manager_t manager;
 
+    // Update interface for all devices of this updater, on
+    // /xyz/openbmc_project/software/<serviceNameSuffix>
+    std::unique_ptr<update::ManagerUpdate> updateAllIntf;
+
     friend Software;
     friend Device;
 
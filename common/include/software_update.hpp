@@ -1,12 +1,25 @@
 #pragma once
 
 #include <sdbusplus/async/context.hpp>
+#include <xyz/openbmc_project/Software/Activation/aserver.hpp>
+#include <xyz/openbmc_project/Software/ActivationProgress/aserver.hpp>
 #include <xyz/openbmc_project/Software/Update/aserver.hpp>
 
+#include <cstdint>
+#include <memory>
+
 namespace phosphor::software
 {
 class Software;
-};
+namespace device
+{
+class Device;
+}
+namespace manager
+{
+class SoftwareManager;
+}
+}; // namespace phosphor::software
 
 using RequestedApplyTimes = sdbusplus::common::xyz::openbmc_project::software::
     ApplyTime::RequestedApplyTimes;
@@ -35,9 +48,69 @@ class SoftwareUpdate :
     auto get_property(allowed_apply_times_t aat) const;
 
   private:
+    // @brief     Runs the update once the scheduler admits it.
+    static sdbusplus::async::task<> runUpdate(
+        device::Device& device, int imageDup, RequestedApplyTimes applyTime,
+        std::unique_ptr<Software> swupdate);
+
     Software& software;
 
     const std::set<RequestedApplyTimes> allowedApplyTimes;
 };
 
+// The Update interface on the object of a code updater. Updates every device
+// the package has a component for, see 'SoftwareManager::startUpdateAll',
+// and publishes the progress averaged over these devices with the
+// ActivationProgress interface of the same object. Its Activation interface
+// is Activating until all devices are done, then Active, or Failed if the
+// update of any device failed.
+class ManagerUpdate :
+    public sdbusplus::aserver::xyz::openbmc_project::software::Update<
+        ManagerUpdate>
+{
+  public:
+    ManagerUpdate(const ManagerUpdate&) = delete;
+    ManagerUpdate(ManagerUpdate&&) = delete;
+    ManagerUpdate& operator=(const ManagerUpdate&) = delete;
+    ManagerUpdate& operator=(ManagerUpdate&&) = delete;
+    ManagerUpdate(sdbusplus::async::context& ctx,
+                  const sdbusplus::object_path& path,
+                  manager::SoftwareManager& manager);
+
+    ~ManagerUpdate();
+
+    // @returns   the path of this object, which carries the progress and
+    //            the activation of the update
+    auto method_call(start_update_t su, auto image, auto applyTime)
+        -> sdbusplus::async::task<start_update_t::return_type>;
+
+    auto get_property(allowed_apply_times_t aat) const;
+
+  private:
+    // @brief     Publish the averaged progress
+    void setProgress(uint8_t progress);
+
+    // @brief     Publish the result once the updates of all devices are done
+    // @param success  true if every device was updated
+    void setDone(bool success);
+
+    sdbusplus::async::context& ctx;
+
+    const sdbusplus::object_path path;
+
+    manager::SoftwareManager& manager;
+
+    // present from the first update on, shows the progress of the last one
+    std::unique_ptr<sdbusplus::aserver::xyz::openbmc_project::software::
+                        ActivationProgress<ManagerUpdate>>
+        activationProgress = nullptr;
+
+    // present from the first update on, shows the state of the last one
+    std::unique_ptr<sdbusplus::aserver::xyz::openbmc_project::software::
+                        Activation<ManagerUpdate>>
+        activation = nullptr;
+
+    bool updateInProgress = false;
+};
+
 }; // namespace phosphor::software::update
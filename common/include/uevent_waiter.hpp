@@ -0,0 +1,57 @@
+#pragma once
+
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <functional>
+
+namespace phosphor::software
+{
+
+/*
+ * @class UeventWaiter
+ * @brief Waits for a condition on sysfs, e.g. a driver bind or unbind, to
+ * become true. The condition is checked again on each kernel uevent, from a
+ * NETLINK_KOBJECT_UEVENT socket, so the waiting coroutine resumes as soon as
+ * the kernel is done rather than after a fixed delay.
+ * Create the waiter before triggering the change, so none of its uevents are
+ * missed. If the socket cannot be opened, the condition is polled instead.
+ */
+class UeventWaiter
+{
+  public:
+    // @param uevents     false to poll the condition instead, e.g. for a
+    //                    condition that no uevent signals
+    explicit UeventWaiter(sdbusplus::async::context& ctx, bool uevents = true);
+    ~UeventWaiter();
+
+    UeventWaiter(const UeventWaiter&) = delete;
+    UeventWaiter& operator=(const UeventWaiter&) = delete;
+    UeventWaiter(UeventWaiter&&) = delete;
+    UeventWaiter& operator=(UeventWaiter&&) = delete;
+
+    // @param condition   checked now and after each uevent
+    // @param timeout     time after which we give up
+    // @returns           true if 'condition' became true within 'timeout'
+    sdbusplus::async::task<bool> waitFor(std::function<bool()> condition,
+                                         std::chrono::milliseconds timeout);
+
+  private:
+    // @brief             Discard the pending uevents and timer expirations.
+    void drain() const;
+
+    // @brief             Check 'condition' periodically, if we cannot wait
+    //                    for uevents.
+    sdbusplus::async::task<bool> poll(
+        std::function<bool()>& condition,
+        std::chrono::steady_clock::time_point deadline);
+
+    sdbusplus::async::context& ctx;
+
+    int ueventFd = -1;
+    int timerFd = -1;
+    // readable when 'ueventFd' or 'timerFd' is
+    int epollFd = -1;
+};
+
+} // namespace phosphor::software
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <sdbusplus/async/context.hpp>
+#include <sdbusplus/async/task.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+
+namespace phosphor::software::update
+{
+
+// Resource of the host power state. Updates which need the host off claim it
+// shared, and keep the host off with 'host_power::HostOffHold'. Staged updates
+// claim it exclusively, so they are not applied while another update holds
+// the host off.
+inline constexpr auto hostPowerResource = "host-power";
+
+// @returns    the resource name of a mux GPIO line
+std::string gpioResource(const std::string& line);
+
+// Runs device updates concurrently, as far as the resources they need allow.
+// Each update names the resources it needs exclusively, like the bus of the
+// device or its mux GPIO lines, and those it can share with other updates,
+// like the host power state. Updates are started in
+// the order they were submitted. An update which has to wait also holds back
+// later updates which need one of its resources, so it is not starved.
+class UpdateScheduler
+{
+  public:
+    using job_t = std::move_only_function<sdbusplus::async::task<>()>;
+
+    explicit UpdateScheduler(sdbusplus::async::context& ctx) : ctx(ctx) {}
+
+    UpdateScheduler(const UpdateScheduler&) = delete;
+    UpdateScheduler& operator=(const UpdateScheduler&) = delete;
+
+    // @param name         name of the update for logging
+    // @param resources    resources the update needs exclusively
+    // @param job          the update
+    // @param shared       resources the update can share with other updates
+    //                     which claim them shared
+    // @returns            true if the update was started right away, false
+    //                     if it was queued
+    bool submit(const std::string& name, std::set<std::string> resources,
+                job_t job, std::set<std::string> shared = {});
+
+    size_t running() const
+    {
+        return active;
+    }
+
+    size_t queued() const
+    {
+        return pending.size();
+    }
+
+  private:
+    struct Job
+    {
+        uint64_t id;
+        std::string name;
+        std::set<std::string> resources;
+        std::set<std::string> shared;
+        job_t job;
+    };
+
+    // @brief      Start the queued jobs whose resources are free.
+    void schedule();
+
+    sdbusplus::async::task<> run(Job job);
+
+    sdbusplus::async::context& ctx;
+
+    std::deque<Job> pending;
+
+    // resources held exclusively by the running jobs
+    std::set<std::string> busy;
+
+    // resources held shared by the running jobs, with the number of holders
+    std::map<std::string, size_t> sharedBusy;
+
+    size_t active = 0;
+
+    uint64_t nextId = 0;
+};
+
+} // namespace phosphor::software::update
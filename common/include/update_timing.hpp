@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace phosphor::software::timing
+{
+
+// Stage timings of a single update.
+// The common update flow marks its stages with 'begin'. Drivers mark their
+// own sub-stages with 'mark', which are recorded as "<stage>.<sub-stage>".
+class UpdateTimeline
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stage
+    {
+        std::string name;
+        std::chrono::microseconds duration;
+    };
+
+    explicit UpdateTimeline(std::string version);
+
+    // @brief         End the open stage, if any, and start 'stage'.
+    void begin(std::string_view stage);
+
+    // @brief         End the open sub-stage, if any, and start 'subStage'
+    //                within the open stage.
+    void mark(std::string_view subStage);
+
+    // @brief         End all open stages.
+    void finish(bool success);
+
+    // wall clock time the update started
+    std::chrono::system_clock::time_point started;
+
+    // version of the component which is being updated to
+    std::string version;
+
+    bool success = false;
+
+    // stages in the order they were started
+    std::vector<Stage> stages;
+
+  private:
+    struct OpenStage
+    {
+        size_t index;
+        Clock::time_point start;
+    };
+
+    void end(std::optional<OpenStage>& open);
+
+    std::optional<OpenStage> stage;
+    std::optional<OpenStage> subStage;
+};
+
+// Keeps the timelines of the last updates of a device. Each completed update
+// is logged, and the kept timelines are written to a dump file, if any.
+class UpdateTimingHistory
+{
+  public:
+    // @param path       the dump file, replaced atomically, or empty to only
+    //                   log the timelines
+    // @param capacity   number of timelines to keep
+    UpdateTimingHistory(std::string path, size_t capacity);
+
+    // @brief     Record a completed update, dropping the oldest if full.
+    void add(UpdateTimeline timeline);
+
+    const std::deque<UpdateTimeline>& timelines() const
+    {
+        return history;
+    }
+
+    // @returns   human readable timelines, the oldest first
+    std::string dump() const;
+
+  private:
+    // @returns   true if the dump was written to 'path'
+    bool dumpToFile() const;
+
+    std::string path;
+    size_t capacity;
+    std::deque<UpdateTimeline> history;
+};
+
+} // namespace phosphor::software::timing
@@ -81,30 +81,22 @@ template <typename>
 inline constexpr bool always_false = false;
 
 /**
- * @brief Constructs a vector of bytes (`std::vector<uint8_t>`) from a variable
- *        number of arguments, which can include enums, integral values,
- *        and initializer lists.
- *
- * This function is useful when building byte packets or command sequences
- * to be sent over communication protocols (e.g., I2C, UART, SPI).
+ * @brief Constructs a byte container from a variable number of arguments,
+ *        which can include enums, integral values, and initializer lists.
  *
+ * @tparam Container Output container, e.g. `std::vector<uint8_t>` or a fixed
+ *         capacity buffer providing push_back() and insert().
  * @tparam Args Types of arguments to convert into bytes
- * @param args The values to encode into the byte vector
- * @return std::vector<uint8_t> A flattened list of bytes
+ * @param args The values to encode into the container
+ * @return Container A flattened list of bytes
  *
  * @note Passing unsupported types will trigger a compile-time static_assert.
  * @note Endianness: Multi-byte integers use little-endian order.
- *
- * @code
- * enum class Command : uint8_t { Start = 0x01 };
- * auto buf = buildByteVector(Command::Start, 0x1234, {0xAA, 0xBB});
- * // Result: { 0x01, 0x34, 0x12, 0xAA, 0xBB }
- * @endcode
  */
-template <typename... Args>
-std::vector<uint8_t> buildByteVector(Args&&... args)
+template <typename Container, typename... Args>
+Container buildBytes(Args&&... args)
 {
-    std::vector<uint8_t> buf;
+    Container buf;
 
     auto append = [&](auto&& value) {
         using T = std::decay_t<decltype(value)>;
@@ -127,7 +119,7 @@ std::vector<uint8_t> buildByteVector(Args&&... args)
         else
         {
             static_assert(always_false<T>,
-                          "Unsupported type in buildByteVector");
+                          "Unsupported type in buildBytes");
         }
     };
 
@@ -135,3 +127,30 @@ std::vector<uint8_t> buildByteVector(Args&&... args)
 
     return buf;
 }
+
+/**
+ * @brief Constructs a vector of bytes (`std::vector<uint8_t>`) from a variable
+ *        number of arguments, which can include enums, integral values,
+ *        and initializer lists.
+ *
+ * This function is useful when building byte packets or command sequences
+ * to be sent over communication protocols (e.g., I2C, UART, SPI).
+ *
+ * @tparam Args Types of arguments to convert into bytes
+ * @param args The values to encode into the byte vector
+ * @return std::vector<uint8_t> A flattened list of bytes
+ *
+ * @note Passing unsupported types will trigger a compile-time static_assert.
+ * @note Endianness: Multi-byte integers use little-endian order.
+ *
+ * @code
+ * enum class Command : uint8_t { Start = 0x01 };
+ * auto buf = buildByteVector(Command::Start, 0x1234, {0xAA, 0xBB});
+ * // Result: { 0x01, 0x34, 0x12, 0xAA, 0xBB }
+ * @endcode
+ */
+template <typename... Args>
+std::vector<uint8_t> buildByteVector(Args&&... args)
+{
+    return buildBytes<std::vector<uint8_t>>(std::forward<Args>(args)...);
+}
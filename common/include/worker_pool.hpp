@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace phosphor::software
+{
+
+/*
+ * @class WorkerPool
+ * @brief Runs blocking work, like programming a flash, off the event loop.
+ * Work is posted to a lane, e.g. the bus or controller of a device. Each
+ * lane has its own worker thread, which is started with the first work of
+ * the lane. Work of one lane runs in the order it was posted, different
+ * lanes run in parallel. Completion is reported by the work itself, e.g.
+ * through an eventfd which the posting coroutine awaits.
+ */
+class WorkerPool
+{
+  public:
+    static WorkerPool& instance();
+
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    // @param lane    the lane to run 'work' on
+    // @param work    the work, must not throw
+    void post(const std::string& lane, std::function<void()> work);
+
+    // @returns       number of lanes which have a worker thread
+    size_t lanes();
+
+  private:
+    WorkerPool() = default;
+
+    struct Lane
+    {
+        std::deque<std::function<void()>> pending;
+        std::condition_variable cv;
+        std::thread thread;
+    };
+
+    void run(Lane& lane);
+
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<Lane>> laneMap;
+    bool stopping = false;
+};
+
+} // namespace phosphor::software
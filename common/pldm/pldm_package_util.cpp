@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <libpldm++/firmware_update.hpp>
@@ -14,8 +15,12 @@
 #include <sdbusplus/message/native_types.hpp>
 
 #include <cassert>
+#include <cerrno>
 #include <cstring>
 #include <functional>
+#include <map>
+#include <optional>
+#include <tuple>
 
 PHOSPHOR_LOG2_USING;
 
@@ -108,18 +113,111 @@ std::unique_ptr<void, std::function<void(void*)>> mmapImagePackage(
     return dataUnique;
 }
 
-bool fwDeviceIDRecordMatchesCompatible(const FirmwareDeviceIDRecord& record,
-                                       const std::string& compatible)
+// PackageHeaderIdentifier (16), PackageHeaderFormatRevision (1),
+// PackageHeaderSize (2)
+static constexpr size_t packageHeaderSizeOffset = 17;
+static constexpr size_t packageHeaderFixedSize = 19;
+
+static bool preadFull(int fd, uint8_t* buf, size_t size, off_t offset)
+{
+    size_t done = 0;
+
+    while (done < size)
+    {
+        const ssize_t n = pread(fd, buf + done, size - done, offset + done);
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (n <= 0)
+        {
+            return false;
+        }
+
+        done += n;
+    }
+
+    return true;
+}
+
+std::unique_ptr<void, std::function<void(void*)>> mmapImagePackageLazily(
+    sdbusplus::message::unix_fd image, size_t* sizeOut)
+{
+    debug("open fd {FD}", "FD", int(image));
+
+    struct stat st;
+
+    if (fstat(image.fd, &st) != 0)
+    {
+        error("failed to determine file size");
+        return nullptr;
+    }
+
+    const size_t size = st.st_size;
+
+    uint8_t fixed[packageHeaderFixedSize];
+
+    if (size < sizeof(fixed) || !preadFull(image.fd, fixed, sizeof(fixed), 0))
+    {
+        error("could not read the package header");
+        return nullptr;
+    }
+
+    const size_t headerSize = fixed[packageHeaderSizeOffset] |
+                              fixed[packageHeaderSizeOffset + 1] << 8;
+
+    if (headerSize < sizeof(fixed) || headerSize > size)
+    {
+        error("invalid package header size {SIZE}", "SIZE", headerSize);
+        return nullptr;
+    }
+
+    debug("file size: {SIZE}, header size: {HSIZE}", "SIZE", size, "HSIZE",
+          headerSize);
+
+    // The parser validates component locations against the package size, so
+    // map the whole file. Only the pages the parser touches, i.e. the header,
+    // are read, the component images are not.
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, image.fd, 0);
+
+    if (data == MAP_FAILED)
+    {
+        error("could not mmap the package");
+        return nullptr;
+    }
+
+    // no read ahead into the component images
+    madvise(data, size, MADV_RANDOM);
+
+    using mmapUniquePtr = std::unique_ptr<void, std::function<void(void*)>>;
+
+    mmapUniquePtr dataUnique(data, [size](void* arg) {
+        if (munmap(arg, size) != 0)
+        {
+            error("Failed to un map the PLDM package");
+        }
+    });
+
+    *sizeOut = size;
+
+    return dataUnique;
+}
+
+// @returns   the compatible string of the record, nullptr if it has none
+static const std::string* fwDeviceIDRecordCompatible(
+    const FirmwareDeviceIDRecord& record)
 {
     const auto& desc = record.recordDescriptors;
     if (desc.empty())
     {
-        return false;
+        return nullptr;
     }
 
     if (!desc.contains(PLDM_FWUP_VENDOR_DEFINED))
     {
-        return false;
+        return nullptr;
     }
 
     auto& v = desc.at(PLDM_FWUP_VENDOR_DEFINED);
@@ -127,28 +225,27 @@ bool fwDeviceIDRecordMatchesCompatible(const FirmwareDeviceIDRecord& record,
     if (!v->vendorDefinedDescriptorTitle.has_value())
     {
         debug("descriptor does not have the vendor defined descriptor info");
-        return false;
+        return nullptr;
     }
 
-    std::string actualCompatible = v->vendorDefinedDescriptorTitle.value();
-
-    return compatible == actualCompatible;
+    return &v->vendorDefinedDescriptorTitle.value();
 }
 
-bool fwDeviceIDRecordMatchesIANA(const FirmwareDeviceIDRecord& record,
-                                 uint32_t vendorIANA)
+// @returns   the vendor iana of the record, if it has a valid one
+static std::optional<uint32_t> fwDeviceIDRecordIANA(
+    const FirmwareDeviceIDRecord& record)
 {
     const auto& desc = record.recordDescriptors;
 
     if (desc.empty())
     {
-        return false;
+        return std::nullopt;
     }
 
     if (!desc.contains(PLDM_FWUP_IANA_ENTERPRISE_ID))
     {
         error("did not find iana enterprise id");
-        return false;
+        return std::nullopt;
     }
 
     auto& viana = desc.at(PLDM_FWUP_IANA_ENTERPRISE_ID);
@@ -158,13 +255,24 @@ bool fwDeviceIDRecordMatchesIANA(const FirmwareDeviceIDRecord& record,
     if (dd.data.size() != 4)
     {
         error("descriptor data wrong size ( != 4) for vendor iana");
-        return false;
+        return std::nullopt;
     }
 
-    const uint32_t actualIANA =
-        dd.data[0] | dd.data[1] << 8 | dd.data[2] << 16 | dd.data[3] << 24;
+    return dd.data[0] | dd.data[1] << 8 | dd.data[2] << 16 | dd.data[3] << 24;
+}
+
+bool fwDeviceIDRecordMatchesCompatible(const FirmwareDeviceIDRecord& record,
+                                       const std::string& compatible)
+{
+    const std::string* actualCompatible = fwDeviceIDRecordCompatible(record);
+
+    return actualCompatible != nullptr && compatible == *actualCompatible;
+}
 
-    return actualIANA == vendorIANA;
+bool fwDeviceIDRecordMatchesIANA(const FirmwareDeviceIDRecord& record,
+                                 uint32_t vendorIANA)
+{
+    return fwDeviceIDRecordIANA(record) == vendorIANA;
 }
 
 bool fwDeviceIDRecordMatches(const FirmwareDeviceIDRecord& record,
@@ -245,4 +353,127 @@ int extractMatchingComponentImage(
     return EXIT_SUCCESS;
 }
 
+size_t PackageIndex::KeyHash::operator()(const Key& key) const
+{
+    return std::hash<std::string>{}(key.second) ^
+           (std::hash<uint32_t>{}(key.first) << 1);
+}
+
+PackageIndex::PackageIndex(const uint8_t* buf, const Package& package)
+{
+    for (const ComponentImageInfo& c : package.componentImageInformation)
+    {
+        components.push_back({c.componentLocation.ptr - buf,
+                              c.componentLocation.length, c.componentVersion});
+    }
+
+    for (const FirmwareDeviceIDRecord& record : package.firmwareDeviceIdRecords)
+    {
+        const std::optional<uint32_t> iana = fwDeviceIDRecordIANA(record);
+        const std::string* compatible = fwDeviceIDRecordCompatible(record);
+
+        if (!iana.has_value() || compatible == nullptr)
+        {
+            continue;
+        }
+
+        // component is 0 based index
+        const ssize_t component =
+            record.applicableComponents.empty()
+                ? noComponent
+                : static_cast<ssize_t>(record.applicableComponents[0]);
+
+        // like the linear search, the first matching record wins
+        records.try_emplace({iana.value(), *compatible}, component);
+    }
+}
+
+int PackageIndex::find(uint32_t vendorIANA, const std::string& compatible,
+                       ComponentLocation& componentOut) const
+{
+    auto it = records.find({vendorIANA, compatible});
+
+    if (it == records.end())
+    {
+        error(
+            "did not find a matching device descriptor for {IANA}, {COMPATIBLE}",
+            "IANA", lg2::hex, vendorIANA, "COMPATIBLE", compatible);
+        return EXIT_FAILURE;
+    }
+
+    if (it->second == noComponent)
+    {
+        error("did not find an applicable component image for the device");
+        return EXIT_FAILURE;
+    }
+
+    if (static_cast<size_t>(it->second) >= components.size())
+    {
+        error("applicable component out of bounds");
+        return EXIT_FAILURE;
+    }
+
+    componentOut = components[it->second];
+
+    return EXIT_SUCCESS;
+}
+
+bool PackageIndex::matches(uint32_t vendorIANA,
+                           const std::string& compatible) const
+{
+    return records.contains({vendorIANA, compatible});
+}
+
+std::shared_ptr<const PackageIndex> PackageIndex::get(
+    sdbusplus::message::unix_fd image)
+{
+    // Indexes are shared while any update still holds them. The file
+    // identity includes size and mtime so a rewritten file is reparsed.
+    using FileKey = std::tuple<dev_t, ino_t, off_t, int64_t, int64_t>;
+    static std::map<FileKey, std::weak_ptr<const PackageIndex>> cache;
+
+    struct stat st;
+
+    if (fstat(image.fd, &st) != 0)
+    {
+        error("failed to stat the package");
+        return nullptr;
+    }
+
+    std::erase_if(cache, [](const auto& entry) {
+        return entry.second.expired();
+    });
+
+    const FileKey key{st.st_dev, st.st_ino, st.st_size, st.st_mtim.tv_sec,
+                      st.st_mtim.tv_nsec};
+
+    if (auto it = cache.find(key); it != cache.end())
+    {
+        debug("reusing the index of package fd {FD}", "FD", int(image));
+        return it->second.lock();
+    }
+
+    size_t size = 0;
+    auto header = mmapImagePackageLazily(image, &size);
+
+    if (header == nullptr)
+    {
+        return nullptr;
+    }
+
+    const uint8_t* buf = static_cast<const uint8_t*>(header.get());
+    std::unique_ptr<Package> package = parsePLDMPackage(buf, size);
+
+    if (package == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto index = std::make_shared<const PackageIndex>(buf, *package);
+
+    cache[key] = index;
+
+    return index;
+}
+
 } // namespace pldm_package_util
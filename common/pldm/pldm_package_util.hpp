@@ -6,6 +6,10 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace pldm_package_util
 {
@@ -43,4 +47,64 @@ int extractMatchingComponentImage(
     uint32_t* componentOffsetOut, size_t* componentSizeOut,
     std::string& componentVersionOut);
 
+// Like 'mmapImagePackage', but the header size is validated first and read
+// ahead is disabled. The whole package is still mapped, since the parser
+// checks component locations against the package size, but parsing the
+// result with 'parsePLDMPackage' only faults in the pages of the header.
+// @param image        file descriptor to the package
+// @param sizeOut      function will write the size of the package here
+// @returns            a unique pointer to the mapped package
+std::unique_ptr<void, std::function<void(void*)>> mmapImagePackageLazily(
+    sdbusplus::message::unix_fd image, size_t* sizeOut);
+
+struct ComponentLocation
+{
+    off_t offset;
+    size_t size;
+    std::string version;
+};
+
+// Index of the device id records of a package, keyed by vendor iana and
+// 'compatible' string. It is built once per package and shared by all
+// devices updated from the same file.
+class PackageIndex
+{
+  public:
+    // @param buf          package buffer 'package' was parsed from
+    // @param package      Package instance
+    PackageIndex(const uint8_t* buf, const pldm::fw_update::Package& package);
+
+    // @param image        file descriptor to the package
+    // @returns            the index of the package, parsed from the package
+    //                     header only if it is not already indexed. nullptr
+    //                     if the package could not be parsed.
+    static std::shared_ptr<const PackageIndex> get(
+        sdbusplus::message::unix_fd image);
+
+    // @param vendorIANA             vendor iana of device
+    // @param compatible             'compatible' string of device
+    // @param componentOut           function returns the component image
+    // @returns                      0 on success
+    int find(uint32_t vendorIANA, const std::string& compatible,
+             ComponentLocation& componentOut) const;
+
+    // @returns                      true if the package has a device id
+    //                               record for the device
+    bool matches(uint32_t vendorIANA, const std::string& compatible) const;
+
+  private:
+    using Key = std::pair<uint32_t, std::string>;
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    static constexpr ssize_t noComponent = -1;
+
+    // record key -> index into 'components'
+    std::unordered_map<Key, ssize_t, KeyHash> records;
+    std::vector<ComponentLocation> components;
+};
+
 } // namespace pldm_package_util
@@ -0,0 +1,136 @@
+#include "component_reader.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+PHOSPHOR_LOG2_USING;
+
+namespace phosphor::software
+{
+
+ComponentMapping::ComponentMapping(void* base, size_t length,
+                                   std::span<const uint8_t> data) :
+    base(base), length(length), image(data)
+{}
+
+ComponentMapping::~ComponentMapping()
+{
+    munmap(base, length);
+}
+
+ComponentReader::ComponentReader(int fd, off_t offset, size_t size) :
+    fd(fcntl(fd, F_DUPFD_CLOEXEC, 0)), componentOffset(offset),
+    componentSize(size)
+{
+    if (this->fd < 0)
+    {
+        error("Failed to duplicate package fd {FD}", "FD", fd);
+    }
+}
+
+ComponentReader::~ComponentReader()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+ssize_t ComponentReader::read(size_t pos, std::span<uint8_t> buf) const
+{
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    if (pos >= componentSize)
+    {
+        return 0;
+    }
+
+    const size_t count = std::min(buf.size(), componentSize - pos);
+    size_t done = 0;
+
+    while (done < count)
+    {
+        const ssize_t n =
+            pread(fd, buf.data() + done, count - done,
+                  componentOffset + static_cast<off_t>(pos + done));
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (n < 0)
+        {
+            error("Failed to read component image: {ERRNO}", "ERRNO", errno);
+            return -1;
+        }
+
+        if (n == 0)
+        {
+            error("Package ends before the component image");
+            return -1;
+        }
+
+        done += n;
+    }
+
+    return static_cast<ssize_t>(done);
+}
+
+bool ComponentReader::readAll(std::vector<uint8_t>& out) const
+{
+    out.resize(componentSize);
+
+    return read(0, out) == static_cast<ssize_t>(componentSize);
+}
+
+std::unique_ptr<ComponentMapping> ComponentReader::map() const
+{
+    struct stat st{};
+
+    if (fd < 0 || componentSize == 0 || fstat(fd, &st) < 0)
+    {
+        return nullptr;
+    }
+
+    // pages of a mapping past the end of the file cannot be accessed
+    if (static_cast<size_t>(st.st_size) <
+        static_cast<size_t>(componentOffset) + componentSize)
+    {
+        error("Package ends before the component image");
+        return nullptr;
+    }
+
+    // the offset of a mapping has to be page aligned
+    const off_t pageSize = sysconf(_SC_PAGESIZE);
+    const off_t start = componentOffset - componentOffset % pageSize;
+    const size_t head = componentOffset - start;
+    const size_t length = head + componentSize;
+
+    void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, start);
+
+    if (base == MAP_FAILED)
+    {
+        error("Failed to map the component image: {ERROR}", "ERROR",
+              strerror(errno));
+        return nullptr;
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(base);
+    const std::span<const uint8_t> data(bytes + head, componentSize);
+
+    return std::make_unique<ComponentMapping>(base, length, data);
+}
+
+} // namespace phosphor::software
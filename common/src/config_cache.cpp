@@ -0,0 +1,62 @@
+#include "config_cache.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/async.hpp>
+
+PHOSPHOR_LOG2_USING;
+
+namespace phosphor::software::config
+{
+
+ConfigCache& ConfigCache::instance()
+{
+    static ConfigCache cache;
+    return cache;
+}
+
+void ConfigCache::update(const std::string& path, const std::string& interface,
+                         const InterfacesMap& properties)
+{
+    interfaces[{path, interface}] = properties;
+}
+
+void ConfigCache::remove(const std::string& path, const std::string& interface)
+{
+    interfaces.erase({path, interface});
+}
+
+sdbusplus::async::task<bool> ConfigCache::fetch(
+    sdbusplus::async::context& ctx, const std::string& service,
+    const std::string& path, const std::string& interface)
+{
+    if (interfaces.contains({path, interface}))
+    {
+        co_return true;
+    }
+
+    auto client = sdbusplus::async::proxy()
+                      .service(service)
+                      .path(path)
+                      .interface("org.freedesktop.DBus.Properties");
+
+    try
+    {
+        auto properties =
+            co_await client.call<InterfacesMap>(ctx, "GetAll", interface);
+
+        debug("[config] cached {COUNT} properties of {INTF} at {PATH}",
+              "COUNT", properties.size(), "INTF", interface, "PATH", path);
+
+        interfaces.try_emplace({path, interface}, std::move(properties));
+    }
+    catch (std::exception& e)
+    {
+        debug("[config] could not get {INTF} at {PATH}: {ERROR}", "INTF",
+              interface, "PATH", path, "ERROR", e);
+        co_return false;
+    }
+
+    co_return true;
+}
+
+} // namespace phosphor::software::config
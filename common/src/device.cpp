@@ -1,9 +1,13 @@
 #include "device.hpp"
 
 #include "common/pldm/pldm_package_util.hpp"
+#include "common_config.h"
 #include "software.hpp"
 #include "software_manager.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/asio/object_server.hpp>
 #include <sdbusplus/async/context.hpp>
@@ -12,7 +16,14 @@
 #include <xyz/openbmc_project/Software/ActivationProgress/aserver.hpp>
 #include <xyz/openbmc_project/State/Host/client.hpp>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <utility>
+#include <vector>
 
 PHOSPHOR_LOG2_USING;
 
@@ -31,6 +42,97 @@ const auto applyTimeImmediate = sdbusplus::common::xyz::openbmc_project::
 const auto ActivationInvalid = ActivationInterface::Activations::Invalid;
 const auto ActivationFailed = ActivationInterface::Activations::Failed;
 
+#ifdef STAGED_UPDATES
+constexpr bool stagedUpdates = true;
+#else
+constexpr bool stagedUpdates = false;
+#endif
+
+// @brief   Writes the staged image, replacing the previous one atomically.
+static bool writeStagedImage(const std::filesystem::path& path,
+                             const std::vector<uint8_t>& image)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    const std::filesystem::path tmpPath = path.string() + ".tmp";
+
+    const int fd =
+        open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+
+    if (fd < 0)
+    {
+        error("Failed to open {PATH}: {ERR}", "PATH", tmpPath, "ERR",
+              strerror(errno));
+        return false;
+    }
+
+    size_t written = 0;
+
+    while (written < image.size())
+    {
+        const ssize_t n =
+            write(fd, image.data() + written, image.size() - written);
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (n <= 0)
+        {
+            error("Failed to write {PATH}: {ERR}", "PATH", tmpPath, "ERR",
+                  strerror(errno));
+            close(fd);
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+
+        written += n;
+    }
+
+    const bool synced = fsync(fd) == 0;
+
+    close(fd);
+
+    if (!synced)
+    {
+        error("Failed to sync {PATH}: {ERR}", "PATH", tmpPath, "ERR",
+              strerror(errno));
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    std::filesystem::rename(tmpPath, path, ec);
+
+    if (ec)
+    {
+        error("Failed to rename {PATH}: {ERR}", "PATH", tmpPath, "ERR",
+              ec.message());
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    return true;
+}
+
+static bool readStagedImage(const std::filesystem::path& path,
+                            std::vector<uint8_t>& image)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+        error("Failed to open the staged image {PATH}", "PATH", path);
+        return false;
+    }
+
+    image.assign(std::istreambuf_iterator<char>(file),
+                 std::istreambuf_iterator<char>());
+
+    return !file.bad();
+}
+
 Device::Device(sdbusplus::async::context& ctx, const SoftwareConfig& config,
                manager::SoftwareManager* parent,
                std::set<RequestedApplyTimes> allowedApplyTimes =
@@ -38,49 +140,42 @@ Device::Device(sdbusplus::async::context& ctx, const SoftwareConfig& config,
                     RequestedApplyTimes::OnReset}) :
     allowedApplyTimes(std::move(allowedApplyTimes)), config(config),
     parent(parent), ctx(ctx), events(ctx)
-{}
+{
+    if (stagedUpdates)
+    {
+        // The software a staged image belonged to did not survive a restart
+        // of the updater, so its image is stale.
+        std::error_code ec;
+        std::filesystem::remove(stagedImagePath(), ec);
+    }
+}
 
 sdbusplus::async::task<bool> Device::getImageInfo(
     const sdbusplus::object_path& objectPath,
-    std::unique_ptr<void, std::function<void(void*)>>& pldmPackage,
-    size_t pldmPackageSize, uint8_t** matchingComponentImage,
-    size_t* componentImageSize, std::string& componentVersion)
+    const pldm_package_util::PackageIndex* packageIndex,
+    pldm_package_util::ComponentLocation& component)
 
 {
-    std::unique_ptr<pldm::fw_update::Package> package =
-        pldm_package_util::parsePLDMPackage(
-            static_cast<uint8_t*>(pldmPackage.get()), pldmPackageSize);
-
-    if (package == nullptr)
+    if (packageIndex == nullptr)
     {
         error("could not parse PLDM package");
-        co_await events.generateVerificationFailed(objectPath, componentVersion,
-                                                   true);
+        events.generateVerificationFailed(objectPath, component.version, true);
         co_return false;
     }
 
-    co_await events.generateVerificationFailed(objectPath, componentVersion,
-                                               false);
+    events.generateVerificationFailed(objectPath, component.version, false);
 
-    uint32_t componentOffset = 0;
-    const int status = pldm_package_util::extractMatchingComponentImage(
-        static_cast<uint8_t*>(pldmPackage.get()), package,
-        config.compatibleHardware, config.vendorIANA, &componentOffset,
-        componentImageSize, componentVersion);
+    const int status = packageIndex->find(
+        config.vendorIANA, config.compatibleHardware, component);
 
     if (status != 0)
     {
         error("could not extract matching component image");
-        co_await events.generateUpdateNotApplicable(objectPath,
-                                                    componentVersion, true);
+        events.generateUpdateNotApplicable(objectPath, component.version, true);
         co_return false;
     }
 
-    *matchingComponentImage =
-        static_cast<uint8_t*>(pldmPackage.get()) + componentOffset;
-
-    co_await events.generateUpdateNotApplicable(objectPath, componentVersion,
-                                                false);
+    events.generateUpdateNotApplicable(objectPath, component.version, false);
 
     co_return true;
 }
@@ -91,37 +186,48 @@ sdbusplus::async::task<bool> Device::startUpdateAsync(
 {
     debug("starting the async update with memfd {FD}", "FD", image.fd);
 
-    size_t pldm_pkg_size = 0;
-    auto pldm_pkg = pldm_package_util::mmapImagePackage(image, &pldm_pkg_size);
+    updateTimeline.emplace("");
 
-    if (pldm_pkg == nullptr)
+    if (image.fd < 0)
     {
         softwarePendingIn->setActivation(ActivationInvalid);
+        finishUpdateTimeline(false);
         co_return false;
     }
 
-    uint8_t* componentImage;
-    size_t componentImageSize = 0;
-    std::string componentVersion;
+    updateTimeline->begin("package");
 
-    if (!co_await getImageInfo(softwarePendingIn->objectPath, pldm_pkg,
-                               pldm_pkg_size, &componentImage,
-                               &componentImageSize, componentVersion))
+    // Held for the whole update, so devices updated from the same package
+    // in the meantime reuse the index instead of parsing it again.
+    const std::shared_ptr<const pldm_package_util::PackageIndex> packageIndex =
+        pldm_package_util::PackageIndex::get(image);
+
+    pldm_package_util::ComponentLocation location{};
+
+    if (!co_await getImageInfo(softwarePendingIn->objectPath,
+                               packageIndex.get(), location))
     {
         softwarePendingIn->setActivation(ActivationInvalid);
+        finishUpdateTimeline(false);
         co_return false;
     }
 
+    const std::string& componentVersion = location.version;
+
+    updateTimeline->version = componentVersion;
+
+    const ComponentReader component(image.fd, location.offset, location.size);
+
     std::unique_ptr<Software> softwarePendingOld = std::move(softwarePending);
 
     softwarePending = std::move(softwarePendingIn);
     softwarePendingIn = nullptr;
 
-    co_await events.generateTargetDetermined(softwarePending->objectPath,
-                                             componentVersion);
+    events.generateTargetDetermined(softwarePending->objectPath,
+                                    componentVersion);
 
-    const bool success = co_await continueUpdateWithMappedPackage(
-        componentImage, componentImageSize, componentVersion, applyTime);
+    const bool success = co_await continueUpdateWithComponent(
+        component, componentVersion, applyTime);
 
     if (!success)
     {
@@ -131,6 +237,8 @@ sdbusplus::async::task<bool> Device::startUpdateAsync(
 
         softwarePending = std::move(softwarePendingOld);
 
+        finishUpdateTimeline(false);
+
         co_return false;
     }
 
@@ -146,6 +254,8 @@ sdbusplus::async::task<bool> Device::startUpdateAsync(
               softwareCurrent->swid);
     }
 
+    finishUpdateTimeline(true);
+
     co_return true;
 }
 
@@ -154,6 +264,28 @@ std::string Device::getEMConfigType() const
     return config.configType;
 }
 
+std::optional<std::string> Device::getUpdateBus() const
+{
+    return std::nullopt;
+}
+
+std::set<std::string> Device::getUpdateResources() const
+{
+    std::set<std::string> resources;
+
+    if (auto bus = getUpdateBus(); bus.has_value())
+    {
+        resources.insert(bus.value());
+    }
+
+    return resources;
+}
+
+std::set<std::string> Device::getSharedUpdateResources() const
+{
+    return {};
+}
+
 sdbusplus::async::task<bool> Device::resetDevice()
 {
     debug("Default implementation for device reset");
@@ -163,26 +295,63 @@ sdbusplus::async::task<bool> Device::resetDevice()
 
 bool Device::setUpdateProgress(uint8_t progress) const
 {
-    if (!softwarePending || !softwarePending->softwareActivationProgress)
+    if (progressListener)
+    {
+        progressListener(progress);
+    }
+
+    if (!softwarePending || !softwarePending->softwareActivationProgress ||
+        !progressPublisher)
     {
         return false;
     }
 
-    softwarePending->softwareActivationProgress->progress(progress);
+    progressPublisher->update(progress);
 
     return true;
 }
 
-sdbusplus::async::task<bool> Device::continueUpdateWithMappedPackage(
-    const uint8_t* matchingComponentImage, size_t componentImageSize,
-    const std::string& componentVersion, RequestedApplyTimes applyTime)
+void Device::markUpdateStage(std::string_view stage)
 {
-    softwarePending->setActivation(ActivationInterface::Activations::Ready);
+    if (updateTimeline)
+    {
+        updateTimeline->mark(stage);
+    }
+}
 
-    softwarePending->setVersion(componentVersion,
-                                softwareCurrent->getPurpose().value_or(
-                                    SoftwareVersion::VersionPurpose::Unknown));
+void Device::finishUpdateTimeline(bool success)
+{
+    if (!updateTimeline)
+    {
+        return;
+    }
+
+    updateTimeline->finish(success);
+
+    if (!timingHistory)
+    {
+        const std::string dir = UPDATE_TIMING_DIR;
+        timingHistory = std::make_unique<timing::UpdateTimingHistory>(
+            dir.empty() ? dir
+                        : dir + "/" + config.configName + "-update-timing.txt",
+            UPDATE_TIMING_HISTORY);
+    }
+
+    timingHistory->add(std::move(*updateTimeline));
+
+    updateTimeline.reset();
+}
 
+void Device::setUpdateBytes(uint64_t done, uint64_t total) const
+{
+    if (progressPublisher)
+    {
+        progressPublisher->updateBytes(done, total);
+    }
+}
+
+void Device::startActivationProgress()
+{
     std::string objPath = softwarePending->objectPath;
 
     softwarePending->softwareActivationProgress =
@@ -191,54 +360,319 @@ sdbusplus::async::task<bool> Device::continueUpdateWithMappedPackage(
 
     softwarePending->softwareActivationProgress->emit_added();
 
+    auto* activationProgress =
+        softwarePending->softwareActivationProgress.get();
+
+    progressPublisher = std::make_shared<ProgressPublisher>(
+        [activationProgress](uint8_t progress) {
+            activationProgress->progress(progress);
+        },
+        std::chrono::milliseconds(PROGRESS_MIN_INTERVAL_MS),
+        [this](std::chrono::milliseconds delay) {
+            ctx.spawn(flushProgressAfter(ctx, progressPublisher, delay));
+        });
+}
+
+sdbusplus::async::task<> Device::flushProgressAfter(
+    sdbusplus::async::context& ctx, std::weak_ptr<ProgressPublisher> publisher,
+    std::chrono::milliseconds delay)
+{
+    co_await sdbusplus::async::sleep_for(ctx, delay);
+
+    // gone if the update finished, which flushed it already
+    if (auto current = publisher.lock())
+    {
+        current->flush();
+    }
+
+    co_return;
+}
+
+void Device::stopActivationProgress()
+{
+    // publish the final progress which the rate limit held back
+    if (progressPublisher)
+    {
+        progressPublisher->flush();
+        progressPublisher.reset();
+    }
+
+    softwarePending->softwareActivationProgress = nullptr;
+}
+
+sdbusplus::async::task<bool> Device::isImageProgrammed(
+    const ComponentReader& /*component*/)
+{
+    co_return false;
+}
+
+sdbusplus::async::task<bool> Device::stageImage(
+    const uint8_t* image, size_t image_size, std::vector<uint8_t>& staged)
+{
+    staged.assign(image, image + image_size);
+
+    co_return true;
+}
+
+sdbusplus::async::task<bool> Device::updateDeviceStaged(const uint8_t* image,
+                                                        size_t image_size)
+{
+    co_return co_await updateDevice(image, image_size);
+}
+
+std::filesystem::path Device::stagedImagePath() const
+{
+    std::string name = config.configName;
+    std::ranges::replace(name, '/', '_');
+
+    return std::filesystem::path(STAGING_DIR) / (name + ".bin");
+}
+
+bool Device::hasStagedUpdate() const
+{
+    return stagedVersion.has_value();
+}
+
+void Device::discardStagedUpdate()
+{
+    if (!stagedVersion.has_value())
+    {
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(stagedImagePath(), ec);
+
+    stagedVersion.reset();
+}
+
+sdbusplus::async::task<bool> Device::stageUpdate(
+    const ComponentReader& component, const std::string& version)
+{
+    softwarePending->setActivation(ActivationInterface::Activations::Staging);
+
+    updateTimeline->begin("stage");
+
+    std::vector<uint8_t> image;
+    std::vector<uint8_t> staged;
+
+    if (!component.readAll(image))
+    {
+        error("could not read the component image");
+        co_return false;
+    }
+
+    if (!co_await stageImage(image.data(), image.size(), staged))
+    {
+        error("The image for {NAME} was rejected", "NAME", config.configName);
+        events.generateActivateFailed(softwarePending->objectPath, version,
+                                      true);
+        co_return false;
+    }
+
+    const std::filesystem::path path = stagedImagePath();
+
+    if (!writeStagedImage(path, staged))
+    {
+        co_return false;
+    }
+
+    stagedVersion = version;
+
+    info("Staged {SIZE} bytes for {NAME} at {PATH}", "SIZE", staged.size(),
+         "NAME", config.configName, "PATH", path);
+
+    softwarePending->setActivation(ActivationInterface::Activations::Staged);
+
+    updateTimeline->begin("associations");
+
+    co_await softwarePending->createInventoryAssociations(false);
+
+    events.generateResetRequired(softwarePending->objectPath,
+                                 events::HostTransition::Reboot);
+
+    co_return true;
+}
+
+sdbusplus::async::task<bool> Device::applyStagedUpdate()
+{
+    if (!stagedVersion.has_value() || !softwarePending)
+    {
+        co_return false;
+    }
+
+    const std::string version = stagedVersion.value();
+    const std::filesystem::path path = stagedImagePath();
+
+    std::vector<uint8_t> image;
+    const bool loaded = readStagedImage(path, image);
+
+    discardStagedUpdate();
+
+    updateTimeline.emplace(version);
+
+    startActivationProgress();
+
+    softwarePending->setActivationBlocksTransition(true);
+
+    softwarePending->setActivation(
+        ActivationInterface::Activations::Activating);
+
+    updateTimeline->begin("update");
+
+    const bool success =
+        loaded && co_await updateDeviceStaged(image.data(), image.size());
+
+    softwarePending->setActivationBlocksTransition(false);
+
+    stopActivationProgress();
+
+    if (!success)
+    {
+        error("Failed to apply the staged update of {NAME}", "NAME",
+              config.configName);
+        softwarePending->setActivation(ActivationFailed);
+        events.generateActivateFailed(softwarePending->objectPath, version,
+                                      true);
+        finishUpdateTimeline(false);
+        co_return false;
+    }
+
+    updateTimeline->begin("reset");
+
+    co_await resetDevice();
+
+    updateTimeline->begin("associations");
+
+    softwarePending->setActivation(ActivationInterface::Activations::Active);
+
+    events.generateActivateFailed(softwarePending->objectPath, version, false);
+    events.generateUpdateSuccessful(softwarePending->objectPath, version);
+
+    co_await softwarePending->createInventoryAssociations(true);
+
+    softwarePending->enableUpdate(allowedApplyTimes);
+
+    softwareCurrent = std::move(softwarePending);
+    softwarePending = nullptr;
+
+    finishUpdateTimeline(true);
+
+    info("Applied the staged update of {NAME} to {VERSION}", "NAME",
+         config.configName, "VERSION", version);
+
+    co_return true;
+}
+
+sdbusplus::async::task<bool> Device::updateDeviceStreaming(
+    const ComponentReader& component)
+{
+    std::vector<uint8_t> componentImage;
+
+    if (!component.readAll(componentImage))
+    {
+        error("could not read the component image");
+        co_return false;
+    }
+
+    co_return co_await updateDevice(componentImage.data(),
+                                    componentImage.size());
+}
+
+sdbusplus::async::task<bool> Device::continueUpdateWithComponent(
+    const ComponentReader& component, const std::string& componentVersion,
+    RequestedApplyTimes applyTime)
+{
+    softwarePending->setActivation(ActivationInterface::Activations::Ready);
+
+    softwarePending->setVersion(componentVersion,
+                                softwareCurrent->getPurpose().value_or(
+                                    SoftwareVersion::VersionPurpose::Unknown));
+
+    // a new update replaces an update staged before
+    discardStagedUpdate();
+
+    updateTimeline->begin("compare");
+
+    // The checksum a device reports is the one of its non-volatile image,
+    // which may not be active yet. So only programming is skipped, the
+    // reset still follows the requested apply time.
+    const bool programmed = co_await isImageProgrammed(component);
+
+    if (programmed)
+    {
+        info("{NAME} already holds version {VERSION}, skipping the update",
+             "NAME", config.configName, "VERSION", componentVersion);
+    }
+    else if (stagedUpdates && applyTime != applyTimeImmediate)
+    {
+        co_return co_await stageUpdate(component, componentVersion);
+    }
+
+    startActivationProgress();
+
     softwarePending->setActivationBlocksTransition(true);
 
     softwarePending->setActivation(
         ActivationInterface::Activations::Activating);
 
-    bool success =
-        co_await updateDevice(matchingComponentImage, componentImageSize);
+    updateTimeline->begin("update");
+
+    bool success = programmed || co_await updateDeviceStreaming(component);
+
+    if (programmed)
+    {
+        setUpdateProgress(100);
+    }
+
+    updateTimeline->begin("activation");
 
     if (success)
     {
         softwarePending->setActivation(
             ActivationInterface::Activations::Active);
 
-        co_await events.generateActivateFailed(softwarePending->objectPath,
-                                               componentVersion, false);
+        events.generateActivateFailed(softwarePending->objectPath,
+                                      componentVersion, false);
 
-        co_await events.generateUpdateSuccessful(softwarePending->objectPath,
-                                                 componentVersion);
+        events.generateUpdateSuccessful(softwarePending->objectPath,
+                                        componentVersion);
     }
 
     softwarePending->setActivationBlocksTransition(false);
 
-    softwarePending->softwareActivationProgress = nullptr;
+    stopActivationProgress();
 
     if (!success)
     {
         // do not apply the update, it has failed.
         // We can delete the new software version.
-        co_await events.generateActivateFailed(softwarePending->objectPath,
-                                               componentVersion, true);
+        events.generateActivateFailed(softwarePending->objectPath,
+                                      componentVersion, true);
 
         co_return false;
     }
 
     if (applyTime == applyTimeImmediate)
     {
+        updateTimeline->begin("reset");
+
         co_await resetDevice();
 
+        updateTimeline->begin("associations");
+
         co_await softwarePending->createInventoryAssociations(true);
 
         softwarePending->enableUpdate(allowedApplyTimes);
     }
     else
     {
+        updateTimeline->begin("associations");
+
         co_await softwarePending->createInventoryAssociations(false);
 
-        co_await events.generateResetRequired(softwarePending->objectPath,
-                                              events::HostTransition::Reboot);
+        events.generateResetRequired(softwarePending->objectPath,
+                                     events::HostTransition::Reboot);
     }
 
     co_return true;
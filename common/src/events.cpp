@@ -1,10 +1,21 @@
 #include "events.hpp"
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include <phosphor-logging/commit.hpp>
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/async.hpp>
+#include <sdbusplus/async/fdio.hpp>
 #include <xyz/openbmc_project/Software/Update/event.hpp>
 
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
 namespace phosphor::software::events
 {
 
@@ -13,6 +24,8 @@ PHOSPHOR_LOG2_USING;
 namespace error_intf = sdbusplus::error::xyz::openbmc_project::software::Update;
 namespace event_intf = sdbusplus::event::xyz::openbmc_project::software::Update;
 
+using namespace std::literals;
+
 // Strip the unique suffix (e.g. "_1234") from the object path so the
 // pendingEvents key remains stable across update attempts.
 static auto getDeviceBaseObjPath(const sdbusplus::object_path& path)
@@ -26,10 +39,159 @@ static auto getDeviceBaseObjPath(const sdbusplus::object_path& path)
     return path.str;
 }
 
+class Events::Queue : public std::enable_shared_from_this<Queue>
+{
+  public:
+    using entry_t = std::function<sdbusplus::async::task<>()>;
+
+    explicit Queue(sdbusplus::async::context& ctx) : ctx(ctx) {}
+
+    // @brief       Queue an event for the target. Entries of one target are
+    //              committed in order, different targets do not wait on
+    //              each other.
+    void push(const sdbusplus::object_path& targetName, entry_t entry);
+
+    template <typename ErrorType>
+    auto commitError(std::string_view errorName,
+                     sdbusplus::object_path targetName,
+                     std::string imageIdentifier, bool asserted)
+        -> sdbusplus::async::task<>;
+
+    template <typename EventType>
+    auto commitEvent(std::string_view eventName,
+                     sdbusplus::object_path targetName,
+                     std::string imageIdentifier) -> sdbusplus::async::task<>;
+
+    auto commitResetRequired(sdbusplus::object_path targetName,
+                             HostTransition resetType)
+        -> sdbusplus::async::task<>;
+
+    // An eventfd registered with the queue while a coroutine waits in
+    // 'flush', removed also if the coroutine is cancelled.
+    struct FlushWaiter
+    {
+        explicit FlushWaiter(Queue& queue);
+        ~FlushWaiter();
+
+        FlushWaiter(const FlushWaiter&) = delete;
+        FlushWaiter& operator=(const FlushWaiter&) = delete;
+
+        Queue& queue;
+        const int fd;
+    };
+
+    sdbusplus::async::context& ctx;
+    size_t queued = 0;
+
+  private:
+    // @brief       Count an entry as committed, and wake the coroutines in
+    //              'flush' once none is left.
+    void committed();
+
+    // eventfds of the coroutines waiting for the queue to drain
+    std::vector<int> flushWaiters;
+
+    struct Lane
+    {
+        std::deque<entry_t> entries;
+        bool draining = false;
+    };
+
+    // @brief       Commit the entries of a lane in order, until it is
+    //              empty. Each entry is a call of its own to the logging
+    //              service, the lane only keeps them off the update flow.
+    // @param self  keeps the queue alive until the lane is drained
+    auto drain(std::shared_ptr<Queue> self, std::string key)
+        -> sdbusplus::async::task<>;
+
+    using event_map_t = std::map<std::string, sdbusplus::object_path>;
+
+    // base object path -> entries not yet committed
+    std::map<std::string, Lane> lanes;
+    event_map_t pendingEvents;
+};
+
+void Events::Queue::push(const sdbusplus::object_path& targetName,
+                         entry_t entry)
+{
+    auto key = getDeviceBaseObjPath(targetName);
+    auto& lane = lanes[key];
+
+    lane.entries.push_back(std::move(entry));
+    queued++;
+
+    if (!lane.draining)
+    {
+        lane.draining = true;
+        ctx.spawn(drain(shared_from_this(), std::move(key)));
+    }
+}
+
+auto Events::Queue::drain([[maybe_unused]] std::shared_ptr<Queue> self,
+                          std::string key)
+    -> sdbusplus::async::task<>
+{
+    while (true)
+    {
+        auto lane = lanes.find(key);
+
+        if (lane->second.entries.empty())
+        {
+            lanes.erase(lane);
+            break;
+        }
+
+        // take the entries out, the lane may grow while they are committed
+        std::deque<entry_t> entries;
+        entries.swap(lane->second.entries);
+
+        debug("committing {COUNT} events for {KEY}", "COUNT", entries.size(),
+              "KEY", key);
+
+        for (auto& entry : entries)
+        {
+            co_await entry();
+            committed();
+        }
+    }
+}
+
+void Events::Queue::committed()
+{
+    if (--queued > 0)
+    {
+        return;
+    }
+
+    const uint64_t one = 1;
+    for (const int fd : flushWaiters)
+    {
+        [[maybe_unused]] ssize_t written = ::write(fd, &one, sizeof(one));
+    }
+}
+
+Events::Queue::FlushWaiter::FlushWaiter(Queue& queue) :
+    queue(queue), fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    if (fd >= 0)
+    {
+        queue.flushWaiters.push_back(fd);
+    }
+}
+
+Events::Queue::FlushWaiter::~FlushWaiter()
+{
+    if (fd >= 0)
+    {
+        std::erase(queue.flushWaiters, fd);
+        ::close(fd);
+    }
+}
+
 template <typename ErrorType>
-auto Events::generateError(std::string_view errorName,
-                           sdbusplus::object_path targetName,
-                           std::string imageIdentifier, bool asserted)
+auto Events::Queue::commitError(std::string_view errorName,
+                                sdbusplus::object_path targetName,
+                                std::string imageIdentifier, bool asserted)
     -> sdbusplus::async::task<>
 {
     auto eventName =
@@ -72,35 +234,10 @@ auto Events::generateError(std::string_view errorName,
           eventName, "STATUS", (asserted ? "asserted" : "deasserted"));
 }
 
-auto Events::generateVerificationFailed(sdbusplus::object_path targetName,
-                                        std::string imageIdentifier,
-                                        bool asserted)
-    -> sdbusplus::async::task<>
-{
-    co_await generateError<error_intf::VerificationFailed>(
-        "VerificationFailed", targetName, imageIdentifier, asserted);
-}
-
-auto Events::generateActivateFailed(sdbusplus::object_path targetName,
-                                    std::string imageIdentifier, bool asserted)
-    -> sdbusplus::async::task<>
-{
-    co_await generateError<error_intf::ActivateFailed>(
-        "ActivateFailed", targetName, imageIdentifier, asserted);
-}
-
-auto Events::generateUpdateNotApplicable(
-    sdbusplus::object_path targetName, std::string imageIdentifier,
-    bool asserted) -> sdbusplus::async::task<>
-{
-    co_await generateError<error_intf::UpdateNotApplicable>(
-        "UpdateNotApplicable", targetName, imageIdentifier, asserted);
-}
-
 template <typename EventType>
-auto Events::generateEvent(std::string_view eventName,
-                           sdbusplus::object_path targetName,
-                           std::string imageIdentifier)
+auto Events::Queue::commitEvent(std::string_view eventName,
+                                sdbusplus::object_path targetName,
+                                std::string imageIdentifier)
     -> sdbusplus::async::task<>
 {
     try
@@ -116,36 +253,119 @@ auto Events::generateEvent(std::string_view eventName,
     }
 }
 
-auto Events::generateTargetDetermined(sdbusplus::object_path targetName,
-                                      std::string imageIdentifier)
+auto Events::Queue::commitResetRequired(sdbusplus::object_path targetName,
+                                        HostTransition resetType)
     -> sdbusplus::async::task<>
 {
-    co_await generateEvent<event_intf::TargetDetermined>(
-        "TargetDetermined", targetName, imageIdentifier);
+    try
+    {
+        co_await lg2::commit(
+            ctx, event_intf::ResetRequired("TARGET_NAME", targetName,
+                                           "RESET_TYPE", resetType));
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to commit ResetRequired event: {ERR}", "ERR", e.what());
+    }
+}
+
+Events::Events(sdbusplus::async::context& ctx) :
+    queue(std::make_shared<Queue>(ctx))
+{}
+
+void Events::generateVerificationFailed(sdbusplus::object_path targetName,
+                                        std::string imageIdentifier,
+                                        bool asserted)
+{
+    queue->push(targetName, [q = queue.get(), targetName, imageIdentifier,
+                             asserted]() {
+        return q->commitError<error_intf::VerificationFailed>(
+            "VerificationFailed", targetName, imageIdentifier, asserted);
+    });
+}
+
+void Events::generateActivateFailed(sdbusplus::object_path targetName,
+                                    std::string imageIdentifier, bool asserted)
+{
+    queue->push(targetName, [q = queue.get(), targetName, imageIdentifier,
+                             asserted]() {
+        return q->commitError<error_intf::ActivateFailed>(
+            "ActivateFailed", targetName, imageIdentifier, asserted);
+    });
+}
+
+void Events::generateUpdateNotApplicable(sdbusplus::object_path targetName,
+                                         std::string imageIdentifier,
+                                         bool asserted)
+{
+    queue->push(targetName, [q = queue.get(), targetName, imageIdentifier,
+                             asserted]() {
+        return q->commitError<error_intf::UpdateNotApplicable>(
+            "UpdateNotApplicable", targetName, imageIdentifier, asserted);
+    });
 }
 
-auto Events::generateUpdateSuccessful(sdbusplus::object_path targetName,
+void Events::generateTargetDetermined(sdbusplus::object_path targetName,
+                                      std::string imageIdentifier)
+{
+    queue->push(targetName, [q = queue.get(), targetName, imageIdentifier]() {
+        return q->commitEvent<event_intf::TargetDetermined>(
+            "TargetDetermined", targetName, imageIdentifier);
+    });
+}
+
+void Events::generateUpdateSuccessful(sdbusplus::object_path targetName,
                                       std::string imageIdentifier)
-    -> sdbusplus::async::task<>
 {
-    co_await generateEvent<event_intf::UpdateSuccessful>(
-        "UpdateSuccessful", targetName, imageIdentifier);
+    queue->push(targetName, [q = queue.get(), targetName, imageIdentifier]() {
+        return q->commitEvent<event_intf::UpdateSuccessful>(
+            "UpdateSuccessful", targetName, imageIdentifier);
+    });
 }
 
-auto Events::generateResetRequired(sdbusplus::object_path targetName,
+void Events::generateResetRequired(sdbusplus::object_path targetName,
                                    HostTransition resetType)
-    -> sdbusplus::async::task<>
 {
-    try
+    queue->push(targetName, [q = queue.get(), targetName, resetType]() {
+        return q->commitResetRequired(targetName, resetType);
+    });
+}
+
+auto Events::flush() -> sdbusplus::async::task<>
+{
+    if (queue->queued == 0)
     {
-        co_await lg2::commit(
-            ctx, event_intf::ResetRequired("TARGET_NAME", targetName,
-                                           "RESET_TYPE", resetType));
+        co_return;
     }
-    catch (const std::exception& e)
+
+    // the queue outlives this object if the lanes are still draining
+    const std::shared_ptr<Queue> self = queue;
+
+    Queue::FlushWaiter waiter(*self);
+
+    if (waiter.fd < 0)
     {
-        error("Failed to commit ResetRequired event: {ERR}", "ERR", e.what());
+        error("Failed to create an eventfd to wait for events: {ERROR}",
+              "ERROR", strerror(errno));
+        co_return;
     }
+
+    sdbusplus::async::fdio fdio(self->ctx, waiter.fd);
+
+    // events queued after the wake up belong to this flush as well
+    while (self->queued > 0)
+    {
+        co_await fdio.next();
+
+        uint64_t count = 0;
+        [[maybe_unused]] ssize_t consumed =
+            ::read(waiter.fd, &count, sizeof(count));
+    }
+}
+
+size_t Events::queued() const
+{
+    return queue->queued;
 }
 
 } // namespace phosphor::software::events
@@ -49,6 +49,11 @@ bool GPIOGroup::hasGPIOs() const
     return !lines.empty();
 }
 
+const std::vector<std::string>& GPIOGroup::getLines() const
+{
+    return lines;
+}
+
 void GPIOGroup::releaseAll()
 {
     for (auto& b : activeBulks)
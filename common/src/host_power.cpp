@@ -2,9 +2,15 @@
 
 #include "common_config.h"
 
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/async.hpp>
 #include <sdbusplus/async/context.hpp>
+#include <sdbusplus/async/fdio.hpp>
 #include <sdbusplus/async/match.hpp>
 #include <sdbusplus/async/proxy.hpp>
 #include <sdbusplus/bus/match.hpp>
@@ -12,6 +18,11 @@
 #include <xyz/openbmc_project/ObjectMapper/client.hpp>
 #include <xyz/openbmc_project/State/Host/client.hpp>
 
+#include <cerrno>
+#include <cstring>
+#include <variant>
+#include <vector>
+
 PHOSPHOR_LOG2_USING;
 
 using namespace std::literals;
@@ -40,6 +51,142 @@ HostPower::HostPower(sdbusplus::async::context& ctx) :
                                                         StateIntf::interface))
 {}
 
+namespace
+{
+
+// Waits for the host to reach a state. The PropertiesChanged match and the
+// timeout both wake the waiting coroutine, through an eventfd and a timerfd
+// behind one epoll fd. Nothing outlives the waiter, so the match is removed
+// as soon as the wait is over.
+class StateWaiter
+{
+  public:
+    StateWaiter(sdbusplus::async::context& ctx, HostState state) :
+        target(state), eventFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+        timerFd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)),
+        epollFd(epoll_create1(EPOLL_CLOEXEC)),
+        match(ctx.get_bus(),
+              RulesIntf::propertiesChanged(host0ObjectPath,
+                                           StateIntf::interface),
+              [this](sdbusplus::message_t& msg) { handleChanged(msg); })
+    {
+        for (const int fd : {eventFd, timerFd})
+        {
+            struct epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+
+            if (fd < 0 || epollFd < 0 ||
+                epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+            {
+                valid = false;
+            }
+        }
+    }
+
+    ~StateWaiter()
+    {
+        for (const int fd : {eventFd, timerFd, epollFd})
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+    }
+
+    StateWaiter(const StateWaiter&) = delete;
+    StateWaiter& operator=(const StateWaiter&) = delete;
+    StateWaiter(StateWaiter&&) = delete;
+    StateWaiter& operator=(StateWaiter&&) = delete;
+
+    bool isValid() const
+    {
+        return valid;
+    }
+
+    // @returns   true if the state was reached within 'timeout'
+    sdbusplus::async::task<bool> wait(sdbusplus::async::context& ctx,
+                                      std::chrono::seconds timeout)
+    {
+        struct itimerspec spec{};
+        spec.it_value.tv_sec = timeout.count();
+
+        if (timerfd_settime(timerFd, 0, &spec, nullptr) < 0)
+        {
+            error("Failed to arm the host state timer: {ERROR}", "ERROR",
+                  strerror(errno));
+            co_return false;
+        }
+
+        // Both fds are level triggered, so a wake up which happens before we
+        // start waiting is not lost.
+        sdbusplus::async::fdio fdio(ctx, epollFd);
+
+        bool timedOut = false;
+
+        while (!reached && !timedOut)
+        {
+            co_await fdio.next();
+
+            uint64_t count = 0;
+            [[maybe_unused]] ssize_t consumed =
+                ::read(eventFd, &count, sizeof(count));
+
+            timedOut = ::read(timerFd, &count, sizeof(count)) > 0;
+        }
+
+        co_return reached;
+    }
+
+  private:
+    void handleChanged(sdbusplus::message_t& msg)
+    {
+        std::string interfaceName;
+        HostPropertiesChanged changedProperties;
+
+        try
+        {
+            msg.read(interfaceName, changedProperties);
+        }
+        catch (const std::exception& e)
+        {
+            debug("Ignoring host state change: {ERROR}", "ERROR", e.what());
+            return;
+        }
+
+        auto it = changedProperties.find("CurrentHostState");
+        if (it == changedProperties.end())
+        {
+            return;
+        }
+
+        const auto* hostState = std::get_if<HostState>(&it->second);
+
+        if (hostState != nullptr && *hostState == target)
+        {
+            reached = true;
+
+            const uint64_t one = 1;
+            [[maybe_unused]] ssize_t written =
+                ::write(eventFd, &one, sizeof(one));
+        }
+    }
+
+    const HostState target;
+    const int eventFd;
+    const int timerFd;
+    const int epollFd;
+
+    bool valid = true;
+    bool reached = false;
+
+    // last, so it is removed before the fds its callback uses are closed
+    sdbusplus::bus::match_t match;
+};
+
+} // namespace
+
 sdbusplus::async::task<bool> HostPower::setState(sdbusplus::async::context& ctx,
                                                  HostState state)
 {
@@ -53,6 +200,17 @@ sdbusplus::async::task<bool> HostPower::setState(sdbusplus::async::context& ctx,
                       .service(service)
                       .path(host0ObjectPath);
 
+    // subscribe before the transition is requested, so the state change
+    // cannot be missed
+    StateWaiter waiter(ctx, state);
+
+    if (!waiter.isValid())
+    {
+        error("Failed to create the fds to wait for state {STATE}", "STATE",
+              state);
+        co_return false;
+    }
+
     co_await client.requested_host_transition(
         (state == stateOn) ? transitionOn : transitionOff);
 
@@ -60,15 +218,15 @@ sdbusplus::async::task<bool> HostPower::setState(sdbusplus::async::context& ctx,
 
     constexpr size_t transitionTimeout = HOST_STATE_TRANSITION_TIMEOUT;
 
-    for (size_t i = 0; i < transitionTimeout; i++)
-    {
-        co_await sdbusplus::async::sleep_for(ctx, std::chrono::seconds(1));
+    // the host may have been in that state already
+    const bool success =
+        (co_await client.current_host_state()) == state ||
+        co_await waiter.wait(ctx, std::chrono::seconds(transitionTimeout));
 
-        if ((co_await client.current_host_state()) == state)
-        {
-            debug("Successfully achieved state {STATE}", "STATE", state);
-            co_return true;
-        }
+    if (success)
+    {
+        debug("Successfully achieved state {STATE}", "STATE", state);
+        co_return true;
     }
 
     error("Failed to achieve state {STATE} before the timeout of {TIMEOUT}s",
@@ -94,4 +252,173 @@ sdbusplus::async::task<HostState> HostPower::getState(
     co_return res;
 }
 
+// Marks the transition of a hold, also if it throws, and wakes the waiting
+// coroutines when it is done.
+struct HostOffHold::Transition
+{
+    explicit Transition(HostOffHold& hold) : hold(hold)
+    {
+        hold.transitioning = true;
+    }
+
+    ~Transition()
+    {
+        hold.transitioning = false;
+
+        const uint64_t one = 1;
+        for (const int fd : hold.waiters)
+        {
+            [[maybe_unused]] ssize_t written = ::write(fd, &one, sizeof(one));
+        }
+    }
+
+    Transition(const Transition&) = delete;
+    Transition& operator=(const Transition&) = delete;
+
+    HostOffHold& hold;
+};
+
+// An eventfd registered with the hold while a coroutine waits for the
+// transition, removed also if the coroutine is cancelled.
+struct HostOffHold::TransitionWaiter
+{
+    explicit TransitionWaiter(HostOffHold& hold) :
+        hold(hold), fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+    {
+        if (fd >= 0)
+        {
+            hold.waiters.push_back(fd);
+        }
+    }
+
+    ~TransitionWaiter()
+    {
+        if (fd >= 0)
+        {
+            std::erase(hold.waiters, fd);
+            ::close(fd);
+        }
+    }
+
+    TransitionWaiter(const TransitionWaiter&) = delete;
+    TransitionWaiter& operator=(const TransitionWaiter&) = delete;
+
+    HostOffHold& hold;
+    const int fd;
+};
+
+sdbusplus::async::task<bool> HostOffHold::waitForTransition()
+{
+    if (!transitioning)
+    {
+        co_return true;
+    }
+
+    TransitionWaiter waiter(*this);
+
+    if (waiter.fd < 0)
+    {
+        error("Failed to create an eventfd to wait for the host: {ERROR}",
+              "ERROR", strerror(errno));
+        co_return false;
+    }
+
+    sdbusplus::async::fdio fdio(ctx, waiter.fd);
+
+    // another waiter may have started the next transition before we resumed
+    while (transitioning)
+    {
+        co_await fdio.next();
+
+        uint64_t count = 0;
+        [[maybe_unused]] ssize_t consumed =
+            ::read(waiter.fd, &count, sizeof(count));
+    }
+
+    co_return true;
+}
+
+sdbusplus::async::task<bool> HostOffHold::acquire()
+{
+    co_return co_await hold(true);
+}
+
+sdbusplus::async::task<bool> HostOffHold::acquireIfOff()
+{
+    co_return co_await hold(false);
+}
+
+sdbusplus::async::task<bool> HostOffHold::hold(bool powerOff)
+{
+    if (!co_await waitForTransition())
+    {
+        co_return false;
+    }
+
+    // another update powered the host off already
+    if (holders++ > 0)
+    {
+        debug("Host is held off by {COUNT} updates", "COUNT", holders);
+        co_return true;
+    }
+
+    Transition transition(*this);
+
+    bool success = false;
+
+    try
+    {
+        previous = co_await HostPower::getState(ctx);
+
+        // nothing to request if the host is off already
+        success = previous == stateOff ||
+                  (powerOff && previous == stateOn &&
+                   co_await HostPower::setState(ctx, stateOff));
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to power off the host: {ERROR}", "ERROR", e);
+    }
+
+    if (!success)
+    {
+        holders--;
+    }
+
+    co_return success;
+}
+
+sdbusplus::async::task<bool> HostOffHold::release()
+{
+    if (holders == 0)
+    {
+        error("Host off hold released without being acquired");
+        co_return false;
+    }
+
+    if (--holders > 0)
+    {
+        debug("Host is still held off by {COUNT} updates", "COUNT", holders);
+        co_return true;
+    }
+
+    if (previous == stateOff)
+    {
+        co_return true;
+    }
+
+    Transition transition(*this);
+
+    try
+    {
+        co_return co_await HostPower::setState(ctx, previous);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to restore the host state: {ERROR}", "ERROR", e);
+    }
+
+    co_return false;
+}
+
 } // namespace phosphor::software::host_power
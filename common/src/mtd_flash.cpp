@@ -0,0 +1,507 @@
+#include "mtd_flash.hpp"
+
+#include "worker_pool.hpp"
+
+#include <fcntl.h>
+#include <mtd/mtd-user.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/async/fdio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+namespace phosphor::software::mtd
+{
+
+struct MTDFlash::Job
+{
+    Job(std::span<const uint8_t> image, size_t offset, size_t blockSize,
+        WriteMode mode) :
+        image(image), offset(offset), start(offset - offset % blockSize),
+        blockSize(blockSize),
+        blocks(image.empty() ? 0
+                             : (offset + image.size() - start + blockSize - 1) /
+                                   blockSize),
+        mode(mode), merged(blocks), unchanged(blocks, false),
+        eventFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+    {}
+
+    ~Job()
+    {
+        if (eventFd >= 0)
+        {
+            ::close(eventFd);
+        }
+    }
+
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+    Job(Job&&) = delete;
+    Job& operator=(Job&&) = delete;
+
+    // @returns        offset of 'block' on the flash
+    size_t blockOffset(size_t block) const
+    {
+        return start + block * blockSize;
+    }
+
+    // @returns        offset of the part of the image in 'block' on the flash
+    size_t dataOffset(size_t block) const
+    {
+        return std::max(blockOffset(block), offset);
+    }
+
+    // @returns        the part of the image which goes into 'block'
+    std::span<const uint8_t> blockData(size_t block) const
+    {
+        const size_t begin = dataOffset(block) - offset;
+        const size_t end =
+            std::min(blockOffset(block) + blockSize - offset, image.size());
+        return image.subspan(begin, end - begin);
+    }
+
+    // @returns        the content of 'block' once it is programmed
+    std::span<const uint8_t> expected(size_t block) const
+    {
+        return merged[block].empty() ? blockData(block) : merged[block];
+    }
+
+    // @brief          Wake the coroutine waiting on the eventfd.
+    void notify() const
+    {
+        // Writing to an eventfd only fails on counter overflow, which cannot
+        // happen with one write per block.
+        const uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = ::write(eventFd, &one, sizeof(one));
+    }
+
+    // @brief          Mark one of the workers as finished.
+    void finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running--;
+        }
+
+        cv.notify_all();
+        notify();
+    }
+
+    std::span<const uint8_t> image;
+    size_t offset;
+    // offset of the first block on the flash
+    size_t start;
+    size_t blockSize;
+    size_t blocks;
+    WriteMode mode;
+
+    // The whole content of the blocks which the image covers only partially,
+    // i.e. the image merged into what the flash held before. Written before
+    // the block counts as programmed.
+    std::vector<std::vector<uint8_t>> merged;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    // blocks which are programmed, guarded by 'mutex'
+    size_t programmed = 0;
+    // blocks which already held the image, guarded by 'mutex'
+    std::vector<bool> unchanged;
+    size_t unchangedBlocks = 0;
+
+    std::atomic<size_t> verifiedBytes = 0;
+    std::atomic<bool> failed = false;
+    // workers which have not finished yet, changed under 'mutex'
+    std::atomic<int> running = 2;
+
+    int eventFd;
+};
+
+MTDFlash::MTDFlash(int fd, std::string path, FlashInfo info, bool emulated,
+                   std::string lane) :
+    fd(fd), path(std::move(path)), flashInfo(info), emulated(emulated),
+    lane(lane.empty() ? this->path : std::move(lane))
+{}
+
+MTDFlash::~MTDFlash()
+{
+    ::close(fd);
+}
+
+std::unique_ptr<MTDFlash> MTDFlash::open(const std::string& path,
+                                         const std::string& lane)
+{
+    const int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error("Failed to open {PATH}: {ERROR}", "PATH", path, "ERROR",
+              strerror(errno));
+        return nullptr;
+    }
+
+    struct mtd_info_user mtdInfo{};
+
+    if (ioctl(fd, MEMGETINFO, &mtdInfo) < 0)
+    {
+        error("MEMGETINFO failed on {PATH}: {ERROR}", "PATH", path, "ERROR",
+              strerror(errno));
+        ::close(fd);
+        return nullptr;
+    }
+
+    if (mtdInfo.erasesize == 0 || (mtdInfo.flags & MTD_WRITEABLE) == 0)
+    {
+        error("{PATH} is not a writeable flash", "PATH", path);
+        ::close(fd);
+        return nullptr;
+    }
+
+    debug("{PATH}: {SIZE} bytes, erase block {ERASESIZE} bytes", "PATH", path,
+          "SIZE", mtdInfo.size, "ERASESIZE", mtdInfo.erasesize);
+
+    return std::unique_ptr<MTDFlash>(
+        new MTDFlash(fd, path, {mtdInfo.size, mtdInfo.erasesize}, false, lane));
+}
+
+std::unique_ptr<MTDFlash> MTDFlash::openFile(const std::string& path,
+                                             size_t eraseSize)
+{
+    const int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error("Failed to open {PATH}: {ERROR}", "PATH", path, "ERROR",
+              strerror(errno));
+        return nullptr;
+    }
+
+    struct stat st{};
+
+    // like an MTD device, the file consists of whole erase blocks
+    if (fstat(fd, &st) < 0 || eraseSize == 0 ||
+        static_cast<size_t>(st.st_size) % eraseSize != 0)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+
+    return std::unique_ptr<MTDFlash>(new MTDFlash(
+        fd, path, {static_cast<size_t>(st.st_size), eraseSize}, true, ""));
+}
+
+bool MTDFlash::erase(size_t offset) const
+{
+    if (emulated)
+    {
+        const std::vector<uint8_t> erased(flashInfo.eraseSize, 0xff);
+        return pwriteAll(erased, offset);
+    }
+
+    struct erase_info_user eraseInfo{};
+    eraseInfo.start = offset;
+    eraseInfo.length = flashInfo.eraseSize;
+
+    if (ioctl(fd, MEMERASE, &eraseInfo) < 0)
+    {
+        error("MEMERASE failed at {OFFSET}: {ERROR}", "OFFSET", offset,
+              "ERROR", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool MTDFlash::pwriteAll(std::span<const uint8_t> data, size_t offset) const
+{
+    while (!data.empty())
+    {
+        const ssize_t written = pwrite(fd, data.data(), data.size(), offset);
+
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (written <= 0)
+        {
+            error("Failed to write {SIZE} bytes at {OFFSET}: {ERROR}", "SIZE",
+                  data.size(), "OFFSET", offset, "ERROR", strerror(errno));
+            return false;
+        }
+
+        data = data.subspan(written);
+        offset += written;
+    }
+
+    return true;
+}
+
+bool MTDFlash::preadAll(std::span<uint8_t> data, size_t offset) const
+{
+    while (!data.empty())
+    {
+        const ssize_t nread = pread(fd, data.data(), data.size(), offset);
+
+        if (nread < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (nread <= 0)
+        {
+            error("Failed to read {SIZE} bytes at {OFFSET}: {ERROR}", "SIZE",
+                  data.size(), "OFFSET", offset, "ERROR", strerror(errno));
+            return false;
+        }
+
+        data = data.subspan(nread);
+        offset += nread;
+    }
+
+    return true;
+}
+
+bool MTDFlash::read(std::span<uint8_t> data, size_t offset) const
+{
+    if (offset + data.size() > flashInfo.size)
+    {
+        error("Cannot read {SIZE} bytes at {OFFSET} from {PATH}", "SIZE",
+              data.size(), "OFFSET", offset, "PATH", path);
+        return false;
+    }
+
+    return preadAll(data, offset);
+}
+
+bool MTDFlash::isProgrammed(std::span<const uint8_t> data, size_t offset,
+                            std::vector<uint8_t>& buffer) const
+{
+    buffer.resize(data.size());
+
+    // a block which cannot be read is simply programmed
+    return preadAll(buffer, offset) && std::ranges::equal(buffer, data);
+}
+
+bool MTDFlash::merge(Job& job, size_t block, bool& unchanged) const
+{
+    auto& content = job.merged[block];
+    content.resize(job.blockSize);
+
+    // the rest of the block is erased too, so it must be written back
+    if (!preadAll(content, job.blockOffset(block)))
+    {
+        return false;
+    }
+
+    const auto data = job.blockData(block);
+    const auto target = std::span<uint8_t>(content).subspan(
+        job.dataOffset(block) - job.blockOffset(block), data.size());
+
+    unchanged = job.mode == WriteMode::incremental &&
+                std::ranges::equal(target, data);
+
+    std::ranges::copy(data, target.begin());
+
+    return true;
+}
+
+void MTDFlash::program(Job& job) const
+{
+    std::vector<uint8_t> buffer;
+
+    for (size_t block = 0; block < job.blocks && !job.failed; block++)
+    {
+        const size_t offset = job.blockOffset(block);
+        const bool partial = job.blockData(block).size() < job.blockSize;
+
+        bool unchanged = false;
+        bool success = true;
+
+        if (partial)
+        {
+            success = merge(job, block, unchanged);
+        }
+        else
+        {
+            unchanged = job.mode == WriteMode::incremental &&
+                        isProgrammed(job.blockData(block), offset, buffer);
+        }
+
+        success = success &&
+                  (unchanged ||
+                   (erase(offset) && pwriteAll(job.expected(block), offset)));
+
+        {
+            // under the lock, so the verification thread cannot miss it
+            std::lock_guard<std::mutex> lock(job.mutex);
+            if (success)
+            {
+                job.programmed = block + 1;
+                job.unchanged[block] = unchanged;
+                job.unchangedBlocks += unchanged ? 1 : 0;
+            }
+            else
+            {
+                job.failed = true;
+            }
+        }
+
+        job.cv.notify_one();
+    }
+
+    job.finish();
+}
+
+void MTDFlash::verify(Job& job) const
+{
+    std::vector<uint8_t> buffer(job.blockSize);
+
+    for (size_t block = 0; block < job.blocks; block++)
+    {
+        bool unchanged = false;
+        {
+            std::unique_lock<std::mutex> lock(job.mutex);
+            job.cv.wait(lock, [&job, block] {
+                return job.failed || job.programmed > block;
+            });
+            unchanged = !job.failed && job.unchanged[block];
+        }
+
+        if (job.failed)
+        {
+            break;
+        }
+
+        // progress counts the bytes of the image only
+        const size_t dataSize = job.blockData(block).size();
+
+        // it was compared with the image just before
+        if (unchanged)
+        {
+            job.verifiedBytes += dataSize;
+            job.notify();
+            continue;
+        }
+
+        const auto expected = job.expected(block);
+        const auto actual = std::span<uint8_t>(buffer).first(expected.size());
+        const size_t offset = job.blockOffset(block);
+
+        if (!preadAll(actual, offset))
+        {
+            job.failed = true;
+            break;
+        }
+
+        if (!std::ranges::equal(actual, expected))
+        {
+            error("Verification failed for the erase block at {OFFSET}",
+                  "OFFSET", offset);
+            job.failed = true;
+            break;
+        }
+
+        job.verifiedBytes += dataSize;
+        job.notify();
+    }
+
+    job.finish();
+}
+
+sdbusplus::async::task<bool> MTDFlash::write(
+    sdbusplus::async::context& ctx, std::span<const uint8_t> image,
+    size_t offset, Progress progress, WriteMode mode)
+{
+    if (offset + image.size() > flashInfo.size)
+    {
+        error(
+            "Image of {SIZE} bytes at {OFFSET} does not fit {PATH} of {FLASHSIZE} bytes",
+            "SIZE", image.size(), "OFFSET", offset, "PATH", path, "FLASHSIZE",
+            flashInfo.size);
+        co_return false;
+    }
+
+    Job job(image, offset, flashInfo.eraseSize, mode);
+
+    if (job.eventFd < 0)
+    {
+        error("Failed to create eventfd to program {PATH}", "PATH", path);
+        co_return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    auto& pool = WorkerPool::instance();
+    pool.post(lane, [this, &job] { program(job); });
+    pool.post(lane + "/verify", [this, &job] { verify(job); });
+
+    // the workers reference 'job', so wait for them before it goes away
+    auto stop = [&job] {
+        std::unique_lock<std::mutex> lock(job.mutex);
+        job.failed = job.failed || job.running > 0;
+        job.cv.notify_all();
+        job.cv.wait(lock, [&job] { return job.running == 0; });
+    };
+
+    try
+    {
+        // The eventfd is level triggered, so a wake up which happens before
+        // we start waiting is not lost.
+        sdbusplus::async::fdio fdio(ctx, job.eventFd);
+
+        // each worker wakes us once more when it has finished
+        bool finished = false;
+        while (!finished)
+        {
+            co_await fdio.next();
+
+            uint64_t count = 0;
+            [[maybe_unused]] ssize_t nread =
+                ::read(job.eventFd, &count, sizeof(count));
+
+            finished = job.running == 0;
+
+            if (progress)
+            {
+                progress(job.verifiedBytes, image.size());
+            }
+        }
+    }
+    catch (...)
+    {
+        stop();
+        throw;
+    }
+
+    stop();
+
+    if (job.failed)
+    {
+        error("Failed to program {PATH} after {BYTES} verified bytes", "PATH",
+              path, "BYTES", job.verifiedBytes.load());
+        co_return false;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    info(
+        "Programmed and verified {SIZE} bytes on {PATH} in {TIME}ms, {CHANGED} of {BLOCKS} erase blocks changed",
+        "SIZE", image.size(), "PATH", path, "TIME", elapsed.count(), "CHANGED",
+        job.blocks - job.unchangedBlocks, "BLOCKS", job.blocks);
+
+    co_return true;
+}
+
+} // namespace phosphor::software::mtd
@@ -0,0 +1,281 @@
+#include "paged_verify.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+
+PHOSPHOR_LOG2_USING;
+
+namespace phosphor::software::paged
+{
+
+using Clock = std::chrono::steady_clock;
+
+static std::chrono::microseconds since(Clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - start);
+}
+
+PagedVerifier::PagedVerifier(std::span<const uint8_t> image, size_t pageSize,
+                             size_t pagesPerRead, size_t pagesPerSector) :
+    image(image), pageSize(std::max<size_t>(pageSize, 1)),
+    pagesPerRead(std::max<size_t>(pagesPerRead, 1)),
+    pagesPerSector(pagesPerSector),
+    imagePages((image.size() + this->pageSize - 1) / this->pageSize)
+{}
+
+void PagedVerifier::setProgramPage(ProgramPage program, ProgramBits bits)
+{
+    programPage = std::move(program);
+    programBits = bits;
+}
+
+void PagedVerifier::setEraseSector(EraseSector erase)
+{
+    eraseSector = std::move(erase);
+}
+
+std::span<const uint8_t> PagedVerifier::imagePage(size_t page) const
+{
+    const size_t offset = page * pageSize;
+
+    return image.subspan(offset, std::min(pageSize, image.size() - offset));
+}
+
+bool PagedVerifier::canProgramOver(std::span<const uint8_t> current,
+                                   std::span<const uint8_t> expected,
+                                   ProgramBits bits)
+{
+    if (bits == ProgramBits::unknown || current.size() < expected.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        // the bits which programming cannot change must already match
+        const uint8_t fixed = (bits == ProgramBits::clear)
+                                  ? (current[i] & expected[i])
+                                  : (current[i] | expected[i]);
+
+        if (fixed != expected[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+sdbusplus::async::task<bool> PagedVerifier::readBack(
+    ReadPages& read, const std::vector<size_t>& pages,
+    std::vector<std::pair<size_t, std::vector<uint8_t>>>& mismatched)
+{
+    std::vector<uint8_t> data;
+
+    for (size_t i = 0; i < pages.size();)
+    {
+        // read runs of consecutive pages at once
+        size_t count = 1;
+        while (i + count < pages.size() && count < pagesPerRead &&
+               pages[i + count] == pages[i] + count)
+        {
+            count++;
+        }
+
+        data.clear();
+
+        if (!co_await read(pages[i], count, data))
+        {
+            error("Failed to read back {COUNT} pages from page {PAGE}",
+                  "COUNT", count, "PAGE", pages[i]);
+            co_return false;
+        }
+
+        // the last page of the image may be shorter than a page
+        const size_t required =
+            (count - 1) * pageSize + imagePage(pages[i] + count - 1).size();
+
+        if (data.size() < required)
+        {
+            error("Read back {SIZE} bytes for {COUNT} pages", "SIZE",
+                  data.size(), "COUNT", count);
+            co_return false;
+        }
+
+        for (size_t j = 0; j < count; j++)
+        {
+            const size_t page = pages[i + j];
+            const auto expected = imagePage(page);
+            const auto actual =
+                std::span<const uint8_t>(data).subspan(j * pageSize,
+                                                       expected.size());
+
+            if (!std::ranges::equal(actual, expected))
+            {
+                mismatched.emplace_back(
+                    page, std::vector<uint8_t>(actual.begin(), actual.end()));
+            }
+        }
+
+        i += count;
+    }
+
+    co_return true;
+}
+
+sdbusplus::async::task<bool> PagedVerifier::repair(
+    const std::vector<std::pair<size_t, std::vector<uint8_t>>>& mismatched,
+    std::vector<size_t>& touched, VerifyReport& report)
+{
+    if (!programPage)
+    {
+        error("{COUNT} pages mismatch and cannot be reprogrammed", "COUNT",
+              mismatched.size());
+        co_return false;
+    }
+
+    std::set<size_t> sectors;
+
+    for (const auto& [page, current] : mismatched)
+    {
+        if (canProgramOver(current, imagePage(page), programBits))
+        {
+            continue;
+        }
+
+        if (!eraseSector || pagesPerSector == 0)
+        {
+            error("Page {PAGE} has to be erased, which is not supported",
+                  "PAGE", page);
+            co_return false;
+        }
+
+        sectors.insert(page / pagesPerSector);
+    }
+
+    for (const size_t sector : sectors)
+    {
+        debug("Rewriting sector {SECTOR}", "SECTOR", sector);
+
+        if (!co_await eraseSector(sector))
+        {
+            error("Failed to erase sector {SECTOR}", "SECTOR", sector);
+            co_return false;
+        }
+
+        const size_t end =
+            std::min((sector + 1) * pagesPerSector, imagePages);
+
+        for (size_t page = sector * pagesPerSector; page < end; page++)
+        {
+            if (!co_await programPage(page, imagePage(page)))
+            {
+                error("Failed to program page {PAGE}", "PAGE", page);
+                co_return false;
+            }
+
+            touched.push_back(page);
+        }
+
+        report.rewrittenSectors++;
+    }
+
+    for (const auto& [page, current] : mismatched)
+    {
+        if (pagesPerSector != 0 && sectors.contains(page / pagesPerSector))
+        {
+            continue;
+        }
+
+        debug("Reprogramming page {PAGE}", "PAGE", page);
+
+        if (!co_await programPage(page, imagePage(page)))
+        {
+            error("Failed to program page {PAGE}", "PAGE", page);
+            co_return false;
+        }
+
+        touched.push_back(page);
+        report.reprogrammedPages++;
+    }
+
+    std::ranges::sort(touched);
+
+    co_return true;
+}
+
+sdbusplus::async::task<bool> PagedVerifier::verify(
+    ReadPages read, size_t maxPasses, VerifyReport& report)
+{
+    report = VerifyReport{};
+    report.pages = pageCount();
+
+    std::vector<size_t> pages(pageCount());
+    std::iota(pages.begin(), pages.end(), 0);
+
+    std::vector<std::pair<size_t, std::vector<uint8_t>>> mismatched;
+    bool success = false;
+
+    for (size_t pass = 0; pass < std::max<size_t>(maxPasses, 1); pass++)
+    {
+        report.passes++;
+
+        mismatched.clear();
+
+        auto start = Clock::now();
+        const bool readOk = co_await readBack(read, pages, mismatched);
+        report.readTime += since(start);
+
+        if (!readOk)
+        {
+            break;
+        }
+
+        if (pass == 0)
+        {
+            for (const auto& [page, current] : mismatched)
+            {
+                report.mismatched.push_back(page);
+            }
+        }
+
+        if (mismatched.empty())
+        {
+            success = true;
+            break;
+        }
+
+        if (pass + 1 >= maxPasses)
+        {
+            error("{COUNT} pages still mismatch after {PASSES} passes",
+                  "COUNT", mismatched.size(), "PASSES", report.passes);
+            break;
+        }
+
+        pages.clear();
+
+        start = Clock::now();
+        const bool repaired = co_await repair(mismatched, pages, report);
+        report.repairTime += since(start);
+
+        if (!repaired)
+        {
+            break;
+        }
+    }
+
+    info(
+        "Verified {PAGES} pages: {MISMATCHED} mismatched, {REPROGRAMMED} reprogrammed, {SECTORS} sectors rewritten, read back {READ}us, repair {REPAIR}us",
+        "PAGES", report.pages, "MISMATCHED", report.mismatched.size(),
+        "REPROGRAMMED", report.reprogrammedPages, "SECTORS",
+        report.rewrittenSectors, "READ", report.readTime.count(), "REPAIR",
+        report.repairTime.count());
+
+    co_return success;
+}
+
+} // namespace phosphor::software::paged
@@ -0,0 +1,119 @@
+#include "progress_publisher.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <utility>
+
+PHOSPHOR_LOG2_USING;
+
+namespace phosphor::software
+{
+
+ProgressPublisher::ProgressPublisher(
+    std::function<void(uint8_t)> publish, std::chrono::milliseconds minInterval,
+    std::function<void(std::chrono::milliseconds)> scheduleFlush) :
+    publish(std::move(publish)), minInterval(minInterval),
+    scheduleFlush(std::move(scheduleFlush))
+{}
+
+bool ProgressPublisher::update(uint8_t progress)
+{
+    progress = std::min<uint8_t>(progress, 100);
+
+    if (published.has_value() && progress <= published.value())
+    {
+        return false;
+    }
+
+    const auto now = Clock::now();
+
+    if (!published.has_value() || progress == 100 ||
+        now - lastPublished >= minInterval)
+    {
+        publishNow(progress, now);
+        return true;
+    }
+
+    pending = progress;
+
+    if (scheduleFlush && !flushScheduled)
+    {
+        flushScheduled = true;
+        scheduleFlush(std::chrono::ceil<std::chrono::milliseconds>(
+            minInterval - (now - lastPublished)));
+    }
+
+    return false;
+}
+
+void ProgressPublisher::updateBytes(uint64_t done, uint64_t total)
+{
+    const auto now = Clock::now();
+
+    if (!bytesStart.has_value())
+    {
+        bytesStart = now;
+        bytesAtStart = done;
+    }
+
+    bytesDoneCount = done;
+    bytesTotalCount = total;
+    bytesLast = now;
+}
+
+void ProgressPublisher::flush()
+{
+    flushScheduled = false;
+
+    if (pending.has_value())
+    {
+        publishNow(pending.value(), Clock::now());
+    }
+}
+
+std::optional<std::chrono::seconds> ProgressPublisher::eta() const
+{
+    if (!bytesStart.has_value() || bytesDoneCount <= bytesAtStart ||
+        bytesTotalCount < bytesDoneCount)
+    {
+        return std::nullopt;
+    }
+
+    const double elapsed =
+        std::chrono::duration<double>(bytesLast - bytesStart.value()).count();
+
+    if (elapsed <= 0)
+    {
+        return std::nullopt;
+    }
+
+    const double rate = double(bytesDoneCount - bytesAtStart) / elapsed;
+    const double remaining = double(bytesTotalCount - bytesDoneCount) / rate;
+
+    return std::chrono::seconds(static_cast<int64_t>(remaining + 0.5));
+}
+
+void ProgressPublisher::publishNow(uint8_t progress, Clock::time_point now)
+{
+    published = progress;
+    pending.reset();
+    lastPublished = now;
+
+    publish(progress);
+
+    if (bytesTotalCount == 0)
+    {
+        debug("progress {PROGRESS}%", "PROGRESS", unsigned(progress));
+        return;
+    }
+
+    const auto remaining = eta();
+
+    debug("progress {PROGRESS}%, {DONE} of {TOTAL} bytes, {ETA}s remaining",
+          "PROGRESS", unsigned(progress), "DONE", bytesDoneCount, "TOTAL",
+          bytesTotalCount, "ETA",
+          remaining.has_value() ? remaining->count() : -1);
+}
+
+} // namespace phosphor::software
@@ -1,6 +1,7 @@
 #include "software.hpp"
 
 #include "device.hpp"
+#include "software_id.hpp"
 #include "software_update.hpp"
 
 #include <phosphor-logging/lg2.hpp>
@@ -37,18 +38,19 @@ Software::Software(sdbusplus::async::context& ctx, Device& parent,
           "OBJPATH", objectPath);
 };
 
-long int Software::getRandomId()
+Software::~Software()
 {
-    struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
-    unsigned int seed = ts.tv_nsec ^ getpid();
-    srandom(seed);
-    return random() % 10000;
+    SoftwareIdAllocator::instance().release(swid);
+}
+
+uint64_t Software::getRandomId()
+{
+    return SoftwareIdAllocator::instance().next();
 }
 
 std::string Software::getRandomSoftwareId(Device& parent)
 {
-    return std::format("{}_{}", parent.config.configName, getRandomId());
+    return SoftwareIdAllocator::instance().acquire(parent.config.configName);
 }
 
 sdbusplus::async::task<> Software::createInventoryAssociations(bool isRunning)
@@ -0,0 +1,69 @@
+#include "software_id.hpp"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <format>
+
+namespace phosphor::software
+{
+
+// the random suffix has this many decimal digits
+constexpr uint64_t suffixRange = 1'000'000'000;
+
+SoftwareIdAllocator& SoftwareIdAllocator::instance()
+{
+    static SoftwareIdAllocator allocator;
+    return allocator;
+}
+
+SoftwareIdAllocator::SoftwareIdAllocator()
+{
+    std::random_device rd;
+    std::seed_seq seed{
+        rd(), rd(), static_cast<unsigned int>(getpid()),
+        static_cast<unsigned int>(
+            std::chrono::steady_clock::now().time_since_epoch().count())};
+
+    prng.seed(seed);
+}
+
+uint64_t SoftwareIdAllocator::next()
+{
+    std::lock_guard lock(mutex);
+
+    counter++;
+
+    return counter * suffixRange + prng() % suffixRange;
+}
+
+std::string SoftwareIdAllocator::acquire(const std::string& prefix)
+{
+    while (true)
+    {
+        std::string swid = std::format("{}_{}", prefix, next());
+
+        std::lock_guard lock(mutex);
+
+        if (live.insert(swid).second)
+        {
+            return swid;
+        }
+    }
+}
+
+void SoftwareIdAllocator::release(const std::string& swid)
+{
+    std::lock_guard lock(mutex);
+
+    live.erase(swid);
+}
+
+bool SoftwareIdAllocator::inUse(const std::string& swid) const
+{
+    std::lock_guard lock(mutex);
+
+    return live.contains(swid);
+}
+
+} // namespace phosphor::software
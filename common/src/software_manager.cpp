@@ -1,10 +1,19 @@
 #include "software_manager.hpp"
 
+#include "common/pldm/pldm_package_util.hpp"
+#include "common_config.h"
+#include "config_cache.hpp"
+#include "host_power.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include <boost/container/flat_map.hpp>
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/asio/object_server.hpp>
 #include <sdbusplus/async.hpp>
 #include <sdbusplus/async/context.hpp>
+#include <sdbusplus/async/fdio.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
 #include <xyz/openbmc_project/Association/Definitions/server.hpp>
@@ -12,7 +21,12 @@
 #include <xyz/openbmc_project/Software/Version/client.hpp>
 #include <xyz/openbmc_project/State/Host/client.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <map>
+#include <variant>
 
 PHOSPHOR_LOG2_USING;
 
@@ -28,12 +42,18 @@ const auto matchRulePath = RulesIntf::path("/xyz/openbmc_project/inventory");
 
 SoftwareManager::SoftwareManager(sdbusplus::async::context& ctx,
                                  const std::string& serviceNameSuffix) :
-    ctx(ctx),
+    updateScheduler(ctx), hostOffHold(ctx), ctx(ctx),
     configIntfAddedMatch(ctx, RulesIntf::interfacesAdded() + matchRuleSender),
     configIntfRemovedMatch(ctx, RulesIntf::interfacesRemoved() + matchRulePath),
     serviceName("xyz.openbmc_project.Software." + serviceNameSuffix),
     manager(ctx, sdbusplus::client::xyz::openbmc_project::software::Version<>::
-                     namespace_path)
+                     namespace_path),
+    updateAllIntf(std::make_unique<update::ManagerUpdate>(
+        ctx,
+        sdbusplus::object_path(sdbusplus::client::xyz::openbmc_project::
+                                   software::Version<>::namespace_path) /
+            serviceNameSuffix,
+        *this))
 {
     debug("requesting dbus name {BUSNAME}", "BUSNAME", serviceName);
 
@@ -46,56 +66,123 @@ static sdbusplus::async::task<std::optional<SoftwareConfig>> getConfig(
     sdbusplus::async::context& ctx, const std::string& service,
     const std::string& objectPath, const std::string& interfacePrefix)
 {
-    auto client = sdbusplus::async::proxy()
-                      .service(service)
-                      .path(objectPath)
-                      .interface("org.freedesktop.DBus.Properties");
-
-    uint64_t vendorIANA = 0;
-    std::string compatible{};
-    std::string configType{};
-    std::string configName{};
+    auto& cache = ConfigCache::instance();
 
     const std::string interfaceName = interfacePrefix + ".FirmwareInfo";
 
-    try
+    auto vendorIANA = co_await cache.getProperty<uint64_t>(
+        ctx, service, objectPath, interfaceName, "VendorIANA");
+    auto compatible = co_await cache.getProperty<std::string>(
+        ctx, service, objectPath, interfaceName, "CompatibleHardware");
+    auto configType = co_await cache.getProperty<std::string>(
+        ctx, service, objectPath, interfacePrefix, "Type");
+    auto configName = co_await cache.getProperty<std::string>(
+        ctx, service, objectPath, interfacePrefix, "Name");
+
+    if (!vendorIANA.has_value() || !compatible.has_value() ||
+        !configType.has_value() || !configName.has_value())
     {
-        {
-            auto propVendorIANA = co_await client.call<std::variant<uint64_t>>(
-                ctx, "Get", interfaceName, "VendorIANA");
+        error("Failed to get config from {INTF} at {PATH}", "INTF",
+              interfacePrefix, "PATH", objectPath);
+        co_return std::nullopt;
+    }
 
-            vendorIANA = std::get<uint64_t>(propVendorIANA);
-        }
-        {
-            auto propCompatible =
-                co_await client.call<std::variant<std::string>>(
-                    ctx, "Get", interfaceName, "CompatibleHardware");
+    co_return SoftwareConfig(objectPath, vendorIANA.value(),
+                             compatible.value(), configType.value(),
+                             configName.value());
+}
 
-            compatible = std::get<std::string>(propCompatible);
-        }
-        {
-            auto propConfigType =
-                co_await client.call<std::variant<std::string>>(
-                    ctx, "Get", interfacePrefix, "Type");
+// Upper bound of devices which are initialized at the same time
+static constexpr size_t maxConcurrentInits = 8;
 
-            configType = std::get<std::string>(propConfigType);
-        }
+struct SoftwareManager::InitEntry
+{
+    std::string service;
+    sdbusplus::object_path path;
+    std::string interface;
+};
+
+// Work of one 'forEachConcurrently', shared by its workers
+struct SoftwareManager::InitBatch
+{
+    explicit InitBatch(size_t count,
+                       std::function<sdbusplus::async::task<>(size_t)> fn) :
+        count(count), fn(std::move(fn)),
+        eventFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+    {}
+
+    ~InitBatch()
+    {
+        if (eventFd >= 0)
         {
-            auto propConfigName =
-                co_await client.call<std::variant<std::string>>(
-                    ctx, "Get", interfacePrefix, "Name");
+            close(eventFd);
+        }
+    }
+
+    InitBatch(const InitBatch&) = delete;
+    InitBatch& operator=(const InitBatch&) = delete;
+    InitBatch(InitBatch&&) = delete;
+    InitBatch& operator=(InitBatch&&) = delete;
+
+    const size_t count;
+    std::function<sdbusplus::async::task<>(size_t)> fn;
+    size_t next = 0;
+    size_t workersRemaining = 0;
+    // written by the last worker to finish
+    const int eventFd;
+};
+
+sdbusplus::async::task<> SoftwareManager::initWorker(
+    std::shared_ptr<InitBatch> batch)
+{
+    while (batch->next < batch->count)
+    {
+        co_await batch->fn(batch->next++);
+    }
 
-            configName = std::get<std::string>(propConfigName);
+    if (--batch->workersRemaining == 0)
+    {
+        const uint64_t one = 1;
+        [[maybe_unused]] ssize_t written =
+            write(batch->eventFd, &one, sizeof(one));
+    }
+}
+
+sdbusplus::async::task<> SoftwareManager::forEachConcurrently(
+    size_t count, std::function<sdbusplus::async::task<>(size_t)> fn)
+{
+    auto batch = std::make_shared<InitBatch>(count, std::move(fn));
+
+    if (batch->eventFd < 0)
+    {
+        error("Failed to create an eventfd, initializing serially: {ERROR}",
+              "ERROR", strerror(errno));
+
+        for (size_t i = 0; i < count; i++)
+        {
+            co_await batch->fn(i);
         }
+        co_return;
     }
-    catch (std::exception& e)
+
+    const size_t workers = std::min(count, maxConcurrentInits);
+
+    if (workers == 0)
     {
-        error("Failed to get config with {ERROR}", "ERROR", e);
-        co_return std::nullopt;
+        co_return;
+    }
+
+    batch->workersRemaining = workers;
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        ctx.spawn(initWorker(batch));
     }
 
-    co_return SoftwareConfig(objectPath, vendorIANA, compatible, configType,
-                             configName);
+    // The eventfd is level triggered, so workers which finish before we
+    // start waiting are not missed.
+    sdbusplus::async::fdio fdio(ctx, batch->eventFd);
+    co_await fdio.next();
 }
 
 sdbusplus::async::task<> SoftwareManager::initDevices(
@@ -104,6 +191,12 @@ sdbusplus::async::task<> SoftwareManager::initDevices(
     ctx.spawn(interfaceAddedMatch(configurationInterfaces));
     ctx.spawn(interfaceRemovedMatch(configurationInterfaces));
 
+#ifdef STAGED_UPDATES
+    ctx.spawn(applyStagedUpdatesOnHostOff());
+#endif
+
+    const auto start = std::chrono::steady_clock::now();
+
     auto client = sdbusplus::client::xyz::openbmc_project::ObjectMapper<>(ctx)
                       .service("xyz.openbmc_project.ObjectMapper")
                       .path("/xyz/openbmc_project/object_mapper");
@@ -116,6 +209,8 @@ sdbusplus::async::task<> SoftwareManager::initDevices(
         debug("[config] looking for dbus interface {INTF}", "INTF", iface);
     }
 
+    auto entries = std::make_shared<std::vector<InitEntry>>();
+
     for (auto& [path, v] : res)
     {
         for (auto& [service, interfaceNames] : v)
@@ -138,13 +233,331 @@ sdbusplus::async::task<> SoftwareManager::initDevices(
                 continue;
             }
 
-            co_await handleInterfaceAdded(service, path, interfaceFound);
+            entries->push_back({service, path, interfaceFound});
         }
     }
 
+    // Fetch the configuration interfaces concurrently, each with one GetAll
+    // into the cache, which 'initDevice' reads from later. Devices which do
+    // not share a bus get a lane of their own.
+    auto entryLanes = std::make_shared<std::vector<std::string>>(
+        entries->size());
+
+    co_await forEachConcurrently(
+        entries->size(),
+        [this, entries, entryLanes](size_t i) -> sdbusplus::async::task<> {
+            const auto& entry = (*entries)[i];
+
+            auto bus = co_await ConfigCache::instance().getProperty<uint64_t>(
+                ctx, entry.service, entry.path, entry.interface, "Bus");
+
+            (*entryLanes)[i] = bus.has_value()
+                                   ? "i2c-" + std::to_string(bus.value())
+                                   : entry.path.str;
+        });
+
+    std::map<std::string, std::vector<InitEntry>> laneMap;
+
+    for (size_t i = 0; i < entries->size(); i++)
+    {
+        laneMap[(*entryLanes)[i]].push_back((*entries)[i]);
+    }
+
+    auto lanes = std::make_shared<std::vector<std::vector<InitEntry>>>();
+
+    for (auto& [_, lane] : laneMap)
+    {
+        lanes->push_back(std::move(lane));
+    }
+
+    debug("Initializing {COUNT} devices on {LANES} buses", "COUNT",
+          entries->size(), "LANES", lanes->size());
+
+    // devices on the same bus are initialized one after the other
+    co_await forEachConcurrently(
+        lanes->size(), [this, lanes](size_t i) -> sdbusplus::async::task<> {
+            for (auto& entry : (*lanes)[i])
+            {
+                co_await handleInterfaceAdded(entry.service, entry.path,
+                                              entry.interface);
+            }
+        });
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    info("Initialized {COUNT} of {TOTAL} devices in {MS} ms", "COUNT",
+         devices.size(), "TOTAL", entries->size(), "MS", elapsed.count());
+
     debug("Done with initial configuration");
 }
 
+// State shared by the device updates of one 'startUpdateAll'
+struct SoftwareManager::UpdateAll
+{
+    UpdateAll(int imageFd, RequestedApplyTimes applyTime,
+              std::function<void(uint8_t)> onProgress,
+              std::function<void(bool)> onDone) :
+        imageFd(imageFd), applyTime(applyTime),
+        onProgress(std::move(onProgress)), onDone(std::move(onDone))
+    {}
+
+    ~UpdateAll()
+    {
+        close(imageFd);
+    }
+
+    UpdateAll(const UpdateAll&) = delete;
+    UpdateAll& operator=(const UpdateAll&) = delete;
+    UpdateAll(UpdateAll&&) = delete;
+    UpdateAll& operator=(UpdateAll&&) = delete;
+
+    void setProgress(const Device* device, uint8_t value)
+    {
+        progress[device] = value;
+
+        unsigned sum = 0;
+        for (const auto& [_, p] : progress)
+        {
+            sum += p;
+        }
+
+        const uint8_t average = sum / progress.size();
+
+        if (average != lastProgress && onProgress)
+        {
+            onProgress(average);
+        }
+        lastProgress = average;
+    }
+
+    int imageFd;
+    RequestedApplyTimes applyTime;
+    std::function<void(uint8_t)> onProgress;
+    std::function<void(bool)> onDone;
+
+    // keeps the package index shared by the devices while they update
+    std::shared_ptr<const pldm_package_util::PackageIndex> packageIndex;
+
+    std::map<const Device*, uint8_t> progress;
+    uint8_t lastProgress = 0;
+
+    size_t remaining = 0;
+    size_t failed = 0;
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+};
+
+std::vector<sdbusplus::object_path> SoftwareManager::startUpdateAll(
+    sdbusplus::message::unix_fd image, RequestedApplyTimes applyTime,
+    std::function<void(uint8_t)> onProgress, std::function<void(bool)> onDone)
+{
+    std::vector<sdbusplus::object_path> paths;
+
+    auto packageIndex = pldm_package_util::PackageIndex::get(image);
+
+    if (packageIndex == nullptr)
+    {
+        error("could not parse PLDM package");
+        return paths;
+    }
+
+    const int imageDup = dup(image.fd);
+
+    if (imageDup < 0)
+    {
+        error("ERROR calling dup on fd: {ERR}", "ERR", strerror(errno));
+        return paths;
+    }
+
+    auto state = std::make_shared<UpdateAll>(
+        imageDup, applyTime, std::move(onProgress), std::move(onDone));
+    state->packageIndex = packageIndex;
+
+    std::vector<std::pair<Device*, std::unique_ptr<Software>>> updates;
+
+    for (auto& [path, device] : devices)
+    {
+        if (!packageIndex->matches(device->config.vendorIANA,
+                                   device->config.compatibleHardware))
+        {
+            continue;
+        }
+
+        if (device->updateInProgress)
+        {
+            error("An update is already in progress for {PATH}, skipping",
+                  "PATH", path);
+            continue;
+        }
+
+        if (!device->allowedApplyTimes.contains(applyTime))
+        {
+            error("the apply time {APPLYTIME} is not allowed by {PATH}",
+                  "APPLYTIME", applyTime, "PATH", path);
+            continue;
+        }
+
+        device->updateInProgress = true;
+
+        auto software = std::make_unique<Software>(ctx, *device);
+        software->setActivation(ActivationInterface::Activations::NotReady);
+        paths.push_back(software->objectPath);
+
+        UpdateAll* updateAll = state.get();
+        const Device* devicePtr = device.get();
+        state->progress[devicePtr] = 0;
+        device->progressListener = [updateAll, devicePtr](uint8_t progress) {
+            updateAll->setProgress(devicePtr, progress);
+        };
+
+        updates.emplace_back(device.get(), std::move(software));
+    }
+
+    info("Updating {COUNT} devices", "COUNT", paths.size());
+
+    state->remaining = updates.size();
+
+    for (auto& [device, software] : updates)
+    {
+        updateScheduler.submit(
+            device->config.configName, device->getUpdateResources(),
+            [this, state, device, software = std::move(software)]() mutable {
+                return updateOne(state, device, std::move(software));
+            },
+            device->getSharedUpdateResources());
+    }
+
+    return paths;
+}
+
+std::set<RequestedApplyTimes> SoftwareManager::getAllowedApplyTimes() const
+{
+    std::set<RequestedApplyTimes> applyTimes;
+
+    for (const auto& [_, device] : devices)
+    {
+        applyTimes.insert(device->allowedApplyTimes.begin(),
+                          device->allowedApplyTimes.end());
+    }
+
+    return applyTimes;
+}
+
+sdbusplus::async::task<> SoftwareManager::updateOne(
+    std::shared_ptr<UpdateAll> state, Device* device,
+    std::unique_ptr<Software> software)
+{
+    const bool success = co_await device->startUpdateAsync(
+        state->imageFd, state->applyTime, std::move(software));
+
+    device->progressListener = nullptr;
+
+    if (!success)
+    {
+        state->failed++;
+    }
+
+    // A failed device is done as well, its failure is reported by 'onDone'
+    state->setProgress(device, 100);
+
+    device->updateInProgress = false;
+
+    if (--state->remaining == 0)
+    {
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - state->start);
+
+        info("Updated {COUNT} devices, {FAILED} failed, in {MS} ms", "COUNT",
+             state->progress.size(), "FAILED", state->failed, "MS",
+             elapsed.count());
+
+        if (state->onDone)
+        {
+            state->onDone(state->failed == 0);
+        }
+    }
+}
+
+sdbusplus::async::task<> SoftwareManager::applyStagedUpdatesOnHostOff()
+{
+    host_power::HostPower hostPower(ctx);
+
+    while (!ctx.stop_requested())
+    {
+        auto [interfaceName, changedProperties] =
+            co_await hostPower.stateChangedMatch
+                .next<std::string, host_power::HostPropertiesChanged>();
+
+        auto it = changedProperties.find("CurrentHostState");
+
+        if (it == changedProperties.end())
+        {
+            continue;
+        }
+
+        const auto* hostState =
+            std::get_if<host_power::HostState>(&it->second);
+
+        if (hostState == nullptr || *hostState != host_power::stateOff)
+        {
+            continue;
+        }
+
+        // an update powered the host off and will power it on again
+        if (hostOffHold.held())
+        {
+            debug("Host is held off by an update, not applying staged updates");
+            continue;
+        }
+
+        for (auto& [path, device] : devices)
+        {
+            if (!device->hasStagedUpdate() || device->updateInProgress)
+            {
+                continue;
+            }
+
+            info("Host is off, applying the staged update of {PATH}", "PATH",
+                 path);
+
+            device->updateInProgress = true;
+
+            // The host power is claimed exclusively, so the staged update
+            // does not run between the acquire and the release of the hold
+            // by another update.
+            std::set<std::string> resources = device->getUpdateResources();
+            resources.insert(update::hostPowerResource);
+
+            Device* devicePtr = device.get();
+            updateScheduler.submit(
+                device->config.configName, std::move(resources),
+                [this, devicePtr]() { return applyStagedUpdate(devicePtr); });
+        }
+    }
+}
+
+sdbusplus::async::task<> SoftwareManager::applyStagedUpdate(Device* device)
+{
+    // Keep the host off while the update is applied. The host may have been
+    // powered on while the update was queued, it is not powered off for a
+    // staged update then.
+    if (co_await hostOffHold.acquireIfOff())
+    {
+        co_await device->applyStagedUpdate();
+
+        co_await hostOffHold.release();
+    }
+    else
+    {
+        error("Host is not off, keeping the staged update of {NAME}", "NAME",
+              device->config.configName);
+    }
+
+    device->updateInProgress = false;
+}
+
 std::string SoftwareManager::getBusName()
 {
     return serviceName;
@@ -207,12 +620,6 @@ sdbusplus::async::task<void> SoftwareManager::handleInterfaceAddedGuarded(
     co_return;
 }
 
-using BasicVariantType =
-    std::variant<std::vector<std::string>, std::string, int64_t, uint64_t,
-                 double, int32_t, uint32_t, int16_t, uint16_t, uint8_t, bool>;
-using InterfacesMap = boost::container::flat_map<std::string, BasicVariantType>;
-using ConfigMap = boost::container::flat_map<std::string, InterfacesMap>;
-
 sdbusplus::async::task<void> SoftwareManager::interfaceAddedMatch(
     std::vector<std::string> interfaces)
 {
@@ -224,6 +631,11 @@ sdbusplus::async::task<void> SoftwareManager::interfaceAddedMatch(
 
         auto& [objPath, interfacesMap] = nextResult;
 
+        for (const auto& [interface, properties] : interfacesMap)
+        {
+            ConfigCache::instance().update(objPath, interface, properties);
+        }
+
         for (auto& interface : interfaces)
         {
             if (interfacesMap.contains(interface))
@@ -251,6 +663,11 @@ sdbusplus::async::task<void> SoftwareManager::interfaceRemovedMatch(
 
         debug("detected interface removed on {PATH}", "PATH", objPath);
 
+        for (const auto& interface : interfacesRemoved)
+        {
+            ConfigCache::instance().remove(objPath, interface);
+        }
+
         for (auto& interface : interfaces)
         {
             if (std::ranges::find(interfacesRemoved, interface) !=
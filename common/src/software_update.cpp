@@ -2,6 +2,7 @@
 
 #include "device.hpp"
 #include "software.hpp"
+#include "software_manager.hpp"
 
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/elog.hpp>
@@ -89,15 +90,15 @@ auto SoftwareUpdate::method_call(start_update_t /*unused*/, auto image,
 
     std::string newObjPath = softwareInstance->objectPath;
 
-    ctx.spawn(
-        [](Device& device, int imageDup, RequestedApplyTimes applyTime,
-           std::unique_ptr<Software> swupdate) -> sdbusplus::async::task<> {
-            co_await device.startUpdateAsync(imageDup, applyTime,
-                                             std::move(swupdate));
-            device.updateInProgress = false;
-            close(imageDup);
-            co_return;
-        }(device, imageDup, applyTime, std::move(softwareInstance)));
+    // Waits in the queue while another device holds one of the resources
+    // the update needs, e.g. a shared bus or the host power state.
+    device.parent->updateScheduler.submit(
+        device.config.configName, device.getUpdateResources(),
+        [&device, imageDup, applyTime,
+         swupdate = std::move(softwareInstance)]() mutable {
+            return runUpdate(device, imageDup, applyTime, std::move(swupdate));
+        },
+        device.getSharedUpdateResources());
 
     // We need the object path for the new software here.
     // It must be the same as constructed during the update process.
@@ -106,7 +107,114 @@ auto SoftwareUpdate::method_call(start_update_t /*unused*/, auto image,
     co_return newObjPath;
 }
 
+sdbusplus::async::task<> SoftwareUpdate::runUpdate(
+    Device& device, int imageDup, RequestedApplyTimes applyTime,
+    std::unique_ptr<Software> swupdate)
+{
+    co_await device.startUpdateAsync(imageDup, applyTime, std::move(swupdate));
+    device.updateInProgress = false;
+    close(imageDup);
+    co_return;
+}
+
 auto SoftwareUpdate::get_property(allowed_apply_times_t /*unused*/) const
 {
     return allowedApplyTimes;
 }
+
+ManagerUpdate::ManagerUpdate(sdbusplus::async::context& ctx,
+                             const sdbusplus::object_path& path,
+                             manager::SoftwareManager& manager) :
+    sdbusplus::aserver::xyz::openbmc_project::software::Update<ManagerUpdate>(
+        ctx, path),
+    ctx(ctx), path(path), manager(manager)
+{
+    emit_added();
+}
+
+ManagerUpdate::~ManagerUpdate()
+{
+    emit_removed();
+}
+
+auto ManagerUpdate::method_call(start_update_t /*unused*/, auto image,
+                                auto applyTime)
+    -> sdbusplus::async::task<start_update_t::return_type>
+{
+    debug("Requesting update of all devices with {FD}", "FD", image.fd);
+
+    if (updateInProgress)
+    {
+        error("An update of all devices is already in progress.");
+        elog<Unavailable>();
+    }
+
+    updateInProgress = true;
+
+    activationProgress = std::make_unique<
+        sdbusplus::aserver::xyz::openbmc_project::software::ActivationProgress<
+            ManagerUpdate>>(ctx, path.str.c_str(),
+                            sdbusplus::common::xyz::openbmc_project::software::
+                                ActivationProgress::properties_t{0});
+    activationProgress->emit_added();
+
+    using ActivationIntf =
+        sdbusplus::common::xyz::openbmc_project::software::Activation;
+
+    activation = std::make_unique<sdbusplus::aserver::xyz::openbmc_project::
+                                      software::Activation<ManagerUpdate>>(
+        ctx, path.str.c_str(),
+        ActivationIntf::properties_t{
+            ActivationIntf::Activations::Activating,
+            ActivationIntf::RequestedActivations::Active});
+    activation->emit_added();
+
+    auto paths = manager.startUpdateAll(
+        image, applyTime, [this](uint8_t progress) { setProgress(progress); },
+        [this](bool success) { setDone(success); });
+
+    if (paths.empty())
+    {
+        error("No device can be updated with the package");
+        updateInProgress = false;
+        activationProgress = nullptr;
+        activation = nullptr;
+        using Argument =
+            phosphor::logging::xyz::openbmc_project::common::InvalidArgument;
+        elog<sdbusplus::xyz::openbmc_project::Common::Error::InvalidArgument>(
+            Argument::ARGUMENT_NAME("Image"),
+            Argument::ARGUMENT_VALUE("no matching device"));
+    }
+
+    info("Started the update of {COUNT} devices", "COUNT", paths.size());
+
+    co_return path;
+}
+
+auto ManagerUpdate::get_property(allowed_apply_times_t /*unused*/) const
+{
+    return manager.getAllowedApplyTimes();
+}
+
+void ManagerUpdate::setProgress(uint8_t progress)
+{
+    if (activationProgress)
+    {
+        activationProgress->progress(progress);
+    }
+}
+
+void ManagerUpdate::setDone(bool success)
+{
+    using ActivationIntf =
+        sdbusplus::common::xyz::openbmc_project::software::Activation;
+
+    if (activation)
+    {
+        activation->activation(success
+                                   ? ActivationIntf::Activations::Active
+                                   : ActivationIntf::Activations::Failed);
+    }
+
+    updateInProgress = false;
+}
@@ -0,0 +1,174 @@
+#include "uevent_waiter.hpp"
+
+#include <linux/netlink.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/async/fdio.hpp>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+PHOSPHOR_LOG2_USING;
+
+namespace phosphor::software
+{
+
+// interval for checking the condition without uevents
+constexpr auto pollInterval = std::chrono::milliseconds(100);
+
+static int openUeventSocket()
+{
+    const int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                          NETLINK_KOBJECT_UEVENT);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct sockaddr_nl addr{};
+    addr.nl_family = AF_NETLINK;
+    // the kernel multicast group, before udev processing
+    addr.nl_groups = 1;
+
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static bool epollAdd(int epollFd, int fd)
+{
+    struct epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+UeventWaiter::UeventWaiter(sdbusplus::async::context& ctx, bool uevents) :
+    ctx(ctx), ueventFd(uevents ? openUeventSocket() : -1),
+    timerFd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)),
+    epollFd(epoll_create1(EPOLL_CLOEXEC))
+{
+    if (uevents && ueventFd < 0)
+    {
+        warning("Failed to open uevent socket, polling instead: {ERROR}",
+                "ERROR", strerror(errno));
+    }
+
+    if (epollFd >= 0 && ueventFd >= 0 && !epollAdd(epollFd, ueventFd))
+    {
+        ::close(ueventFd);
+        ueventFd = -1;
+    }
+
+    if (epollFd >= 0 && timerFd >= 0 && !epollAdd(epollFd, timerFd))
+    {
+        ::close(epollFd);
+        epollFd = -1;
+    }
+}
+
+UeventWaiter::~UeventWaiter()
+{
+    for (const int fd : {ueventFd, timerFd, epollFd})
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+}
+
+void UeventWaiter::drain() const
+{
+    std::array<char, 4096> buffer{};
+
+    // the content does not matter, the condition is checked on sysfs
+    while (ueventFd >= 0 &&
+           recv(ueventFd, buffer.data(), buffer.size(), 0) > 0)
+    {}
+
+    uint64_t expirations = 0;
+    [[maybe_unused]] ssize_t nread =
+        ::read(timerFd, &expirations, sizeof(expirations));
+}
+
+sdbusplus::async::task<bool> UeventWaiter::poll(
+    std::function<bool()>& condition,
+    std::chrono::steady_clock::time_point deadline)
+{
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        co_await sdbusplus::async::sleep_for(ctx, pollInterval);
+
+        if (condition())
+        {
+            co_return true;
+        }
+    }
+
+    co_return false;
+}
+
+sdbusplus::async::task<bool> UeventWaiter::waitFor(
+    std::function<bool()> condition, std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    if (condition())
+    {
+        co_return true;
+    }
+
+    if (timerFd < 0 || epollFd < 0)
+    {
+        co_return co_await poll(condition, deadline);
+    }
+
+    // Without uevents, the timer fires periodically to poll the condition.
+    // With uevents, it only bounds the wait.
+    const auto interval = (ueventFd < 0) ? pollInterval : timeout;
+
+    struct itimerspec spec{};
+    spec.it_value.tv_sec = interval.count() / 1000;
+    spec.it_value.tv_nsec = (interval.count() % 1000) * 1000000;
+    if (ueventFd < 0)
+    {
+        spec.it_interval = spec.it_value;
+    }
+
+    if (timerfd_settime(timerFd, 0, &spec, nullptr) < 0)
+    {
+        error("Failed to arm timer: {ERROR}", "ERROR", strerror(errno));
+        co_return co_await poll(condition, deadline);
+    }
+
+    sdbusplus::async::fdio fdio(ctx, epollFd);
+
+    bool reached = false;
+
+    while (!reached && std::chrono::steady_clock::now() < deadline)
+    {
+        co_await fdio.next();
+
+        drain();
+
+        reached = condition();
+    }
+
+    spec = {};
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+
+    co_return reached;
+}
+
+} // namespace phosphor::software
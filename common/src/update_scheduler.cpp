@@ -0,0 +1,113 @@
+#include "update_scheduler.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+namespace phosphor::software::update
+{
+
+std::string gpioResource(const std::string& line)
+{
+    return "gpio-" + line;
+}
+
+bool UpdateScheduler::submit(const std::string& name,
+                             std::set<std::string> resources, job_t job,
+                             std::set<std::string> shared)
+{
+    const uint64_t id = nextId++;
+
+    pending.push_back(
+        {id, name, std::move(resources), std::move(shared), std::move(job)});
+
+    schedule();
+
+    const bool started = std::ranges::none_of(
+        pending, [id](const Job& job) { return job.id == id; });
+
+    if (!started)
+    {
+        info("Queued update of {NAME}, {RUNNING} running, {QUEUED} queued",
+             "NAME", name, "RUNNING", active, "QUEUED", pending.size());
+    }
+
+    return started;
+}
+
+void UpdateScheduler::schedule()
+{
+    // resources of the jobs which keep waiting, later jobs must not take them
+    std::set<std::string> reserved;
+    // resources the waiting jobs claim shared, later jobs may only share them
+    std::set<std::string> reservedShared;
+    std::vector<Job> ready;
+
+    for (auto it = pending.begin(); it != pending.end();)
+    {
+        const bool free =
+            std::ranges::none_of(it->resources,
+                                 [&](const std::string& resource) {
+                                     return busy.contains(resource) ||
+                                            sharedBusy.contains(resource) ||
+                                            reserved.contains(resource) ||
+                                            reservedShared.contains(resource);
+                                 }) &&
+            std::ranges::none_of(it->shared, [&](const std::string& resource) {
+                return busy.contains(resource) || reserved.contains(resource);
+            });
+
+        if (!free)
+        {
+            reserved.insert(it->resources.begin(), it->resources.end());
+            reservedShared.insert(it->shared.begin(), it->shared.end());
+            it++;
+            continue;
+        }
+
+        busy.insert(it->resources.begin(), it->resources.end());
+        for (const auto& resource : it->shared)
+        {
+            sharedBusy[resource]++;
+        }
+        active++;
+
+        ready.push_back(std::move(*it));
+        it = pending.erase(it);
+    }
+
+    for (auto& job : ready)
+    {
+        debug("Starting update of {NAME}", "NAME", job.name);
+
+        ctx.spawn(run(std::move(job)));
+    }
+}
+
+sdbusplus::async::task<> UpdateScheduler::run(Job job)
+{
+    co_await job.job();
+
+    for (const auto& resource : job.resources)
+    {
+        busy.erase(resource);
+    }
+
+    for (const auto& resource : job.shared)
+    {
+        if (--sharedBusy[resource] == 0)
+        {
+            sharedBusy.erase(resource);
+        }
+    }
+
+    active--;
+
+    schedule();
+}
+
+} // namespace phosphor::software::update
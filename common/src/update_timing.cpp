@@ -0,0 +1,152 @@
+#include "update_timing.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <utility>
+
+PHOSPHOR_LOG2_USING;
+
+namespace phosphor::software::timing
+{
+
+UpdateTimeline::UpdateTimeline(std::string version) :
+    started(std::chrono::system_clock::now()), version(std::move(version))
+{}
+
+void UpdateTimeline::begin(std::string_view name)
+{
+    end(subStage);
+    end(stage);
+
+    stages.push_back({std::string(name), {}});
+    stage = OpenStage{stages.size() - 1, Clock::now()};
+}
+
+void UpdateTimeline::mark(std::string_view name)
+{
+    end(subStage);
+
+    std::string qualified(name);
+
+    if (stage.has_value())
+    {
+        qualified = stages[stage->index].name + "." + qualified;
+    }
+
+    stages.push_back({std::move(qualified), {}});
+    subStage = OpenStage{stages.size() - 1, Clock::now()};
+}
+
+void UpdateTimeline::finish(bool succeeded)
+{
+    end(subStage);
+    end(stage);
+
+    success = succeeded;
+}
+
+void UpdateTimeline::end(std::optional<OpenStage>& open)
+{
+    if (!open.has_value())
+    {
+        return;
+    }
+
+    stages[open->index].duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - open->start);
+
+    open.reset();
+}
+
+UpdateTimingHistory::UpdateTimingHistory(std::string path, size_t capacity) :
+    path(std::move(path)), capacity(capacity)
+{}
+
+void UpdateTimingHistory::add(UpdateTimeline timeline)
+{
+    std::chrono::microseconds total{0};
+
+    for (const auto& stage : timeline.stages)
+    {
+        debug("update to {VERSION}: {STAGE} took {US} us", "VERSION",
+              timeline.version, "STAGE", stage.name, "US",
+              stage.duration.count());
+
+        // sub-stages are part of their stage
+        if (stage.name.find('.') == std::string::npos)
+        {
+            total += stage.duration;
+        }
+    }
+
+    info("update to {VERSION} {RESULT} after {MS} ms", "VERSION",
+         timeline.version, "RESULT",
+         timeline.success ? "succeeded" : "failed", "MS",
+         std::chrono::duration_cast<std::chrono::milliseconds>(total).count());
+
+    history.push_back(std::move(timeline));
+
+    while (history.size() > capacity)
+    {
+        history.pop_front();
+    }
+
+    if (!path.empty())
+    {
+        dumpToFile();
+    }
+}
+
+std::string UpdateTimingHistory::dump() const
+{
+    std::string out;
+
+    for (const auto& timeline : history)
+    {
+        const auto started =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                timeline.started.time_since_epoch());
+
+        out += std::format("update to {} started {} ms since epoch: {}\n",
+                           timeline.version, started.count(),
+                           timeline.success ? "succeeded" : "failed");
+
+        for (const auto& stage : timeline.stages)
+        {
+            out += std::format("  {} {}us\n", stage.name,
+                               stage.duration.count());
+        }
+    }
+
+    return out;
+}
+
+bool UpdateTimingHistory::dumpToFile() const
+{
+    const std::string tmpPath = path + ".tmp";
+
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        file << dump();
+        if (!file)
+        {
+            error("Failed to write update timings to {PATH}", "PATH",
+                  tmpPath);
+            return false;
+        }
+    }
+
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        error("Failed to move update timings to {PATH}", "PATH", path);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace phosphor::software::timing
@@ -0,0 +1,75 @@
+#include "worker_pool.hpp"
+
+namespace phosphor::software
+{
+
+WorkerPool& WorkerPool::instance()
+{
+    static WorkerPool pool;
+    return pool;
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    for (auto& [_, lane] : laneMap)
+    {
+        lane->cv.notify_all();
+        if (lane->thread.joinable())
+        {
+            lane->thread.join();
+        }
+    }
+}
+
+void WorkerPool::post(const std::string& lane, std::function<void()> work)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto& entry = laneMap[lane];
+    if (!entry)
+    {
+        entry = std::make_unique<Lane>();
+        entry->thread = std::thread(&WorkerPool::run, this, std::ref(*entry));
+    }
+
+    entry->pending.push_back(std::move(work));
+    entry->cv.notify_one();
+}
+
+size_t WorkerPool::lanes()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return laneMap.size();
+}
+
+void WorkerPool::run(Lane& lane)
+{
+    while (true)
+    {
+        std::function<void()> work;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            lane.cv.wait(lock, [this, &lane] {
+                return stopping || !lane.pending.empty();
+            });
+
+            if (stopping)
+            {
+                return;
+            }
+
+            work = std::move(lane.pending.front());
+            lane.pending.pop_front();
+        }
+
+        work();
+    }
+}
+
+} // namespace phosphor::software
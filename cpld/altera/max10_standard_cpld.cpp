@@ -66,7 +66,7 @@ Max10StandardCPLD::Max10StandardCPLD(
     const std::string& chip, const std::string& configType,
     const Max10Profile& profile) :
     ctx(ctx), bus(bus), address(address), chip(chip), configType(configType),
-    profile(profile)
+    profile(profile), backend(phosphor::i2c::Backend::installed())
 {
     openDevice();
 }
@@ -78,7 +78,7 @@ Max10StandardCPLD::~Max10StandardCPLD()
 
 bool Max10StandardCPLD::openDevice()
 {
-    if (fd >= 0)
+    if (fd >= 0 || backend)
     {
         return true;
     }
@@ -111,10 +111,29 @@ void Max10StandardCPLD::closeDevice()
     }
 }
 
+bool Max10StandardCPLD::isOpen() const
+{
+    return fd >= 0 || backend;
+}
+
+bool Max10StandardCPLD::transfer(struct i2c_msg* msgs, uint32_t nmsgs) const
+{
+    if (backend)
+    {
+        return backend->transfer(bus, msgs, nmsgs);
+    }
+
+    struct i2c_rdwr_ioctl_data msgSet = {};
+    msgSet.msgs = msgs;
+    msgSet.nmsgs = nmsgs;
+
+    return ioctl(fd, I2C_RDWR, &msgSet) >= 0;
+}
+
 sdbusplus::async::task<bool> Max10StandardCPLD::readReg(uint32_t reg,
                                                         uint32_t& value)
 {
-    if (fd < 0)
+    if (!isOpen())
     {
         co_return false;
     }
@@ -138,14 +157,10 @@ sdbusplus::async::task<bool> Max10StandardCPLD::readReg(uint32_t reg,
     msgs[1].len = dataBuf.size();
     msgs[1].buf = dataBuf.data();
 
-    struct i2c_rdwr_ioctl_data msgSet = {};
-    msgSet.msgs = msgs;
-    msgSet.nmsgs = 2;
-
     int retry = maxRetry;
     while (retry--)
     {
-        if (ioctl(fd, I2C_RDWR, &msgSet) >= 0)
+        if (transfer(msgs, 2))
         {
             if (profile.littleEndian)
             {
@@ -170,7 +185,7 @@ sdbusplus::async::task<bool> Max10StandardCPLD::readReg(uint32_t reg,
 sdbusplus::async::task<bool> Max10StandardCPLD::writeReg(uint32_t reg,
                                                          uint32_t value)
 {
-    if (fd < 0)
+    if (!isOpen())
     {
         co_return false;
     }
@@ -202,14 +217,10 @@ sdbusplus::async::task<bool> Max10StandardCPLD::writeReg(uint32_t reg,
     msg.len = data.size();
     msg.buf = data.data();
 
-    struct i2c_rdwr_ioctl_data msgSet = {};
-    msgSet.msgs = &msg;
-    msgSet.nmsgs = 1;
-
     int retry = maxRetry;
     while (retry--)
     {
-        if (ioctl(fd, I2C_RDWR, &msgSet) >= 0)
+        if (transfer(&msg, 1))
         {
             // Give bridge time to process write using async sleep
             co_await sdbusplus::async::sleep_for(ctx, delayWrite);
@@ -540,7 +551,7 @@ sdbusplus::async::task<bool> Max10StandardCPLD::updateFirmware(
         co_return false;
     }
 
-    if (fd < 0)
+    if (!isOpen())
     {
         co_return false;
     }
@@ -555,7 +566,7 @@ sdbusplus::async::task<bool> Max10StandardCPLD::getVersion(std::string& version)
     constexpr uint32_t versionReg = 0x00100028;
     constexpr size_t versionBufSize = 16;
 
-    if (fd < 0)
+    if (!isOpen())
     {
         co_return false;
     }
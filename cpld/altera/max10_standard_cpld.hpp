@@ -1,10 +1,12 @@
 #pragma once
+#include "common/include/i2c/i2c_backend.hpp"
 #include "cpld/altera/max10_base_cpld.hpp"
 
 #include <sdbusplus/async.hpp>
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 
@@ -58,6 +60,14 @@ class Max10StandardCPLD
     bool openDevice();
     void closeDevice();
 
+    // @returns   true if the device file is open or a backend is installed
+    bool isOpen() const;
+
+    // @brief     Issue 'msgs' as one I2C_RDWR transfer, or hand them to the
+    //            installed backend, e.g. the simulator of the benchmarks.
+    // @returns   true on success, errno is set on ioctl failures
+    bool transfer(struct i2c_msg* msgs, uint32_t nmsgs) const;
+
     // All hardware I/O and polling functions converted to async tasks
     sdbusplus::async::task<bool> readReg(uint32_t reg, uint32_t& value);
     sdbusplus::async::task<bool> writeReg(uint32_t reg, uint32_t value);
@@ -85,6 +95,7 @@ class Max10StandardCPLD
     std::string configType;
     Max10Profile profile{};
     int fd = -1;
+    std::shared_ptr<phosphor::i2c::Backend> backend;
 };
 
 } // namespace phosphor::software::cpld
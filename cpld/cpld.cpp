@@ -1,5 +1,6 @@
 #include "cpld.hpp"
 
+#include "common/include/update_scheduler.hpp"
 #include "common/include/utils.hpp"
 
 namespace phosphor::software::cpld
@@ -23,6 +24,23 @@ std::optional<ScopedBmcMux> CPLDDevice::setupMux()
     }
 }
 
+std::optional<std::string> CPLDDevice::getUpdateBus() const
+{
+    return "i2c-" + std::to_string(bus);
+}
+
+std::set<std::string> CPLDDevice::getUpdateResources() const
+{
+    std::set<std::string> resources = Device::getUpdateResources();
+
+    for (const auto& line : muxGPIOs.getLines())
+    {
+        resources.insert(update::gpioResource(line));
+    }
+
+    return resources;
+}
+
 sdbusplus::async::task<bool> CPLDDevice::updateDevice(const uint8_t* image,
                                                       size_t image_size)
 {
@@ -54,6 +72,32 @@ sdbusplus::async::task<bool> CPLDDevice::updateDevice(const uint8_t* image,
     co_return true;
 }
 
+sdbusplus::async::task<bool> CPLDDevice::isImageProgrammed(
+    const ComponentReader& component)
+{
+    if (cpldInterface == nullptr)
+    {
+        co_return false;
+    }
+
+    std::vector<uint8_t> image;
+
+    if (!component.readAll(image))
+    {
+        co_return false;
+    }
+
+    auto guard = setupMux();
+    if (muxGPIOs.hasGPIOs() && !guard.has_value())
+    {
+        lg2::error("Failed to compare CPLD image: unable to acquire mux");
+        co_return false;
+    }
+
+    co_return co_await cpldInterface->isImageRunning(image.data(),
+                                                     image.size());
+}
+
 sdbusplus::async::task<bool> CPLDDevice::getVersion(std::string& version)
 {
     if (cpldInterface == nullptr)
@@ -28,18 +28,27 @@ class CPLDDevice : public Device
                {RequestedApplyTimes::Immediate, RequestedApplyTimes::OnReset}),
         cpldInterface(CPLDFactory::instance().create(chiptype, ctx, chipname,
                                                      bus, address)),
-        muxGPIOs(gpioLinesIn, gpioValuesIn)
+        muxGPIOs(gpioLinesIn, gpioValuesIn), bus(bus)
     {}
 
     using Device::softwareCurrent;
     sdbusplus::async::task<bool> updateDevice(const uint8_t* image,
                                               size_t image_size) final;
     sdbusplus::async::task<bool> getVersion(std::string& version);
+    std::optional<std::string> getUpdateBus() const final;
+
+    std::set<std::string> getUpdateResources() const final;
 
   private:
+    // Compares the usercode of the image with the one the CPLD runs, if
+    // enabled with 'cpld-usercode-skip'.
+    sdbusplus::async::task<bool> isImageProgrammed(
+        const ComponentReader& component) final;
+
     std::optional<ScopedBmcMux> setupMux();
     std::unique_ptr<CPLDInterface> cpldInterface;
     GPIOGroup muxGPIOs;
+    uint16_t bus;
 };
 
 } // namespace phosphor::software::cpld
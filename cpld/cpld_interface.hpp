@@ -30,6 +30,15 @@ class CPLDInterface
 
     virtual sdbusplus::async::task<bool> getVersion(std::string& version) = 0;
 
+    // @brief Compares the image with the configuration the CPLD is running.
+    // @returns true if the CPLD already runs 'image', false if it differs or
+    //          the comparison is not supported.
+    virtual sdbusplus::async::task<bool> isImageRunning(
+        const uint8_t* /*image*/, size_t /*imageSize*/)
+    {
+        co_return false;
+    }
+
   protected:
     sdbusplus::async::context& ctx;
     std::string chipname;
@@ -1,11 +1,16 @@
 #include "cpld_software_manager.hpp"
 
+#include "common/common_config.h"
 #include "common/include/dbus_helper.hpp"
+#include "common/include/i2c/i2c_scheduler.hpp"
+#include "common/include/i2c/i2c_trace.hpp"
 #include "cpld.hpp"
 
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/async.hpp>
 
+#include <string_view>
+
 PHOSPHOR_LOG2_USING;
 
 using namespace phosphor::software::cpld;
@@ -107,6 +112,15 @@ void CPLDSoftwareManager::start()
         configIntfs.push_back("xyz.openbmc_project.Configuration." + config);
     }
 
+    // Queue I2C transfers per bus and run them off the event loop
+    phosphor::i2c::I2CScheduler::instance().attach(ctx);
+
+    if (!std::string_view(I2C_TRACE_DIR).empty())
+    {
+        phosphor::i2c::I2CTrace::instance().enable(
+            ctx, std::string(I2C_TRACE_DIR) + "/cpld-i2c-trace.txt");
+    }
+
     ctx.spawn(initDevices(configIntfs));
     ctx.run();
 }
@@ -1,15 +1,24 @@
 #include "lattice_base_cpld.hpp"
 
+#include "common/common_config.h"
+
 #include <algorithm>
 #include <cstddef>
 #include <fstream>
 #include <map>
 #include <numeric>
+#include <optional>
 #include <vector>
 
 namespace phosphor::software::cpld
 {
 
+#ifdef CPLD_USERCODE_SKIP
+constexpr bool userCodeSkip = true;
+#else
+constexpr bool userCodeSkip = false;
+#endif
+
 constexpr uint8_t busyWaitMaxRetry = 77; // according to max erase cfg time
 constexpr uint8_t busyFlagBit = 0x80;
 
@@ -37,6 +46,48 @@ static uint8_t reverse_bit(uint8_t b)
     return b;
 }
 
+// Extracts the usercode from a JED image, without parsing the fuse data.
+static std::optional<uint32_t> parseUserCode(const uint8_t* image,
+                                             size_t imageSize)
+{
+    std::string content(reinterpret_cast<const char*>(image), imageSize);
+    std::istringstream iss(content);
+    std::string line;
+    bool inUserCode = false;
+
+    while (getline(iss, line))
+    {
+        if (line.starts_with(tagUserCode))
+        {
+            inUserCode = true;
+            continue;
+        }
+
+        if (!inUserCode || !line.starts_with(tagUserCodeHex))
+        {
+            continue;
+        }
+
+        const size_t end = line.find('*');
+        if (end == std::string::npos || end <= tagUserCodeHex.length())
+        {
+            return std::nullopt;
+        }
+
+        uint32_t userCode = 0;
+        std::istringstream hex(line.substr(tagUserCodeHex.length(),
+                                           end - tagUserCodeHex.length()));
+        if (!(hex >> std::hex >> userCode))
+        {
+            return std::nullopt;
+        }
+
+        return userCode;
+    }
+
+    return std::nullopt;
+}
+
 std::string LatticeBaseCPLD::uint32ToHexStr(uint32_t value)
 {
     std::ostringstream oss;
@@ -302,8 +353,8 @@ bool LatticeBaseCPLD::verifyChecksum()
 
 sdbusplus::async::task<bool> LatticeBaseCPLD::enableProgramMode()
 {
-    std::vector<uint8_t> request = {commandEnableConfigMode, 0x08, 0x0, 0x0};
-    std::vector<uint8_t> response;
+    phosphor::i2c::Frame request = {commandEnableConfigMode, 0x08, 0x0, 0x0};
+    phosphor::i2c::Frame response;
 
     if (!i2cInterface.sendReceive(request, response))
     {
@@ -322,8 +373,8 @@ sdbusplus::async::task<bool> LatticeBaseCPLD::enableProgramMode()
 
 sdbusplus::async::task<bool> LatticeBaseCPLD::resetConfigFlash()
 {
-    std::vector<uint8_t> request;
-    std::vector<uint8_t> response;
+    phosphor::i2c::Frame request;
+    phosphor::i2c::Frame response;
     if (isLCMXO3D)
     {
         /*
@@ -374,8 +425,8 @@ sdbusplus::async::task<bool> LatticeBaseCPLD::resetConfigFlash()
 
 sdbusplus::async::task<bool> LatticeBaseCPLD::programDone()
 {
-    std::vector<uint8_t> request = {commandProgramDone, 0x0, 0x0, 0x0};
-    std::vector<uint8_t> response;
+    phosphor::i2c::Frame request = {commandProgramDone, 0x0, 0x0, 0x0};
+    phosphor::i2c::Frame response;
 
     if (!i2cInterface.sendReceive(request, response))
     {
@@ -394,8 +445,8 @@ sdbusplus::async::task<bool> LatticeBaseCPLD::programDone()
 
 sdbusplus::async::task<bool> LatticeBaseCPLD::disableConfigInterface()
 {
-    std::vector<uint8_t> request = {commandDisableConfigInterface, 0x0, 0x0};
-    std::vector<uint8_t> response;
+    phosphor::i2c::Frame request = {commandDisableConfigInterface, 0x0, 0x0};
+    phosphor::i2c::Frame response;
     co_return i2cInterface.sendReceive(request, response);
 }
 
@@ -454,8 +505,8 @@ sdbusplus::async::task<bool> LatticeBaseCPLD::waitBusyAndVerify()
 sdbusplus::async::task<bool> LatticeBaseCPLD::readBusyFlag(uint8_t& busyFlag)
 {
     constexpr size_t resSize = 1;
-    std::vector<uint8_t> request = {commandReadBusyFlag, 0x0, 0x0, 0x0};
-    std::vector<uint8_t> response(resSize, 0);
+    phosphor::i2c::Frame request = {commandReadBusyFlag, 0x0, 0x0, 0x0};
+    phosphor::i2c::Frame response(resSize, 0);
 
     auto success = i2cInterface.sendReceive(request, response);
     if (!success && response.size() != resSize)
@@ -468,8 +519,8 @@ sdbusplus::async::task<bool> LatticeBaseCPLD::readBusyFlag(uint8_t& busyFlag)
 
 sdbusplus::async::task<bool> LatticeBaseCPLD::readStatusReg(uint8_t& statusReg)
 {
-    std::vector<uint8_t> request = {commandReadStatusReg, 0x0, 0x0, 0x0};
-    std::vector<uint8_t> response(4, 0);
+    phosphor::i2c::Frame request = {commandReadStatusReg, 0x0, 0x0, 0x0};
+    phosphor::i2c::Frame response(4, 0);
 
     if (!i2cInterface.sendReceive(request, response))
     {
@@ -554,4 +605,34 @@ sdbusplus::async::task<bool> LatticeBaseCPLD::getVersion(std::string& version)
     co_return true;
 }
 
+sdbusplus::async::task<bool> LatticeBaseCPLD::isImageRunning(
+    const uint8_t* image, size_t imageSize)
+{
+    // The usercode is whatever the bitstream was built with, it does not
+    // necessarily change with the configuration, see 'cpld-usercode-skip'.
+    if (!userCodeSkip || image == nullptr || imageSize == 0)
+    {
+        co_return false;
+    }
+
+    const auto imageUserCode = parseUserCode(image, imageSize);
+    if (!imageUserCode.has_value() || *imageUserCode == 0)
+    {
+        lg2::debug("No usercode in the image to compare with.");
+        co_return false;
+    }
+
+    uint32_t userCode = 0;
+    if (!(co_await readUserCode(userCode)))
+    {
+        lg2::error("Read usercode failed.");
+        co_return false;
+    }
+
+    lg2::debug("Usercode of CPLD: {DEVICE}, of image: {IMAGE}", "DEVICE",
+               lg2::hex, userCode, "IMAGE", lg2::hex, *imageUserCode);
+
+    co_return userCode == *imageUserCode;
+}
+
 } // namespace phosphor::software::cpld
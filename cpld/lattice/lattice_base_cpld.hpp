@@ -1,4 +1,5 @@
 #pragma once
+#include "common/include/i2c/frame.hpp"
 #include "common/include/i2c/i2c.hpp"
 
 #include <phosphor-logging/lg2.hpp>
@@ -172,6 +173,12 @@ class LatticeBaseCPLD
 
     sdbusplus::async::task<bool> getVersion(std::string& version);
 
+    // @brief Compares the usercode of the JED image with the usercode of
+    //        the running configuration, with 'cpld-usercode-skip' only.
+    // @returns true if they match
+    sdbusplus::async::task<bool> isImageRunning(const uint8_t* image,
+                                                size_t imageSize);
+
   protected:
     sdbusplus::async::context& ctx;
     cpldI2cInfo fwInfo{};
@@ -97,6 +97,18 @@ sdbusplus::async::task<bool> LatticeCPLDFactory::getVersion(
     co_return co_await cpldManager->getVersion(version);
 }
 
+sdbusplus::async::task<bool> LatticeCPLDFactory::isImageRunning(
+    const uint8_t* image, size_t imageSize)
+{
+    auto cpldManager = getLatticeCPLD("");
+    if (cpldManager == nullptr)
+    {
+        lg2::error("CPLD manager is not initialized.");
+        co_return false;
+    }
+    co_return co_await cpldManager->isImageRunning(image, imageSize);
+}
+
 } // namespace phosphor::software::cpld
 
 // Factory function to create lattice CPLD device
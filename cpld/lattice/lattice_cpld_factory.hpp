@@ -19,6 +19,9 @@ class LatticeCPLDFactory : public CPLDInterface
 
     sdbusplus::async::task<bool> getVersion(std::string& version) final;
 
+    sdbusplus::async::task<bool> isImageRunning(const uint8_t* image,
+                                                size_t imageSize) final;
+
   private:
     std::unique_ptr<LatticeBaseCPLD> getLatticeCPLD(const std::string& target);
     latticeChip chipEnum;
@@ -1,17 +1,28 @@
 #include "lattice_xo3_cpld.hpp"
 
+#include "common/include/paged_verify.hpp"
+
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <span>
 #include <vector>
 
 namespace phosphor::software::cpld
 {
+namespace
+{
+constexpr size_t pageSize = 16;
+// Pages read back with one read page command, which auto-increments the page
+// address. 128 bytes fit the transfer buffers of common I2C controllers.
+constexpr size_t verifyPagesPerRead = 8;
+} // namespace
 
 sdbusplus::async::task<bool> LatticeXO3CPLD::readDeviceId()
 {
-    std::vector<uint8_t> request = {commandReadDeviceId, 0x0, 0x0, 0x0};
-    std::vector<uint8_t> response = {0, 0, 0, 0};
+    phosphor::i2c::Frame request = {commandReadDeviceId, 0x0, 0x0, 0x0};
+    phosphor::i2c::Frame response = {0, 0, 0, 0};
 
     if (!i2cInterface.sendReceive(request, response))
     {
@@ -29,7 +40,7 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::readDeviceId()
         });
 
     if (chipWantToUpdate != supportedDeviceMap.end() &&
-        chipWantToUpdate->second.deviceId == response)
+        std::ranges::equal(chipWantToUpdate->second.deviceId, response))
     {
         if (chip.rfind("LCMXO3D", 0) == 0)
         {
@@ -52,8 +63,8 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::readDeviceId()
 
 sdbusplus::async::task<bool> LatticeXO3CPLD::eraseFlash()
 {
-    std::vector<uint8_t> request;
-    std::vector<uint8_t> response;
+    phosphor::i2c::Frame request;
+    phosphor::i2c::Frame response;
 
     if (isLCMXO3D)
     {
@@ -118,50 +129,54 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::writeProgramPage()
     used to program the NVCM0/CFG or
     NVCM1/UFM.
     */
-    size_t iterSize = 16;
+    const size_t maxWriteRetry = 10;
 
-    for (size_t i = 0; (i * iterSize) < fwInfo.cfgData.size(); i++)
+    for (size_t i = 0; (i * pageSize) < fwInfo.cfgData.size(); i++)
     {
-        size_t byteOffset = i * iterSize;
+        size_t byteOffset = i * pageSize;
         double progressRate =
             ((double(byteOffset) / double(fwInfo.cfgData.size())) * 100);
         std::cout << "Update :" << std::fixed << std::dec
                   << std::setprecision(2) << progressRate << "% \r";
 
-        uint8_t len = ((byteOffset + iterSize) < fwInfo.cfgData.size())
-                          ? iterSize
+        uint8_t len = ((byteOffset + pageSize) < fwInfo.cfgData.size())
+                          ? pageSize
                           : (fwInfo.cfgData.size() - byteOffset);
-        auto pageData = std::vector<uint8_t>(
-            fwInfo.cfgData.begin() + static_cast<std::ptrdiff_t>(byteOffset),
-            fwInfo.cfgData.begin() +
-                static_cast<std::ptrdiff_t>(byteOffset + len));
+        auto pageData = std::span<const uint8_t>(fwInfo.cfgData)
+                            .subspan(byteOffset, len);
 
         size_t retry = 0;
-        const size_t maxWriteRetry = 10;
-        while (retry < maxWriteRetry)
+        while (retry < maxWriteRetry &&
+               !(co_await programSinglePage(i, pageData)))
         {
-            if (!(co_await programSinglePage(i, pageData)))
-            {
-                retry++;
-                continue;
-            }
-
-            if (!(co_await verifySinglePage(i, pageData)))
-            {
-                retry++;
-                continue;
-            }
-
-            break;
+            retry++;
         }
 
         if (retry >= maxWriteRetry)
         {
-            lg2::error("Program and verify page failed");
+            lg2::error("Program page failed");
             co_return false;
         }
     }
 
+    // Verify all pages once programmed. The config flash can only be erased
+    // as a whole, and the MachXO2/XO3 programming documentation does not
+    // cover programming a page again without erasing it, so a mismatching
+    // page fails the verification instead of being repaired.
+    paged::PagedVerifier verifier(fwInfo.cfgData, pageSize, verifyPagesPerRead,
+                                  0);
+
+    paged::VerifyReport report;
+    if (!(co_await verifier.verify(
+            [this](size_t first, size_t count, std::vector<uint8_t>& data) {
+                return readPages(first, count, data);
+            },
+            1, report)))
+    {
+        lg2::error("Verify pages failed");
+        co_return false;
+    }
+
     if (!(co_await waitBusyAndVerify()))
     {
         lg2::error("Wait busy and verify fail");
@@ -174,10 +189,11 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::writeProgramPage()
 sdbusplus::async::task<bool> LatticeXO3CPLD::readUserCode(uint32_t& userCode)
 {
     constexpr size_t resSize = 4;
-    std::vector<uint8_t> request = {commandReadFwVersion, 0x0, 0x0, 0x0};
-    std::vector<uint8_t> response(resSize, 0);
+    phosphor::i2c::Frame request = {commandReadFwVersion, 0x0, 0x0, 0x0};
+    phosphor::i2c::Frame response(resSize, 0);
 
-    if (!i2cInterface.sendReceive(request, response))
+    if (!i2cInterface.sendReceive(request, response,
+                                   phosphor::i2c::Priority::high))
     {
         lg2::error("Failed to send read user code request.");
         co_return false;
@@ -192,8 +208,8 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::readUserCode(uint32_t& userCode)
 
 sdbusplus::async::task<bool> LatticeXO3CPLD::programUserCode()
 {
-    std::vector<uint8_t> request = {commandProgramUserCode, 0x0, 0x0, 0x0};
-    std::vector<uint8_t> response;
+    phosphor::i2c::Frame request = {commandProgramUserCode, 0x0, 0x0, 0x0};
+    phosphor::i2c::Frame response;
     for (int i = 3; i >= 0; i--)
     {
         request.push_back((fwInfo.version >> (i * 8)) & 0xFF);
@@ -306,15 +322,16 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::programSinglePage(
     uint16_t pageOffset, std::span<const uint8_t> pageData)
 {
     // Set Page Offset
-    std::vector<uint8_t> emptyResp(0);
-    std::vector<uint8_t> setPageAddrCmd = {
+    phosphor::i2c::Frame emptyResp;
+    phosphor::i2c::Frame setPageAddrCmd = {
         commandSetPageAddress, 0x0, 0x0, 0x0, 0x00, 0x00, 0x00, 0x00};
     setPageAddrCmd[6] = static_cast<uint8_t>(pageOffset >> 8); // high byte
     setPageAddrCmd[7] = static_cast<uint8_t>(pageOffset);      // low byte
 
     // NOLINTNEXTLINE(clang-analyzer-core.uninitialized.Branch)
     bool success = co_await i2cInterface.sendReceive(
-        setPageAddrCmd.data(), setPageAddrCmd.size(), nullptr, 0);
+        setPageAddrCmd.data(), setPageAddrCmd.size(), nullptr, 0,
+        phosphor::i2c::Priority::bulk);
     if (!success)
     {
         lg2::error("Write page address failed");
@@ -323,11 +340,12 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::programSinglePage(
 
     // Write Page Data
     constexpr uint8_t pageCount = 1;
-    std::vector<uint8_t> writeCmd = {commandProgramPage, 0x0, 0x0, pageCount};
+    phosphor::i2c::Frame writeCmd = {commandProgramPage, 0x0, 0x0, pageCount};
     writeCmd.insert(writeCmd.end(), pageData.begin(), pageData.end());
 
-    success = co_await i2cInterface.sendReceive(writeCmd.data(),
-                                                writeCmd.size(), nullptr, 0);
+    success = co_await i2cInterface.sendReceive(
+        writeCmd.data(), writeCmd.size(), nullptr, 0,
+        phosphor::i2c::Priority::bulk);
     if (!success)
     {
         lg2::error("Write page data failed");
@@ -345,12 +363,12 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::programSinglePage(
     co_return true;
 }
 
-sdbusplus::async::task<bool> LatticeXO3CPLD::verifySinglePage(
-    uint16_t pageOffset, std::span<const uint8_t> pageData)
+sdbusplus::async::task<bool> LatticeXO3CPLD::readPages(
+    uint16_t pageOffset, size_t pageCount, std::vector<uint8_t>& pageData)
 {
     // Set Page Offset
-    std::vector<uint8_t> emptyResp(0);
-    std::vector<uint8_t> setPageAddrCmd = {
+    phosphor::i2c::Frame emptyResp;
+    phosphor::i2c::Frame setPageAddrCmd = {
         commandSetPageAddress, 0x0, 0x0, 0x0, 0x00, 0x00, 0x00, 0x00};
     setPageAddrCmd[6] = static_cast<uint8_t>(pageOffset >> 8); // high byte
     setPageAddrCmd[7] = static_cast<uint8_t>(pageOffset);      // low byte
@@ -361,10 +379,11 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::verifySinglePage(
         co_return false;
     }
 
-    // Read Page Data
-    constexpr uint8_t pageCount = 1;
-    std::vector<uint8_t> readData(pageData.size());
-    std::vector<uint8_t> readCmd = {commandReadPage, 0x0, 0x0, pageCount};
+    // Read Page Data, the last two operand bytes hold the page count
+    phosphor::i2c::Frame readData(pageCount * pageSize, 0);
+    phosphor::i2c::Frame readCmd = {commandReadPage, 0x0,
+                                    static_cast<uint8_t>(pageCount >> 8),
+                                    static_cast<uint8_t>(pageCount)};
 
     if (!i2cInterface.sendReceive(readCmd, readData))
     {
@@ -372,16 +391,7 @@ sdbusplus::async::task<bool> LatticeXO3CPLD::verifySinglePage(
         co_return false;
     }
 
-    constexpr size_t pageSize = 16;
-    auto mismatch_pair =
-        std::mismatch(pageData.begin(), pageData.end(), readData.begin());
-    if (mismatch_pair.first != pageData.end())
-    {
-        size_t idx = std::distance(pageData.begin(), mismatch_pair.first);
-        lg2::error("Verify failed at {INDEX}", "INDEX",
-                   ((static_cast<size_t>(pageSize * pageOffset)) + idx));
-        co_return false;
-    }
+    pageData.assign(readData.begin(), readData.end());
 
     co_return true;
 }
@@ -32,8 +32,9 @@ class LatticeXO3CPLD : public LatticeBaseCPLD
     sdbusplus::async::task<bool> programUserCode();
     sdbusplus::async::task<bool> programSinglePage(
         uint16_t pageOffset, std::span<const uint8_t> pageData);
-    sdbusplus::async::task<bool> verifySinglePage(
-        uint16_t pageOffset, std::span<const uint8_t> pageData);
+    sdbusplus::async::task<bool> readPages(uint16_t pageOffset,
+                                           size_t pageCount,
+                                           std::vector<uint8_t>& pageData);
 };
 
 } // namespace phosphor::software::cpld
@@ -1,5 +1,7 @@
 #include "lattice_xo5_standard_cpld.hpp"
 
+#include "common/include/paged_verify.hpp"
+
 #include <phosphor-logging/lg2.hpp>
 
 namespace phosphor::software::cpld
@@ -43,6 +45,28 @@ bool getStartBlock(uint8_t cfg, uint8_t& startBlock)
     return true;
 }
 
+sdbusplus::async::task<bool> LatticeXO5StandardCPLD::eraseBlock(uint8_t block)
+{
+    std::vector<uint8_t> request;
+    std::vector<uint8_t> response = {};
+    request.reserve(4);
+    request.push_back(static_cast<uint8_t>(xo5Cmd::sectorErase));
+    request.push_back(block);
+    request.push_back(0x0);
+    request.push_back(0x0);
+    if (!i2cInterface.sendReceive(request, response))
+    {
+        lg2::error("Erase failed: Block {BLOCK}", "BLOCK", block);
+        co_return false;
+    }
+    if (!(co_await waitUntilReady(readyTimeout)))
+    {
+        lg2::error("Failed to wait until ready");
+        co_return false;
+    }
+    co_return true;
+}
+
 sdbusplus::async::task<bool> LatticeXO5StandardCPLD::eraseCfg(
     [[maybe_unused]] std::optional<uint8_t> setIdx)
 {
@@ -55,32 +79,10 @@ sdbusplus::async::task<bool> LatticeXO5StandardCPLD::eraseCfg(
     }
     const auto endBlock = startBlock + xo5Cfg::blocksPerCfg;
 
-    auto eraseBlock = [this](uint8_t block) -> sdbusplus::async::task<bool> {
-        std::vector<uint8_t> request;
-        std::vector<uint8_t> response = {};
-        request.reserve(4);
-        request.push_back(static_cast<uint8_t>(xo5Cmd::sectorErase));
-        request.push_back(block);
-        request.push_back(0x0);
-        request.push_back(0x0);
-        if (!i2cInterface.sendReceive(request, response))
-        {
-            lg2::error("Failed to erase block");
-            co_return false;
-        }
-        co_return true;
-    };
-
     for (size_t block = startBlock; block < endBlock; ++block)
     {
         if (!(co_await eraseBlock(block)))
         {
-            lg2::error("Erase failed: Block {BLOCK}", "BLOCK", block);
-            co_return false;
-        }
-        if (!(co_await waitUntilReady(readyTimeout)))
-        {
-            lg2::error("Failed to wait until ready");
             co_return false;
         }
     }
@@ -197,75 +199,80 @@ sdbusplus::async::task<bool> LatticeXO5StandardCPLD::readPage(
     co_return data[0] == static_cast<uint8_t>(xo5Status::ready);
 }
 
-sdbusplus::async::task<bool> LatticeXO5StandardCPLD::verifyCfg()
+sdbusplus::async::task<bool> LatticeXO5StandardCPLD::programCfgPage(
+    uint8_t startBlock, size_t page, std::span<const uint8_t> data)
 {
-    using diff_t = std::vector<uint8_t>::difference_type;
+    const auto block = startBlock + page / xo5Cfg::pagesPerBlock;
+    const auto blockPage = page % xo5Cfg::pagesPerBlock;
 
-    auto cfgIndex = getCfgIdx(target);
-    uint8_t startBlock;
-    if (!getStartBlock(cfgIndex, startBlock))
+    if (!(co_await programPage(block, blockPage,
+                               std::vector<uint8_t>(data.begin(), data.end()))))
     {
-        lg2::error("Error: invalid cfg index.");
+        lg2::error("Failed to program block {BLOCK} page {PAGE}", "BLOCK",
+                   block, "PAGE", blockPage);
         co_return false;
     }
-    const auto endBlock = startBlock + xo5Cfg::blocksPerCfg;
-    const auto& cfgData = fwInfo.cfgData;
-    const auto totalBytes = cfgData.size();
-    uint8_t readBuffer[1 + xo5Cfg::pageSize];
-    size_t bytesVerified = 0;
-
-    for (size_t block = startBlock; block < endBlock; ++block)
-    {
-        for (size_t page = 0; page < xo5Cfg::pagesPerBlock; ++page)
-        {
-            if (bytesVerified >= totalBytes)
-            {
-                co_return true;
-            }
+    co_await sdbusplus::async::sleep_for(ctx, readyPollInterval);
+    co_return co_await waitUntilReady(readyTimeout);
+}
 
-            auto offset = static_cast<diff_t>(bytesVerified);
-            auto remaining = static_cast<diff_t>(totalBytes - bytesVerified);
-            const auto chunkSize =
-                std::min(static_cast<diff_t>(xo5Cfg::pageSize), remaining);
+sdbusplus::async::task<bool> LatticeXO5StandardCPLD::readCfgPages(
+    uint8_t startBlock, size_t page, size_t count, std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> readVec;
 
-            std::vector<uint8_t> expected(
-                std::next(cfgData.begin(), offset),
-                std::next(cfgData.begin(), offset + chunkSize));
+    for (size_t i = page; i < page + count; ++i)
+    {
+        const auto block = startBlock + i / xo5Cfg::pagesPerBlock;
+        const auto blockPage = i % xo5Cfg::pagesPerBlock;
 
-            std::vector<uint8_t> chunk;
-            {
-                std::vector<uint8_t> readVec(readBuffer,
-                                             readBuffer + 1 + chunkSize);
-
-                if (co_await readPage(block, page, readVec))
-                {
-                    chunk.assign(readVec.begin() + 1, readVec.end());
-                }
-                else
-                {
-                    chunk.clear();
-                }
-            }
+        // the first byte is the status
+        readVec.assign(1 + xo5Cfg::pageSize, 0);
 
-            if (chunk.empty())
-            {
-                lg2::error("Failed to read Block {BLOCK} Page {PAGE}", "BLOCK",
-                           block, "PAGE", page);
-                co_return false;
-            }
-            if (!std::equal(chunk.begin(), chunk.end(), expected.begin()))
-            {
-                lg2::error("VERIFY FAILED: Block {BLOCK} Page {PAGE}", "BLOCK",
-                           block, "PAGE", page);
-                co_return false;
-            }
-
-            bytesVerified += chunkSize;
+        if (!(co_await readPage(block, blockPage, readVec)))
+        {
+            lg2::error("Failed to read Block {BLOCK} Page {PAGE}", "BLOCK",
+                       block, "PAGE", blockPage);
+            co_return false;
         }
+        data.insert(data.end(), readVec.begin() + 1, readVec.end());
     }
     co_return true;
 }
 
+sdbusplus::async::task<bool> LatticeXO5StandardCPLD::verifyCfg()
+{
+    auto cfgIndex = getCfgIdx(target);
+    uint8_t startBlock;
+    if (!getStartBlock(cfgIndex, startBlock))
+    {
+        lg2::error("Error: invalid cfg index.");
+        co_return false;
+    }
+
+    // The block of a page which does not match is erased and programmed
+    // again, instead of the whole cfg. Without a known bit polarity, pages
+    // are not programmed again in place.
+    paged::PagedVerifier verifier(fwInfo.cfgData, xo5Cfg::pageSize, 1,
+                                  xo5Cfg::pagesPerBlock);
+    verifier.setProgramPage(
+        [this, startBlock](size_t page, std::span<const uint8_t> data) {
+            return programCfgPage(startBlock, page, data);
+        },
+        paged::ProgramBits::unknown);
+    verifier.setEraseSector([this, startBlock](size_t sector) {
+        return eraseBlock(startBlock + sector);
+    });
+
+    paged::VerifyReport report;
+    co_return co_await verifier.verify(
+        [this, startBlock](size_t page, size_t count,
+                           std::vector<uint8_t>& data) {
+            return readCfgPages(startBlock, page, count, data);
+        },
+        xo5Cfg::retryMax, report);
+}
+
 sdbusplus::async::task<bool> LatticeXO5StandardCPLD::readUserCode(
     uint32_t& userCode)
 {
@@ -273,7 +280,8 @@ sdbusplus::async::task<bool> LatticeXO5StandardCPLD::readUserCode(
     std::vector<uint8_t> request = {commandReadFwVersion, 0x0, 0x0, 0x0};
     std::vector<uint8_t> response(resSize, 0);
 
-    if (!i2cInterface.sendReceive(request, response))
+    if (!i2cInterface.sendReceive(request, response,
+                                   phosphor::i2c::Priority::high))
     {
         lg2::error("Failed to send read user code request.");
         co_return false;
@@ -32,6 +32,15 @@ class LatticeXO5StandardCPLD : public LatticeXO5BaseCPLD
                                              const std::vector<uint8_t>& data);
     sdbusplus::async::task<bool> readPage(uint8_t block, uint8_t page,
                                           std::vector<uint8_t>& data);
+    sdbusplus::async::task<bool> eraseBlock(uint8_t block);
+
+    // @param startBlock   first block of the cfg
+    // @param page         page within the cfg
+    sdbusplus::async::task<bool> programCfgPage(
+        uint8_t startBlock, size_t page, std::span<const uint8_t> data);
+    sdbusplus::async::task<bool> readCfgPages(uint8_t startBlock, size_t page,
+                                              size_t count,
+                                              std::vector<uint8_t>& data);
     sdbusplus::async::task<bool> programDone();
 };
 
@@ -1,6 +1,8 @@
 #include "eeprom_device.hpp"
 
 #include "common/include/software.hpp"
+#include "common/include/uevent_waiter.hpp"
+#include "common/include/update_scheduler.hpp"
 #include "common/include/utils.hpp"
 
 #include <gpio_controller.hpp>
@@ -17,6 +19,9 @@ namespace fs = std::filesystem;
 namespace MatchRules = sdbusplus::match_rules;
 namespace State = sdbusplus::common::xyz::openbmc_project::state;
 
+// upper bound for the kernel to probe or remove the driver
+constexpr auto driverBindTimeout = std::chrono::seconds(10);
+
 static std::string getDriverPath(const std::string& chipModel)
 {
     // Currently, only EEPROM chips with the model AT24 are supported.
@@ -73,6 +78,37 @@ EEPROMDevice::EEPROMDevice(
     debug("Initialized EEPROM device instance on dbus");
 }
 
+std::optional<std::string> EEPROMDevice::getUpdateBus() const
+{
+    return "i2c-" + std::to_string(bus);
+}
+
+std::set<std::string> EEPROMDevice::getUpdateResources() const
+{
+    std::set<std::string> resources = Device::getUpdateResources();
+
+    for (const auto& line : gpioLines)
+    {
+        resources.insert(phosphor::software::update::gpioResource(line));
+    }
+
+    return resources;
+}
+
+sdbusplus::async::task<bool> EEPROMDevice::updateDeviceStreaming(
+    const SoftwareInf::ComponentReader& component)
+{
+    auto mapping = component.map();
+
+    if (!mapping)
+    {
+        co_return false;
+    }
+
+    co_return co_await updateDevice(mapping->data().data(),
+                                    mapping->data().size());
+}
+
 sdbusplus::async::task<bool> EEPROMDevice::updateDevice(const uint8_t* image,
                                                         size_t image_size)
 {
@@ -156,6 +192,8 @@ sdbusplus::async::task<bool> EEPROMDevice::bindEEPROM()
         co_return false;
     }
 
+    SoftwareInf::UeventWaiter waiter(ctx);
+
     auto bindPath = driverPath + "/bind";
     std::ofstream ofbind(bindPath, std::ofstream::out);
     if (!ofbind)
@@ -167,10 +205,8 @@ sdbusplus::async::task<bool> EEPROMDevice::bindEEPROM()
     ofbind << i2cDeviceId;
     ofbind.close();
 
-    // wait for kernel
-    co_await sdbusplus::async::sleep_for(ctx, std::chrono::seconds(2));
-
-    auto bound = isEEPROMBound();
+    auto bound = co_await waiter.waitFor([this] { return isEEPROMBound(); },
+                                         driverBindTimeout);
     if (!bound)
     {
         error("Failed to bind {I2CDEVICE} EEPROM", "I2CDEVICE", i2cDeviceId);
@@ -192,6 +228,8 @@ sdbusplus::async::task<bool> EEPROMDevice::unbindEEPROM()
         co_return false;
     }
 
+    SoftwareInf::UeventWaiter waiter(ctx);
+
     auto unbindPath = driverPath + "/unbind";
     std::ofstream ofunbind(unbindPath, std::ofstream::out);
     if (!ofunbind)
@@ -202,10 +240,8 @@ sdbusplus::async::task<bool> EEPROMDevice::unbindEEPROM()
     ofunbind << i2cDeviceId;
     ofunbind.close();
 
-    // wait for kernel
-    co_await sdbusplus::async::sleep_for(ctx, std::chrono::seconds(2));
-
-    auto bound = isEEPROMBound();
+    auto bound = !co_await waiter.waitFor(
+        [this] { return !isEEPROMBound(); }, driverBindTimeout);
     if (bound)
     {
         error("Failed to unbind {I2CDEVICE} EEPROM", "I2CDEVICE", i2cDeviceId);
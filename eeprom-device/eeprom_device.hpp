@@ -30,6 +30,15 @@ class EEPROMDevice : public Device
     sdbusplus::async::task<bool> updateDevice(const uint8_t* image,
                                               size_t image_size) final;
 
+    // @brief         Maps the component image instead of reading it into
+    //                memory.
+    sdbusplus::async::task<bool> updateDeviceStreaming(
+        const SoftwareInf::ComponentReader& component) final;
+
+    std::optional<std::string> getUpdateBus() const final;
+
+    std::set<std::string> getUpdateResources() const final;
+
   private:
     uint16_t bus;
     uint8_t address;
@@ -9,6 +9,11 @@
 namespace phosphor::software::i2c_vr::device
 {
 
+std::optional<std::string> I2CVRDevice::getUpdateBus() const
+{
+    return "i2c-" + std::to_string(bus);
+}
+
 sdbusplus::async::task<bool> I2CVRDevice::updateDevice(const uint8_t* image,
                                                        size_t imageSize)
 {
@@ -37,6 +42,87 @@ sdbusplus::async::task<bool> I2CVRDevice::updateDevice(const uint8_t* image,
     co_return true;
 }
 
+sdbusplus::async::task<bool> I2CVRDevice::isImageProgrammed(
+    const ComponentReader& component)
+{
+    std::vector<uint8_t> image;
+
+    if (!component.readAll(image))
+    {
+        co_return false;
+    }
+
+    // NOLINTBEGIN(clang-analyzer-core.uninitialized.Branch)
+    if (!(co_await vrInterface->verifyImage(image.data(), image.size())))
+    //  NOLINTEND(clang-analyzer-core.uninitialized.Branch)
+    {
+        co_return false;
+    }
+
+    const std::optional<uint32_t> imageCRC = vrInterface->getImageCRC();
+    if (!imageCRC.has_value())
+    {
+        co_return false;
+    }
+
+    uint32_t deviceCRC = 0;
+
+    if (!co_await getVersion(&deviceCRC))
+    {
+        co_return false;
+    }
+
+    lg2::debug("CRC of VR {NAME}: {DEVICE}, of image: {IMAGE}", "NAME",
+               config.configName, "DEVICE", lg2::hex, deviceCRC, "IMAGE",
+               lg2::hex, imageCRC.value());
+
+    co_return deviceCRC == imageCRC.value();
+}
+
+sdbusplus::async::task<bool> I2CVRDevice::stageImage(
+    const uint8_t* image, size_t imageSize, std::vector<uint8_t>& staged)
+{
+    stagedImageParsed = false;
+
+    // NOLINTBEGIN(clang-analyzer-core.uninitialized.Branch)
+    if (!(co_await vrInterface->verifyImage(image, imageSize)))
+    //  NOLINTEND(clang-analyzer-core.uninitialized.Branch)
+    {
+        co_return false;
+    }
+
+    staged.assign(image, image + imageSize);
+    stagedImageParsed = true;
+
+    co_return true;
+}
+
+sdbusplus::async::task<bool> I2CVRDevice::updateDeviceStaged(
+    const uint8_t* image, size_t imageSize)
+{
+    if (!stagedImageParsed)
+    {
+        co_return co_await updateDevice(image, imageSize);
+    }
+
+    stagedImageParsed = false;
+
+    setUpdateProgress(50);
+
+    // NOLINTBEGIN(clang-analyzer-core.uninitialized.Branch)
+    if (!(co_await vrInterface->updateFirmware(false)))
+    //  NOLINTEND(clang-analyzer-core.uninitialized.Branch)
+    {
+        co_return false;
+    }
+
+    setUpdateProgress(100);
+
+    lg2::info("Successfully updated VR {NAME}", "NAME", config.configName);
+
+    co_return true;
+}
+
 sdbusplus::async::task<bool> I2CVRDevice::getVersion(uint32_t* sum) const
 {
     // NOLINTBEGIN(clang-analyzer-core.uninitialized.Branch)
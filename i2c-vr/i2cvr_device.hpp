@@ -28,7 +28,7 @@ class I2CVRDevice : public DeviceInf::Device
         DeviceInf::Device(
             ctx, config, parent,
             {SDBusPlusSoftware::ApplyTime::RequestedApplyTimes::OnReset}),
-        vrInterface(VRInf::create(ctx, vrType, bus, address))
+        vrInterface(VRInf::create(ctx, vrType, bus, address)), bus(bus)
     {}
 
     std::unique_ptr<VRInf::VoltageRegulator> vrInterface;
@@ -36,7 +36,28 @@ class I2CVRDevice : public DeviceInf::Device
     sdbusplus::async::task<bool> updateDevice(const uint8_t* image,
                                               size_t image_size) final;
 
+    std::optional<std::string> getUpdateBus() const final;
+
     sdbusplus::async::task<bool> getVersion(uint32_t* sum) const;
+
+  private:
+    // Compares the CRC of the image with the CRC reported by the regulator.
+    sdbusplus::async::task<bool> isImageProgrammed(
+        const ComponentReader& component) final;
+
+    // Parses the image into 'vrInterface' when the update is staged, so
+    // applying it only has to program the regulator.
+    sdbusplus::async::task<bool> stageImage(
+        const uint8_t* image, size_t image_size,
+        std::vector<uint8_t>& staged) final;
+
+    sdbusplus::async::task<bool> updateDeviceStaged(const uint8_t* image,
+                                                    size_t image_size) final;
+
+    uint16_t bus;
+
+    // true while 'vrInterface' holds the parsed staged image
+    bool stagedImageParsed = false;
 };
 
 } // namespace phosphor::software::i2c_vr::device
@@ -1,6 +1,9 @@
 #include "i2cvr_software_manager.hpp"
 
+#include "common/common_config.h"
 #include "common/include/dbus_helper.hpp"
+#include "common/include/i2c/i2c_scheduler.hpp"
+#include "common/include/i2c/i2c_trace.hpp"
 #include "common/include/software_manager.hpp"
 #include "i2cvr_device.hpp"
 #include "vr.hpp"
@@ -11,6 +14,7 @@
 #include <xyz/openbmc_project/ObjectMapper/client.hpp>
 
 #include <cstdint>
+#include <string_view>
 
 PHOSPHOR_LOG2_USING;
 
@@ -40,6 +44,15 @@ void I2CVRSoftwareManager::start()
         configIntfs.push_back("xyz.openbmc_project.Configuration." + name);
     }
 
+    // Queue I2C transfers per bus and run them off the event loop
+    phosphor::i2c::I2CScheduler::instance().attach(ctx);
+
+    if (!std::string_view(I2C_TRACE_DIR).empty())
+    {
+        phosphor::i2c::I2CTrace::instance().enable(
+            ctx, std::string(I2C_TRACE_DIR) + "/i2cvr-i2c-trace.txt");
+    }
+
     ctx.spawn(initDevices(configIntfs));
     ctx.run();
 }
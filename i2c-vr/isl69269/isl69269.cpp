@@ -304,6 +304,11 @@ sdbusplus::async::task<bool> ISL69269::getCRC(uint32_t* sum)
     co_return true;
 }
 
+std::optional<uint32_t> ISL69269::getImageCRC() const
+{
+    return configuration.crcExp;
+}
+
 bool ISL69269::parseImage(const uint8_t* image, size_t imageSize)
 {
     size_t nextLineStart = 0;
@@ -507,7 +512,8 @@ sdbusplus::async::task<bool> ISL69269::program()
                     configuration.pData[i].len);
 
         if (!(co_await i2cInterface.sendReceive(
-                tbuf, configuration.pData[i].len, rbuf, rlen)))
+                tbuf, configuration.pData[i].len, rbuf, rlen,
+                phosphor::i2c::Priority::bulk)))
         {
             error("program failed at writing data to voltage regulator");
         }
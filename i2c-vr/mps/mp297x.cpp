@@ -101,17 +101,17 @@ sdbusplus::async::task<bool> MP297X::checkId(PMBusCmd idCmd, uint32_t expected)
 {
     constexpr size_t idLength = 2;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for ID check");
         co_return false;
     }
 
-    tbuf = buildByteVector(idCmd);
+    tbuf = buildBytes<Frame>(idCmd);
     rbuf.resize(statusByteLength + idLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -138,17 +138,17 @@ sdbusplus::async::task<bool> MP297X::isPasswordUnlock()
 {
     constexpr uint8_t passwordMatchMask = 0x08;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for password unlock check");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::statusCML);
+    tbuf = buildBytes<Frame>(PMBusCmd::statusCML);
     rbuf.resize(statusByteLength);
 
     if (!i2cInterface.sendReceive(tbuf, rbuf))
@@ -171,18 +171,18 @@ sdbusplus::async::task<bool> MP297X::unlockWriteProtect()
     constexpr uint8_t unlockMemoryProtect = 0x00;
     constexpr uint8_t unlockMTPProtect = 0x63;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf(statusByteLength);
+    Frame tbuf;
+    Frame rbuf(statusByteLength, 0);
 
     // Get write protection mode
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page1);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page1);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 1 to check write protection mode");
         co_return false;
     }
 
-    tbuf = buildByteVector(MP297XCmd::writeProtectMode);
+    tbuf = buildBytes<Frame>(MP297XCmd::writeProtectMode);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to get write protect mode");
@@ -193,14 +193,14 @@ sdbusplus::async::task<bool> MP297X::unlockWriteProtect()
     auto unlockData = isMTPMode ? unlockMTPProtect : unlockMemoryProtect;
 
     // Unlock write protection
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 to unlock write protection");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::writeProtect, unlockData);
+    tbuf = buildBytes<Frame>(PMBusCmd::writeProtect, unlockData);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to unlock write protection");
@@ -233,10 +233,10 @@ sdbusplus::async::task<bool> MP297X::programPageRegisters(
         pageNum = static_cast<uint8_t>(page);
     }
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, page);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, page);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page {PAGE} to program registers", "PAGE",
@@ -245,8 +245,8 @@ sdbusplus::async::task<bool> MP297X::programPageRegisters(
     }
 
     auto i2cWriteWithRetry =
-        [&](const std::vector<uint8_t>& tbuf) -> sdbusplus::async::task<bool> {
-        std::vector<uint8_t> rbuf;
+        [&](const Frame& tbuf) -> sdbusplus::async::task<bool> {
+        Frame rbuf;
         constexpr size_t maxRetries = 3;
         constexpr auto retryDelay = std::chrono::milliseconds(10);
 
@@ -293,17 +293,17 @@ sdbusplus::async::task<bool> MP297X::programPageRegisters(
 
 sdbusplus::async::task<bool> MP297X::storeDataIntoMTP()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for storing data into MTP");
         co_return false;
     }
 
-    tbuf = buildByteVector(MP297XCmd::storeDataIntoMTP);
+    tbuf = buildBytes<Frame>(MP297XCmd::storeDataIntoMTP);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to store data into MTP");
@@ -322,17 +322,17 @@ sdbusplus::async::task<bool> MP297X::enableMTPPageWriteRead()
 {
     constexpr uint8_t mtpByteRWEnable = 0x20;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page1);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page1);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 1 to enable MTP page write/read");
         co_return false;
     }
 
-    tbuf = buildByteVector(MP297XCmd::enableMTPPageWR);
+    tbuf = buildBytes<Frame>(MP297XCmd::enableMTPPageWR);
     rbuf.resize(statusByteLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -341,7 +341,7 @@ sdbusplus::async::task<bool> MP297X::enableMTPPageWriteRead()
     }
 
     uint8_t enableMTPPageWRData = rbuf[0] | mtpByteRWEnable;
-    tbuf = buildByteVector(MP297XCmd::enableMTPPageWR, enableMTPPageWRData);
+    tbuf = buildBytes<Frame>(MP297XCmd::enableMTPPageWR, enableMTPPageWRData);
     rbuf.resize(0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -355,17 +355,17 @@ sdbusplus::async::task<bool> MP297X::enableMTPPageWriteRead()
 
 sdbusplus::async::task<bool> MP297X::enableMultiConfigCRC()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page2);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page2);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 2 to enable multi-config CRC");
         co_return false;
     }
 
-    tbuf = buildByteVector(MP297XCmd::enableMultiConfigCRC);
+    tbuf = buildBytes<Frame>(MP297XCmd::enableMultiConfigCRC);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to enable multi-config CRC");
@@ -386,14 +386,14 @@ sdbusplus::async::task<bool> MP297X::getCRC(uint32_t* checksum)
 
     constexpr size_t crcLength = 2;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
     uint16_t userCodeCRC = 0;
     uint16_t multiConfigCRC = 0;
 
     // Read User Code CRC
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page29);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page29);
     rbuf.resize(0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -401,7 +401,7 @@ sdbusplus::async::task<bool> MP297X::getCRC(uint32_t* checksum)
         co_return false;
     }
 
-    tbuf = buildByteVector(MP297XCmd::readUserCodeCRC);
+    tbuf = buildBytes<Frame>(MP297XCmd::readUserCodeCRC);
     rbuf.resize(crcLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -412,7 +412,7 @@ sdbusplus::async::task<bool> MP297X::getCRC(uint32_t* checksum)
     userCodeCRC = bytesToInt<uint16_t>(rbuf);
 
     // Read Multi Config CRC
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page2A);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page2A);
     rbuf.resize(0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -420,7 +420,7 @@ sdbusplus::async::task<bool> MP297X::getCRC(uint32_t* checksum)
         co_return false;
     }
 
-    tbuf = buildByteVector(MP297XCmd::readMultiConfigCRC);
+    tbuf = buildBytes<Frame>(MP297XCmd::readMultiConfigCRC);
     rbuf.resize(crcLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -122,10 +122,10 @@ sdbusplus::async::task<bool> MP2X6XX::checkId(PMBusCmd pmBusCmd,
             co_return false;
     }
 
-    std::vector<uint8_t> rbuf;
-    std::vector<uint8_t> tbuf;
+    Frame rbuf;
+    Frame tbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for ID check");
@@ -156,17 +156,17 @@ sdbusplus::async::task<bool> MP2X6XX::checkId(PMBusCmd pmBusCmd,
 
 sdbusplus::async::task<bool> MP2X6XX::unlockWriteProtect()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for unlocking write protect");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::writeProtect, disableWriteProtect);
+    tbuf = buildBytes<Frame>(PMBusCmd::writeProtect, disableWriteProtect);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to disable write protect");
@@ -174,15 +174,15 @@ sdbusplus::async::task<bool> MP2X6XX::unlockWriteProtect()
     }
 
     // unlock page 2 write protect
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page1);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page1);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 1 for unlocking write protect for page 2");
         co_return false;
     }
 
-    tbuf =
-        buildByteVector(MP2X6XXCmd::mfrMTPMemoryCtrl, disablePage2WriteProtect);
+    tbuf = buildBytes<Frame>(MP2X6XXCmd::mfrMTPMemoryCtrl,
+                             disablePage2WriteProtect);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to unlock page 2 write protect");
@@ -190,14 +190,14 @@ sdbusplus::async::task<bool> MP2X6XX::unlockWriteProtect()
     }
 
     // unlock page 3 write protect
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page3);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page3);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 3 for unlocking write protect for page 3");
         co_return false;
     }
 
-    tbuf = buildByteVector(MP2X6XXCmd::mfrMTPMemoryCtrlPage3,
+    tbuf = buildBytes<Frame>(MP2X6XXCmd::mfrMTPMemoryCtrlPage3,
                            disablePage3WriteProtect);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -216,10 +216,10 @@ sdbusplus::async::task<bool> MP2X6XX::selectConfig(uint8_t config)
     // Writes to Page 2 @ 0x1A: value = 0x0F00 | ((config + 7) << 4)
     // For config 1–6 → result: 0x0F80 to 0x0FD0
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page2);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page2);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 2 for configuration switch");
@@ -230,7 +230,7 @@ sdbusplus::async::task<bool> MP2X6XX::selectConfig(uint8_t config)
     uint8_t encodedNibble = static_cast<uint8_t>((config + baseOffset) << 4);
     uint16_t command = 0x0F00 | encodedNibble;
 
-    tbuf = buildByteVector(MP2X6XXCmd::selectConfigCtrl, command);
+    tbuf = buildBytes<Frame>(MP2X6XXCmd::selectConfigCtrl, command);
 
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -246,14 +246,14 @@ sdbusplus::async::task<bool> MP2X6XX::selectConfig(uint8_t config)
 sdbusplus::async::task<bool> MP2X6XX::programConfigData(
     const std::vector<MPSData>& gdata)
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
     for (const auto& data : gdata)
     {
         uint8_t page = data.page & pageMask;
 
-        tbuf = buildByteVector(PMBusCmd::page, page);
+        tbuf = buildBytes<Frame>(PMBusCmd::page, page);
         if (!i2cInterface.sendReceive(tbuf, rbuf))
         {
             error("Failed to set page {PAGE} for register {REG}", "PAGE", page,
@@ -311,17 +311,17 @@ sdbusplus::async::task<bool> MP2X6XX::configAllRegisters()
 
 sdbusplus::async::task<bool> MP2X6XX::storeUserCode()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for storing user code");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::storeUserCode);
+    tbuf = buildBytes<Frame>(PMBusCmd::storeUserCode);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to store user code");
@@ -344,17 +344,17 @@ sdbusplus::async::task<bool> MP2X6XX::getCRC(uint32_t* checksum)
         co_return false;
     }
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for CRC read");
         co_return false;
     }
 
-    tbuf = buildByteVector(MP2X6XXCmd::readCRCReg);
+    tbuf = buildBytes<Frame>(MP2X6XXCmd::readCRCReg);
     rbuf.resize(crcLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -4,6 +4,7 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <array>
 #include <fstream>
 
 PHOSPHOR_LOG2_USING;
@@ -83,10 +84,10 @@ sdbusplus::async::task<bool> MP5998::checkId(PMBusCmd idCmd, uint32_t expected)
     static constexpr size_t mfrIdLength = 3;
     static constexpr size_t mfrModelLength = 5;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("MP5998: Failed to set page 0 for ID check");
@@ -110,7 +111,7 @@ sdbusplus::async::task<bool> MP5998::checkId(PMBusCmd idCmd, uint32_t expected)
         co_return false;
     }
 
-    tbuf = buildByteVector(idCmd);
+    tbuf = buildBytes<Frame>(idCmd);
     rbuf.resize(bufferSize);
 
     if (!i2cInterface.sendReceive(tbuf, rbuf))
@@ -144,24 +145,24 @@ sdbusplus::async::task<bool> MP5998::unlockPasswordProtection()
     constexpr uint8_t passwordUnlockBit = 0x08;
     constexpr uint16_t passwordData = 0x0000;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for password unlock");
         co_return false;
     }
 
-    tbuf = buildByteVector(MP5998Cmd::passwordReg, passwordData);
+    tbuf = buildBytes<Frame>(MP5998Cmd::passwordReg, passwordData);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to write password");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::statusCML);
+    tbuf = buildBytes<Frame>(PMBusCmd::statusCML);
     rbuf.resize(statusByteLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -176,17 +177,17 @@ sdbusplus::async::task<bool> MP5998::unlockPasswordProtection()
 
 sdbusplus::async::task<bool> MP5998::unlockWriteProtection()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for write protection unlock");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::writeProtect, unlockData);
+    tbuf = buildBytes<Frame>(PMBusCmd::writeProtect, unlockData);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to unlock write protection");
@@ -201,14 +202,15 @@ sdbusplus::async::task<bool> MP5998::programAllRegisters()
 {
     uint8_t currentPage = 0xFF;
 
+    // one transaction per PMBus command, the device expects a stop after each
     for (const auto& regData : configuration->registersData)
     {
         if (regData.page != currentPage)
         {
-            std::vector<uint8_t> tbuf =
-                buildByteVector(PMBusCmd::page, regData.page);
-            std::vector<uint8_t> rbuf;
-            if (!i2cInterface.sendReceive(tbuf, rbuf))
+            auto tbuf = buildBytes<Frame>(PMBusCmd::page, regData.page);
+            if (!(co_await i2cInterface.sendReceive(
+                    tbuf.data(), tbuf.size(), nullptr, 0,
+                    phosphor::i2c::Priority::bulk)))
             {
                 error("Failed to set page {PAGE}", "PAGE", regData.page);
                 co_return false;
@@ -216,17 +218,18 @@ sdbusplus::async::task<bool> MP5998::programAllRegisters()
             currentPage = regData.page;
         }
 
-        std::vector<uint8_t> tbuf;
-        std::vector<uint8_t> rbuf;
+        std::array<uint8_t, 5> tbuf{};
+        uint8_t tlen = 0;
 
-        tbuf.push_back(regData.addr);
+        tbuf[tlen++] = regData.addr;
 
         for (uint8_t i = 0; i < regData.length && i < 4; ++i)
         {
-            tbuf.push_back(regData.data[i]);
+            tbuf[tlen++] = regData.data[i];
         }
 
-        if (!i2cInterface.sendReceive(tbuf, rbuf))
+        if (!(co_await i2cInterface.sendReceive(
+                tbuf.data(), tlen, nullptr, 0, phosphor::i2c::Priority::bulk)))
         {
             error("Failed to write register 0x{REG} on page {PAGE}", "REG",
                   lg2::hex, regData.addr, "PAGE", regData.page);
@@ -240,17 +243,17 @@ sdbusplus::async::task<bool> MP5998::programAllRegisters()
 
 sdbusplus::async::task<bool> MP5998::storeMTP()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for MTP store");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::storeUserCode);
+    tbuf = buildBytes<Frame>(PMBusCmd::storeUserCode);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to send STORE_USER_ALL command");
@@ -265,8 +268,8 @@ sdbusplus::async::task<bool> MP5998::waitForMTPComplete()
     constexpr uint16_t mtpStoreWaitmS = 1200;
     co_await sdbusplus::async::sleep_for(
         ctx, std::chrono::milliseconds(mtpStoreWaitmS));
-    std::vector<uint8_t> tbuf = buildByteVector(PMBusCmd::statusCML);
-    std::vector<uint8_t> rbuf;
+    Frame tbuf = buildBytes<Frame>(PMBusCmd::statusCML);
+    Frame rbuf;
     rbuf.resize(statusByteLength);
 
     if (!i2cInterface.sendReceive(tbuf, rbuf))
@@ -307,17 +310,17 @@ sdbusplus::async::task<bool> MP5998::getCRC(uint32_t* checksum)
 {
     constexpr size_t crcLength = 2;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for CRC read");
         co_return false;
     }
 
-    tbuf = buildByteVector(MP5998Cmd::crcUser);
+    tbuf = buildBytes<Frame>(MP5998Cmd::crcUser);
     rbuf.resize(crcLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -332,17 +335,17 @@ sdbusplus::async::task<bool> MP5998::getCRC(uint32_t* checksum)
 
 sdbusplus::async::task<bool> MP5998::sendRestoreMTPCommand()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for MTP restore");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::restoreUserAll);
+    tbuf = buildBytes<Frame>(PMBusCmd::restoreUserAll);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to send RESTORE_ALL command");
@@ -354,17 +357,17 @@ sdbusplus::async::task<bool> MP5998::sendRestoreMTPCommand()
 
 sdbusplus::async::task<bool> MP5998::checkEEPROMFaultAfterRestore()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for EEPROM fault check");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::statusCML);
+    tbuf = buildBytes<Frame>(PMBusCmd::statusCML);
     rbuf.resize(1);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
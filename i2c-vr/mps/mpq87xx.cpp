@@ -24,17 +24,17 @@ sdbusplus::async::task<bool> MPQ87XX::checkId()
 {
     static constexpr size_t mfrIdLength = 4;
     static constexpr size_t mfrConfigIdLength = 2;
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for ID check");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::mfrId);
+    tbuf = buildBytes<Frame>(PMBusCmd::mfrId);
     rbuf.resize(mfrIdLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -54,7 +54,7 @@ sdbusplus::async::task<bool> MPQ87XX::checkId()
         co_return false;
     }
 
-    tbuf = buildByteVector(MPQ87XXCmd::mfrConfigId);
+    tbuf = buildBytes<Frame>(MPQ87XXCmd::mfrConfigId);
     rbuf.clear();
     rbuf.resize(mfrConfigIdLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
@@ -89,10 +89,10 @@ sdbusplus::async::task<bool> MPQ87XX::programPageRegisters(
 
     const auto& data = groupedData.at(pageNum);
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, page);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, page);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page {PAGE} to program registers", "PAGE",
@@ -118,17 +118,17 @@ sdbusplus::async::task<bool> MPQ87XX::programPageRegisters(
 
 sdbusplus::async::task<bool> MPQ87XX::storeMTP()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for MTP store");
         co_return false;
     }
 
-    tbuf = buildByteVector(MPQ87XXCmd::storeAll);
+    tbuf = buildBytes<Frame>(MPQ87XXCmd::storeAll);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to send STORE_USER_ALL command");
@@ -228,17 +228,17 @@ sdbusplus::async::task<bool> MPQ87XX::getCRC(uint32_t* checksum)
 {
     constexpr size_t crcLength = 2;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for CRC read");
         co_return false;
     }
 
-    tbuf = buildByteVector(MPQ87XXCmd::checksumFunc);
+    tbuf = buildBytes<Frame>(MPQ87XXCmd::checksumFunc);
     rbuf.resize(crcLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
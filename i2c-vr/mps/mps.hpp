@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common/include/i2c/frame.hpp"
 #include "common/include/i2c/i2c.hpp"
 #include "i2c-vr/vr.hpp"
 
@@ -14,6 +15,8 @@
 namespace phosphor::software::VR
 {
 
+using phosphor::i2c::Frame;
+
 /**
  * @brief
  * Columns of an Automated Test Equipment (ATE) format configuration file.
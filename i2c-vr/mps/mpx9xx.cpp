@@ -142,17 +142,17 @@ sdbusplus::async::task<bool> MPX9XX::checkId(MPX9XXCmd idCmd, uint32_t expected)
             co_return false;
     }
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, page);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, page);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page for ID check");
         co_return false;
     }
 
-    tbuf = buildByteVector(idCmd);
+    tbuf = buildBytes<Frame>(idCmd);
     rbuf.resize(idLen);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -176,17 +176,17 @@ sdbusplus::async::task<bool> MPX9XX::unlockWriteProtect()
 {
     static constexpr uint8_t unlockWriteProtectData = 0x00;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 to unlock write protection mode");
         co_return false;
     }
 
-    tbuf = buildByteVector(PMBusCmd::writeProtect, unlockWriteProtectData);
+    tbuf = buildBytes<Frame>(PMBusCmd::writeProtect, unlockWriteProtectData);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to unlock write protect mode");
@@ -203,18 +203,18 @@ sdbusplus::async::task<bool> MPX9XX::disableStoreFaultTriggering()
     static constexpr uint16_t enableEnteringPage7Mask = 0x8000;
     static constexpr uint16_t disableStoreFaultTriggeringData = 0x1000;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
     // enable entering page 7
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page2);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page2);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 2 to enable entering page 7");
         co_return false;
     }
 
-    tbuf = buildByteVector(MPX9XXCmd::mfrDebug);
+    tbuf = buildBytes<Frame>(MPX9XXCmd::mfrDebug);
     rbuf.resize(mfrDebugDataLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -223,7 +223,7 @@ sdbusplus::async::task<bool> MPX9XX::disableStoreFaultTriggering()
     }
 
     uint16_t data = (rbuf[1] << 8) | rbuf[0] | enableEnteringPage7Mask;
-    tbuf = buildByteVector(MPX9XXCmd::mfrDebug, data);
+    tbuf = buildBytes<Frame>(MPX9XXCmd::mfrDebug, data);
     rbuf.clear();
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -232,14 +232,14 @@ sdbusplus::async::task<bool> MPX9XX::disableStoreFaultTriggering()
     }
 
     // disable store fault triggering
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page7);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page7);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 7 to disable store fault triggering");
         co_return false;
     }
 
-    tbuf = buildByteVector(MPX9XXCmd::storeFaultTrigger,
+    tbuf = buildBytes<Frame>(MPX9XXCmd::storeFaultTrigger,
                            disableStoreFaultTriggeringData);
     rbuf.clear();
     if (!i2cInterface.sendReceive(tbuf, rbuf))
@@ -271,10 +271,10 @@ sdbusplus::async::task<bool> MPX9XX::setMultiConfigAddress(uint8_t config)
         error("Invalid multi config address: {ADDR}", "ADDR", addr);
     }
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page2);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page2);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 2 to set multi config address");
@@ -282,7 +282,7 @@ sdbusplus::async::task<bool> MPX9XX::setMultiConfigAddress(uint8_t config)
     }
 
     uint8_t selectAddrData = enableMultiConfigAddrSel + addr;
-    tbuf = buildByteVector(MPX9XXCmd::mfrMulconfigSel, selectAddrData);
+    tbuf = buildBytes<Frame>(MPX9XXCmd::mfrMulconfigSel, selectAddrData);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to write {DATA} to multi config select register {REG}",
@@ -298,14 +298,14 @@ sdbusplus::async::task<bool> MPX9XX::setMultiConfigAddress(uint8_t config)
 sdbusplus::async::task<bool> MPX9XX::programConfigData(
     const std::vector<MPSData>& gdata)
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
     for (const auto& data : gdata)
     {
         uint8_t page = data.page & pageMask;
 
-        tbuf = buildByteVector(PMBusCmd::page, page);
+        tbuf = buildBytes<Frame>(PMBusCmd::page, page);
         if (!i2cInterface.sendReceive(tbuf, rbuf))
         {
             error("Failed to set page {PAGE} for register {REG}", "PAGE", page,
@@ -369,17 +369,17 @@ sdbusplus::async::task<bool> MPX9XX::programAllRegisters()
 
 sdbusplus::async::task<bool> MPX9XX::storeDataIntoMTP()
 {
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 to store data into MTP");
         co_return false;
     }
 
-    tbuf = buildByteVector(MPX9XXCmd::storeUserAll);
+    tbuf = buildBytes<Frame>(MPX9XXCmd::storeUserAll);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to store data into MTP");
@@ -398,17 +398,17 @@ sdbusplus::async::task<bool> MPX9XX::getCRC(uint32_t* checksum)
     static constexpr size_t crcUserMultiDataLength = 4;
     static constexpr size_t statusByteLength = 1;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for get user data");
         co_return false;
     }
 
-    tbuf = buildByteVector(MPX9XXCmd::userData08);
+    tbuf = buildBytes<Frame>(MPX9XXCmd::userData08);
     rbuf.resize(crcUserMultiDataLength + statusByteLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -428,18 +428,18 @@ sdbusplus::async::task<bool> MPX9XX::restoreDataFromNVM()
     static constexpr size_t nvmPmbusCtrlDataLength = 2;
     static constexpr uint16_t enableRestoreDataFromMTPMask = 0x0008;
 
-    std::vector<uint8_t> tbuf;
-    std::vector<uint8_t> rbuf;
+    Frame tbuf;
+    Frame rbuf;
 
     // enable restore data from MTP
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page2);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page2);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 2 to enable restore data from MTP");
         co_return false;
     }
 
-    tbuf = buildByteVector(MPX9XXCmd::mfrNVMPmbusCtrl);
+    tbuf = buildBytes<Frame>(MPX9XXCmd::mfrNVMPmbusCtrl);
     rbuf.resize(nvmPmbusCtrlDataLength);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -448,7 +448,7 @@ sdbusplus::async::task<bool> MPX9XX::restoreDataFromNVM()
     }
 
     uint16_t data = ((rbuf[1] << 8) | rbuf[0]) | enableRestoreDataFromMTPMask;
-    tbuf = buildByteVector(MPX9XXCmd::mfrNVMPmbusCtrl, data);
+    tbuf = buildBytes<Frame>(MPX9XXCmd::mfrNVMPmbusCtrl, data);
     rbuf.clear();
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
@@ -457,13 +457,13 @@ sdbusplus::async::task<bool> MPX9XX::restoreDataFromNVM()
     }
 
     // restore data from NVM
-    tbuf = buildByteVector(PMBusCmd::page, MPSPage::page0);
+    tbuf = buildBytes<Frame>(PMBusCmd::page, MPSPage::page0);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to set page 0 for restore MTP and verify");
     }
 
-    tbuf = buildByteVector(PMBusCmd::restoreUserAll);
+    tbuf = buildBytes<Frame>(PMBusCmd::restoreUserAll);
     if (!i2cInterface.sendReceive(tbuf, rbuf))
     {
         error("Failed to restore data from NVM");
@@ -158,6 +158,11 @@ sdbusplus::async::task<bool> TDA38640A::getCRC(uint32_t* sum)
     co_return true;
 }
 
+std::optional<uint32_t> TDA38640A::getImageCRC() const
+{
+    return configuration.checksum;
+}
+
 bool TDA38640A::parseImage(const uint8_t* image, size_t imageSize)
 {
     std::string content(reinterpret_cast<const char*>(image), imageSize);
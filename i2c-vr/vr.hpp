@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace phosphor::software::VR
@@ -53,6 +54,14 @@ class VoltageRegulator
     // @returns < 0 on error
     virtual sdbusplus::async::task<bool> getCRC(uint32_t* checksum) = 0;
 
+    // @brief Returns the CRC which 'getCRC' reports once the image parsed
+    //        by 'verifyImage' is programmed.
+    // @returns std::nullopt if the CRC is not known from the image.
+    virtual std::optional<uint32_t> getImageCRC() const
+    {
+        return std::nullopt;
+    }
+
     // @brief This function returns true if the voltage regulator supports
     //        force of updates.
     virtual bool forcedUpdateAllowed() = 0;
@@ -248,6 +248,11 @@ sdbusplus::async::task<bool> XDPE1X2XX::getCRC(uint32_t* checksum)
     co_return true;
 }
 
+std::optional<uint32_t> XDPE1X2XX::getImageCRC() const
+{
+    return configuration.sumExp;
+}
+
 sdbusplus::async::task<bool> XDPE1X2XX::program(bool force)
 {
     uint8_t tBuf[16] = {0};
@@ -390,7 +395,7 @@ sdbusplus::async::task<bool> XDPE1X2XX::program(bool force)
             size = 0;
         }
 
-        // program into scratchpad
+        // program into scratchpad, one transaction and 10ms per word
         for (int j = 0; j < sect->dataCnt; j++)
         {
             tBuf[0] = IFXMFRRegWrite;
@@ -398,11 +403,13 @@ sdbusplus::async::task<bool> XDPE1X2XX::program(bool force)
             uint8_t tSize = 6;
             uint8_t rSize = 0;
             memcpy(&tBuf[2], &sect->data[j], 4);
-            if (!(co_await this->i2cInterface.sendReceive(tBuf, tSize, rBuf,
-                                                          rSize)))
+            if (!(co_await this->i2cInterface.sendReceive(
+                    tBuf, tSize, rBuf, rSize, phosphor::i2c::Priority::bulk)))
             {
-                error("Failed to program the VR on sendReceive {CMD}", "CMD",
-                      std::string("IFXMFRRegWrite"));
+                error(
+                    "Failed to program the VR on sendReceive {CMD}, section {SECTION} word {WORD}",
+                    "CMD", std::string("IFXMFRRegWrite"), "SECTION", i, "WORD",
+                    j);
                 co_return false;
             }
             co_await sdbusplus::async::sleep_for(ctx,
@@ -483,7 +490,7 @@ bool XDPE1X2XX::parseImage(const uint8_t* image, size_t image_size)
     char line[maxLineLength];
     char* token = NULL;
     bool isData = false;
-    char delim = ' ';
+    char delim[] = " ";
     uint16_t offset;
     uint8_t sectType = 0x0;
     uint32_t dWord;
@@ -527,7 +534,7 @@ bool XDPE1X2XX::parseImage(const uint8_t* image, size_t image_size)
             else if (isData)
             {
                 char* tokenList[8] = {0};
-                int tokenSize = lineSplit(tokenList, line, &delim);
+                int tokenSize = lineSplit(tokenList, line, delim);
                 if (tokenSize < 1)
                 {
                     start = i + 1;
@@ -21,6 +21,7 @@ class XDPE1X2XX : public VoltageRegulator
     sdbusplus::async::task<bool> updateFirmware(bool force) final;
 
     sdbusplus::async::task<bool> getCRC(uint32_t* checksum) final;
+    std::optional<uint32_t> getImageCRC() const final;
     bool forcedUpdateAllowed() final;
 
   private:
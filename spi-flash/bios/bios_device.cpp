@@ -1,5 +1,8 @@
 #include "bios_device.hpp"
 
+#include "common/include/software_manager.hpp"
+#include "common/include/update_scheduler.hpp"
+
 #include <phosphor-logging/lg2.hpp>
 #include <xyz/openbmc_project/State/Host/client.hpp>
 
@@ -23,7 +26,7 @@ enum FlashTool getBiosFlashTool(const std::string& configType)
     {
         return flashToolFlashrom;
     }
-    return flashToolFlashcp;
+    return flashToolNone;
 }
 
 } // namespace
@@ -32,10 +35,12 @@ BIOSDevice::BIOSDevice(sdbusplus::async::context& ctx,
                        uint64_t spiControllerIndex, uint64_t spiDeviceIndex,
                        bool dryRun, const std::vector<std::string>& gpioLinesIn,
                        const std::vector<bool>& gpioValuesIn,
-                       SoftwareConfig& config, SoftwareManager* parent) :
+                       SoftwareConfig& config, SoftwareManager* parent,
+                       enum FlashLayout layout,
+                       const std::vector<std::string>& regions) :
     SPIDevice(ctx, spiControllerIndex, spiDeviceIndex, dryRun, gpioLinesIn,
-              gpioValuesIn, config, parent, flashLayoutFlat,
-              getBiosFlashTool(config.configType)),
+              gpioValuesIn, config, parent, layout,
+              getBiosFlashTool(config.configType), regions),
     versionWatch(ctx, biosVersionDirPath, *this)
 {
     ctx.spawn(versionWatch.readNotifyAsync());
@@ -61,6 +66,11 @@ sdbusplus::async::task<> BIOSDevice::processUpdate(
     co_return;
 }
 
+std::set<std::string> BIOSDevice::getSharedUpdateResources() const
+{
+    return {update::hostPowerResource};
+}
+
 std::string BIOSDevice::getVersion()
 {
     std::string version = versionUnknown;
@@ -95,15 +105,9 @@ std::string BIOSDevice::getVersion()
 
 sdbusplus::async::task<bool> BIOSDevice::preUpdate()
 {
-    prevPowerstate = co_await HostPower::getState(ctx);
-
-    if (prevPowerstate != stateOn && prevPowerstate != stateOff)
-    {
-        co_return false;
-    }
-
-    bool success = co_await HostPower::setState(ctx, stateOff);
-    if (!success)
+    // shared with the updates of other flashes of the host
+    holdingHostOff = co_await parent->hostOffHold.acquire();
+    if (!holdingHostOff)
     {
         error("error changing host power state");
         co_return false;
@@ -114,8 +118,14 @@ sdbusplus::async::task<bool> BIOSDevice::preUpdate()
 
 sdbusplus::async::task<bool> BIOSDevice::postUpdate()
 {
-    const bool powerstateRestored =
-        co_await HostPower::setState(ctx, prevPowerstate);
+    if (!holdingHostOff)
+    {
+        co_return false;
+    }
+
+    holdingHostOff = false;
+
+    const bool powerstateRestored = co_await parent->hostOffHold.release();
     if (!powerstateRestored)
     {
         error("error restoring host power state");
@@ -14,10 +14,15 @@ class BIOSDevice : public SPIDevice
                uint64_t spiDeviceIndex, bool dryRun,
                const std::vector<std::string>& gpioLinesIn,
                const std::vector<bool>& gpioValuesIn, SoftwareConfig& config,
-               SoftwareManager* parent);
+               SoftwareManager* parent, enum FlashLayout layout,
+               const std::vector<std::string>& regions);
 
     std::string getVersion() override;
 
+    // The host is held off during the update, together with the updates of
+    // the other flashes of the host.
+    std::set<std::string> getSharedUpdateResources() const override;
+
     /** @brief Called by NotifyWatch when the version file is rewritten.
      *  @param inVersionFilename  name of the file that changed
      */
@@ -29,5 +34,6 @@ class BIOSDevice : public SPIDevice
 
   private:
     phosphor::notify::watch::NotifyWatch<BIOSDevice> versionWatch;
-    HostState prevPowerstate;
+    // the host is powered off during the update
+    bool holdingHostOff = false;
 };
@@ -0,0 +1,131 @@
+#include "flash_layout.hpp"
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <array>
+
+PHOSPHOR_LOG2_USING;
+
+namespace phosphor::software::spi
+{
+
+constexpr uint32_t descriptorSignature = 0x0FF0A55A;
+
+// the signature moved from offset 0 to 16 after ICH8
+constexpr std::array<size_t, 2> signatureOffsets = {16, 0};
+
+// names of the flash regions by index, as flashrom names them
+constexpr std::array<const char*, 16> regionNames = {
+    "fd",  "bios",  "me",   "gbe",    "pd",     "reg5",  "bios2", "reg7",
+    "ec",  "reg9",  "ie",   "10gbe0", "10gbe1", "reg13", "reg14", "ptt",
+};
+
+static uint32_t readLE32(std::span<const uint8_t> data, size_t offset)
+{
+    return static_cast<uint32_t>(data[offset]) |
+           (static_cast<uint32_t>(data[offset + 1]) << 8) |
+           (static_cast<uint32_t>(data[offset + 2]) << 16) |
+           (static_cast<uint32_t>(data[offset + 3]) << 24);
+}
+
+std::optional<std::vector<FlashRegion>> parseIntelFlashDescriptor(
+    std::span<const uint8_t> data, size_t flashSize)
+{
+    if (data.size() < descriptorSize)
+    {
+        error("{SIZE} bytes are too small for a flash descriptor", "SIZE",
+              data.size());
+        return std::nullopt;
+    }
+
+    const auto* signature =
+        std::ranges::find_if(signatureOffsets, [&data](size_t offset) {
+            return readLE32(data, offset) == descriptorSignature;
+        });
+
+    if (signature == signatureOffsets.end())
+    {
+        error("No Intel Flash Descriptor signature found");
+        return std::nullopt;
+    }
+
+    // FLMAP0 follows the signature, its FRBA field points to the region
+    // table in units of 16 bytes
+    const uint32_t flmap0 = readLE32(data, *signature + 4);
+    const size_t frba = ((flmap0 >> 16) & 0xff) << 4;
+
+    if (frba + regionNames.size() * 4 > descriptorSize)
+    {
+        error("Flash descriptor region table at {FRBA} is out of bounds",
+              "FRBA", frba);
+        return std::nullopt;
+    }
+
+    std::vector<FlashRegion> regions;
+
+    for (size_t i = 0; i < regionNames.size(); i++)
+    {
+        const uint32_t flreg = readLE32(data, frba + i * 4);
+
+        // base and limit are in units of 4 KiB, the limit is inclusive
+        const size_t base = static_cast<size_t>(flreg & 0x7fff) << 12;
+        const size_t limit =
+            (static_cast<size_t>((flreg >> 16) & 0x7fff) << 12) | 0xfff;
+
+        // unused regions have base > limit, chipsets with fewer regions
+        // leave the remaining entries erased
+        if (base > limit || flreg == 0xffffffff)
+        {
+            continue;
+        }
+
+        if (limit >= flashSize)
+        {
+            error(
+                "Flash region {NAME} ends at {LIMIT}, beyond the flash of {SIZE} bytes",
+                "NAME", regionNames[i], "LIMIT", limit, "SIZE", flashSize);
+            return std::nullopt;
+        }
+
+        regions.push_back({regionNames[i], base, limit - base + 1});
+    }
+
+    std::ranges::sort(regions, {}, &FlashRegion::offset);
+
+    if (regions.empty() || regions.front().name != regionNames[0] ||
+        regions.front().offset != 0)
+    {
+        error("Flash descriptor does not describe itself at offset 0");
+        return std::nullopt;
+    }
+
+    for (size_t i = 1; i < regions.size(); i++)
+    {
+        const auto& prev = regions[i - 1];
+
+        if (prev.offset + prev.size > regions[i].offset)
+        {
+            error("Flash regions {NAME1} and {NAME2} overlap", "NAME1",
+                  prev.name, "NAME2", regions[i].name);
+            return std::nullopt;
+        }
+    }
+
+    return regions;
+}
+
+std::optional<FlashRegion> findRegion(const std::vector<FlashRegion>& regions,
+                                      const std::string& name)
+{
+    auto it = std::ranges::find(regions, name, &FlashRegion::name);
+
+    if (it == regions.end())
+    {
+        return std::nullopt;
+    }
+
+    return *it;
+}
+
+} // namespace phosphor::software::spi
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace phosphor::software::spi
+{
+
+struct FlashRegion
+{
+    // region name as used by flashrom, e.g. "fd", "bios", "me"
+    std::string name;
+
+    size_t offset = 0;
+    size_t size = 0;
+
+    bool operator==(const FlashRegion&) const = default;
+};
+
+// the descriptor region, which holds the region table
+constexpr size_t descriptorSize = 4096;
+
+// @param data        a flash image or its first 'descriptorSize' bytes
+// @param flashSize   size of the flash, all regions have to fit
+// @returns           the used regions of the Intel Flash Descriptor at the
+//                    start of 'data', ordered by offset, or std::nullopt if
+//                    there is no valid descriptor
+std::optional<std::vector<FlashRegion>> parseIntelFlashDescriptor(
+    std::span<const uint8_t> data, size_t flashSize);
+
+// @returns           the region named 'name' in 'regions', if there is one
+std::optional<FlashRegion> findRegion(const std::vector<FlashRegion>& regions,
+                                      const std::string& name);
+
+} // namespace phosphor::software::spi
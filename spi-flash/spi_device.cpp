@@ -1,9 +1,14 @@
 #include "spi_device.hpp"
 
+#include "common/common_config.h"
 #include "common/include/device.hpp"
 #include "common/include/host_power.hpp"
+#include "common/include/mtd_flash.hpp"
 #include "common/include/software_manager.hpp"
+#include "common/include/uevent_waiter.hpp"
+#include "common/include/update_scheduler.hpp"
 #include "common/include/utils.hpp"
+#include "flash_layout.hpp"
 
 #include <gpio_controller.hpp>
 #include <phosphor-logging/lg2.hpp>
@@ -25,6 +30,12 @@ using namespace phosphor::software::manager;
 using namespace phosphor::software::host_power;
 namespace fs = std::filesystem;
 
+#ifdef SPI_INCREMENTAL_FLASH
+constexpr auto writeMode = mtd::WriteMode::incremental;
+#else
+constexpr auto writeMode = mtd::WriteMode::full;
+#endif
+
 static std::optional<std::string> getSPIDevAddr(uint64_t spiControllerIndex)
 {
     const fs::path spi_path =
@@ -61,13 +72,14 @@ SPIDevice::SPIDevice(sdbusplus::async::context& ctx,
                      bool dryRun, const std::vector<std::string>& gpioLinesIn,
                      const std::vector<bool>& gpioValuesIn,
                      SoftwareConfig& config, SoftwareManager* parent,
-                     enum FlashLayout layout, enum FlashTool tool) :
+                     enum FlashLayout layout, enum FlashTool tool,
+                     const std::vector<std::string>& regions) :
     Device(ctx, config, parent,
            {RequestedApplyTimes::Immediate, RequestedApplyTimes::OnReset}),
     dryRun(dryRun), gpioLines(gpioLinesIn),
     gpioValues(gpioValuesIn.begin(), gpioValuesIn.end()),
     spiControllerIndex(spiControllerIndex), spiDeviceIndex(spiDeviceIndex),
-    layout(layout), tool(tool)
+    layout(layout), tool(tool), regions(regions)
 {
     auto optAddr = getSPIDevAddr(spiControllerIndex);
 
@@ -84,9 +96,42 @@ SPIDevice::SPIDevice(sdbusplus::async::context& ctx,
         "DEVICEINDEX", spiDeviceIndex);
 }
 
+std::optional<std::string> SPIDevice::getUpdateBus() const
+{
+    return "spi-" + std::to_string(spiControllerIndex);
+}
+
+std::set<std::string> SPIDevice::getUpdateResources() const
+{
+    std::set<std::string> resources = Device::getUpdateResources();
+
+    for (const auto& line : gpioLines)
+    {
+        resources.insert(update::gpioResource(line));
+    }
+
+    return resources;
+}
+
+sdbusplus::async::task<bool> SPIDevice::updateDeviceStreaming(
+    const ComponentReader& component)
+{
+    auto mapping = component.map();
+
+    if (!mapping)
+    {
+        co_return false;
+    }
+
+    co_return co_await updateDevice(mapping->data().data(),
+                                    mapping->data().size());
+}
+
 sdbusplus::async::task<bool> SPIDevice::updateDevice(const uint8_t* image,
                                                      size_t image_size)
 {
+    markUpdateStage("preUpdate");
+
     bool success = co_await preUpdate();
     if (!success)
     {
@@ -109,6 +154,8 @@ sdbusplus::async::task<bool> SPIDevice::updateDevice(const uint8_t* image,
         debug("ActivationBlocksTransition lifted for host power restore");
     }
 
+    markUpdateStage("postUpdate");
+
     if (!co_await postUpdate())
     {
         co_return false;
@@ -132,8 +179,13 @@ sdbusplus::async::task<bool> SPIDevice::postUpdate()
 const std::string spiAspeedSMCPath = "/sys/bus/platform/drivers/spi-aspeed-smc";
 const std::string spiNorPath = "/sys/bus/spi/drivers/spi-nor";
 
+// upper bound for the kernel to probe or remove a driver
+constexpr auto driverBindTimeout = std::chrono::seconds(10);
+
 sdbusplus::async::task<bool> SPIDevice::bindSPIFlash()
 {
+    UeventWaiter waiter(ctx);
+
     if (!SPIDevice::isSPIControllerBound())
     {
         debug("binding flash to SMC");
@@ -142,12 +194,8 @@ sdbusplus::async::task<bool> SPIDevice::bindSPIFlash()
         ofbind.close();
     }
 
-    const int driverBindSleepDuration = 2;
-
-    co_await sdbusplus::async::sleep_for(
-        ctx, std::chrono::seconds(driverBindSleepDuration));
-
-    if (!isSPIControllerBound())
+    if (!co_await waiter.waitFor([this] { return isSPIControllerBound(); },
+                                 driverBindTimeout))
     {
         error("failed to bind spi controller");
         co_return false;
@@ -160,10 +208,8 @@ sdbusplus::async::task<bool> SPIDevice::bindSPIFlash()
     ofbindSPINor << name;
     ofbindSPINor.close();
 
-    co_await sdbusplus::async::sleep_for(
-        ctx, std::chrono::seconds(driverBindSleepDuration));
-
-    if (!isSPIFlashBound())
+    if (!co_await waiter.waitFor([this] { return isSPIFlashBound(); },
+                                 driverBindTimeout))
     {
         error("failed to bind spi flash (spi-nor driver)");
         co_return false;
@@ -176,6 +222,8 @@ sdbusplus::async::task<bool> SPIDevice::unbindSPIFlash()
 {
     debug("unbinding flash");
 
+    UeventWaiter waiter(ctx);
+
     const std::string name =
         std::format("spi{}.{}", spiControllerIndex, spiDeviceIndex);
 
@@ -183,10 +231,8 @@ sdbusplus::async::task<bool> SPIDevice::unbindSPIFlash()
     ofunbind << name;
     ofunbind.close();
 
-    // wait for kernel
-    co_await sdbusplus::async::sleep_for(ctx, std::chrono::seconds(2));
-
-    co_return !isSPIFlashBound();
+    co_return co_await waiter.waitFor([this] { return !isSPIFlashBound(); },
+                                      driverBindTimeout);
 }
 
 bool SPIDevice::isSPIControllerBound()
@@ -230,9 +276,13 @@ sdbusplus::async::task<bool> SPIDevice::writeSPIFlash(const uint8_t* image,
         co_return false;
     }
 
+    markUpdateStage("bind");
+
     bool success = co_await SPIDevice::bindSPIFlash();
     if (success)
     {
+        markUpdateStage("write");
+
         if (dryRun)
         {
             info("dry run, NOT writing to the chip");
@@ -251,11 +301,6 @@ sdbusplus::async::task<bool> SPIDevice::writeSPIFlash(const uint8_t* image,
                         spiDeviceIndex);
                 }
             }
-            else if (tool == flashToolFlashcp)
-            {
-                success = co_await SPIDevice::writeSPIFlashWithFlashcp(
-                    image, image_size);
-            }
             else
             {
                 success =
@@ -263,6 +308,8 @@ sdbusplus::async::task<bool> SPIDevice::writeSPIFlash(const uint8_t* image,
             }
         }
 
+        markUpdateStage("unbind");
+
         success = success && co_await SPIDevice::unbindSPIFlash();
     }
 
@@ -320,17 +367,18 @@ sdbusplus::async::task<bool> SPIDevice::writeSPIFlashWithFlashrom(
 
     std::string cmd = "flashrom -p linux_mtd:dev=" + std::to_string(devNum);
 
-    if (layout == flashLayoutFlat)
-    {
-        cmd += " -w " + path;
-    }
-    else
+    if (layout == flashLayoutIntelFlashDescriptor && !regions.empty())
     {
-        error("unsupported flash layout");
+        cmd += " --ifd";
 
-        co_return 1;
+        for (const auto& region : regions)
+        {
+            cmd += " -i " + region;
+        }
     }
 
+    cmd += " -w " + path;
+
     debug("[flashrom] running {CMD}", "CMD", cmd);
 
     auto success = co_await asyncSystem(ctx, cmd);
@@ -340,50 +388,62 @@ sdbusplus::async::task<bool> SPIDevice::writeSPIFlashWithFlashrom(
     co_return success;
 }
 
-sdbusplus::async::task<bool> SPIDevice::writeSPIFlashWithFlashcp(
-    const uint8_t* image, size_t image_size) const
+std::optional<std::vector<spi::FlashRegion>> SPIDevice::getRegionsToWrite(
+    std::span<const uint8_t> image, const mtd::MTDFlash& flash) const
 {
-    // randomize the name to enable parallel updates
-    const std::string path = "/tmp/spi-device-image-" +
-                             std::to_string(Software::getRandomId()) + ".bin";
-
-    int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
-    if (fd < 0)
+    if (layout == flashLayoutFlat)
     {
-        error("Failed to open file: {PATH}", "PATH", path);
-        co_return 1;
+        return std::vector<spi::FlashRegion>{{"", 0, image.size()}};
     }
 
-    const ssize_t bytesWritten = write(fd, image, image_size);
+    auto imageRegions =
+        spi::parseIntelFlashDescriptor(image, flash.getInfo().size);
 
-    close(fd);
-
-    setUpdateProgress(30);
+    if (!imageRegions.has_value())
+    {
+        error("Image does not have a valid Intel Flash Descriptor");
+        return std::nullopt;
+    }
 
-    if (bytesWritten < 0 || static_cast<size_t>(bytesWritten) != image_size)
+    if (regions.empty())
     {
-        error("Failed to write image to file");
-        co_return 1;
+        return imageRegions;
     }
 
-    debug("wrote {SIZE} bytes to {PATH}", "SIZE", bytesWritten, "PATH", path);
+    // A partial update keeps the other regions where they are, which is only
+    // safe if the descriptor on the flash describes the same layout.
+    std::vector<uint8_t> descriptor(spi::descriptorSize);
+    std::optional<std::vector<spi::FlashRegion>> flashRegions;
 
-    auto devPath = getMTDDevicePath();
+    if (flash.read(descriptor, 0))
+    {
+        flashRegions = spi::parseIntelFlashDescriptor(descriptor,
+                                                      flash.getInfo().size);
+    }
 
-    if (!devPath.has_value())
+    if (flashRegions != imageRegions)
     {
-        co_return 1;
+        error(
+            "Flash layout differs from the image, cannot update only some regions");
+        return std::nullopt;
     }
 
-    std::string cmd = std::format("flashcp -v {} {}", path, devPath.value());
+    std::vector<spi::FlashRegion> selected;
 
-    debug("running {CMD}", "CMD", cmd);
+    for (const auto& name : regions)
+    {
+        auto region = spi::findRegion(imageRegions.value(), name);
 
-    auto success = co_await asyncSystem(ctx, cmd);
+        if (!region.has_value())
+        {
+            error("Region {NAME} is not in the flash layout", "NAME", name);
+            return std::nullopt;
+        }
 
-    std::filesystem::remove(path);
+        selected.push_back(region.value());
+    }
 
-    co_return success;
+    return selected;
 }
 
 sdbusplus::async::task<bool> SPIDevice::writeSPIFlashDefault(
@@ -396,49 +456,63 @@ sdbusplus::async::task<bool> SPIDevice::writeSPIFlashDefault(
         co_return false;
     }
 
-    int fd = open(devPath.value().c_str(), O_WRONLY);
-    if (fd < 0)
+    // flashes behind different controllers are programmed in parallel
+    auto flash =
+        mtd::MTDFlash::open(devPath.value(), getUpdateBus().value_or(""));
+
+    if (!flash)
     {
-        error("Failed to open device: {PATH}", "PATH", devPath.value());
         co_return false;
     }
 
-    // Write the image in chunks to avoid blocking for too long.
-    // Also, to provide meaningful progress updates.
+    const std::span<const uint8_t> imageSpan(image, image_size);
 
-    const size_t chunk = static_cast<size_t>(1024 * 1024);
-    ssize_t bytesWritten = 0;
+    auto toWrite = getRegionsToWrite(imageSpan, *flash);
 
-    const int progressStart = 30;
-    const int progressEnd = 90;
+    if (!toWrite.has_value())
+    {
+        co_return false;
+    }
 
-    for (size_t offset = 0; offset < image_size; offset += chunk)
+    size_t total = 0;
+    for (const auto& region : toWrite.value())
     {
-        const ssize_t written =
-            write(fd, image + offset, std::min(chunk, image_size - offset));
+        total += region.size;
+    }
 
-        if (written < 0)
-        {
-            error("Failed to write to device");
-            co_return false;
-        }
+    const int progressStart = 30;
+    const int progressEnd = 90;
 
-        bytesWritten += written;
+    // bytes of the regions which were written before the current one
+    size_t base = 0;
 
+    auto progress = [this, &base, total](size_t done, size_t) {
+        setUpdateBytes(base + done, total);
         setUpdateProgress(
             progressStart + int((progressEnd - progressStart) *
-                                (double(offset) / double(image_size))));
-    }
-
-    close(fd);
+                                (double(base + done) / double(total))));
+    };
 
-    if (static_cast<size_t>(bytesWritten) != image_size)
+    for (const auto& region : toWrite.value())
     {
-        error("Incomplete write to device");
-        co_return false;
+        if (!region.name.empty())
+        {
+            info("Writing flash region {NAME}: {SIZE} bytes at {OFFSET}",
+                 "NAME", region.name, "SIZE", region.size, "OFFSET",
+                 region.offset);
+        }
+
+        if (!co_await flash->write(
+                ctx, imageSpan.subspan(region.offset, region.size),
+                region.offset, progress, writeMode))
+        {
+            co_return false;
+        }
+
+        base += region.size;
     }
 
-    debug("Successfully wrote {NBYTES} bytes to {PATH}", "NBYTES", bytesWritten,
+    debug("Successfully wrote {NBYTES} bytes to {PATH}", "NBYTES", total,
           "PATH", devPath.value());
 
     co_return true;
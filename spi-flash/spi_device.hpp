@@ -1,14 +1,18 @@
 #pragma once
 
 #include "common/include/device.hpp"
+#include "common/include/mtd_flash.hpp"
 #include "common/include/software.hpp"
 #include "common/include/software_manager.hpp"
+#include "flash_layout.hpp"
 
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/asio/object_server.hpp>
 #include <sdbusplus/async/context.hpp>
 
+#include <span>
 #include <string>
+#include <vector>
 
 class SPIDevice;
 
@@ -25,9 +29,8 @@ enum FlashLayout
 
 enum FlashTool
 {
-    flashToolNone,     // write directly to the mtd device
+    flashToolNone,     // erase, program and verify the mtd device in process
     flashToolFlashrom, // use flashrom, to handle e.g. IFD
-    flashToolFlashcp,
 };
 
 class SPIDevice : public Device
@@ -39,7 +42,8 @@ class SPIDevice : public Device
               const std::vector<std::string>& gpioLinesIn,
               const std::vector<bool>& gpioValuesIn, SoftwareConfig& config,
               SoftwareManager* parent, enum FlashLayout layout,
-              enum FlashTool tool);
+              enum FlashTool tool,
+              const std::vector<std::string>& regions = {});
 
     ~SPIDevice() override = default;
     SPIDevice(const SPIDevice&) = delete;
@@ -50,6 +54,15 @@ class SPIDevice : public Device
     sdbusplus::async::task<bool> updateDevice(const uint8_t* image,
                                               size_t image_size) final;
 
+    // @brief         Maps the component image instead of reading it into
+    //                memory, flash images are tens of megabytes.
+    sdbusplus::async::task<bool> updateDeviceStreaming(
+        const ComponentReader& component) final;
+
+    std::optional<std::string> getUpdateBus() const final;
+
+    std::set<std::string> getUpdateResources() const override;
+
     // @returns       the version which is externally provided.
     virtual std::string getVersion() = 0;
 
@@ -74,6 +87,10 @@ class SPIDevice : public Device
 
     enum FlashTool tool;
 
+    // names of the flash regions to update with a structured layout,
+    // e.g. "bios", all regions of the image if empty
+    std::vector<std::string> regions;
+
     // @returns          true on success
     sdbusplus::async::task<bool> bindSPIFlash();
 
@@ -93,7 +110,9 @@ class SPIDevice : public Device
     // - host is powered off
     // - gpio / mux is set
     // - spi device is bound to the driver
-    // we write the flat image here
+    // we erase, program and verify the image here, in process, either
+    // flat or the selected regions of the layout,
+    // only the erase blocks which changed with 'spi-incremental-flash'
     // @param image           the component image
     // @param image_size      size of 'image'
     // @returns               true on success
@@ -112,15 +131,12 @@ class SPIDevice : public Device
     sdbusplus::async::task<bool> writeSPIFlashWithFlashrom(
         const uint8_t* image, size_t image_size) const;
 
-    // @description preconditions:
-    // - host is powered off
-    // - gpio / mux is set
-    // - spi device is bound to the driver
     // @param image           the component image
-    // @param image_size      size of 'image'
-    // @returns               true on success
-    sdbusplus::async::task<bool> writeSPIFlashWithFlashcp(
-        const uint8_t* image, size_t image_size) const;
+    // @param flash           the flash to be written
+    // @returns               the parts of 'image' to write, by layout and
+    //                        selected regions, nullopt on error
+    std::optional<std::vector<spi::FlashRegion>> getRegionsToWrite(
+        std::span<const uint8_t> image, const mtd::MTDFlash& flash) const;
 
     // @returns nullopt on error
     std::optional<std::string> getMTDDevicePath() const;
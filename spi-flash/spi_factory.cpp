@@ -15,7 +15,8 @@ std::unique_ptr<SPIDevice> SPIFactory::create(
     const std::string& chipType, sdbusplus::async::context& ctx,
     uint64_t spiControllerIndex, uint64_t spiDeviceIndex, bool dryRun,
     const std::vector<std::string>& names, const std::vector<bool>& values,
-    SoftwareConfig& config, SoftwareManager* parent)
+    SoftwareConfig& config, SoftwareManager* parent, enum FlashLayout layout,
+    const std::vector<std::string>& regions)
 {
     if (chipType == getSpiTypeStr(spiChip::INTEL_HOST_BIOS) ||
         chipType == getSpiTypeStr(spiChip::HOST_BIOS))
@@ -24,7 +25,7 @@ std::unique_ptr<SPIDevice> SPIFactory::create(
         {
             return std::make_unique<BIOSDevice>(
                 ctx, spiControllerIndex, spiDeviceIndex, dryRun, names, values,
-                config, parent);
+                config, parent, layout, regions);
         }
         catch (const std::exception& e)
         {
@@ -52,7 +52,8 @@ class SPIFactory
         const std::string& chipType, sdbusplus::async::context& ctx,
         uint64_t spiControllerIndex, uint64_t spiDeviceIndex, bool dryRun,
         const std::vector<std::string>& names, const std::vector<bool>& values,
-        SoftwareConfig& config, SoftwareManager* parent);
+        SoftwareConfig& config, SoftwareManager* parent,
+        enum FlashLayout layout, const std::vector<std::string>& regions);
 
     static std::vector<std::string> getConfigInterfaceNames();
 };
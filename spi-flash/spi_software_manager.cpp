@@ -1,5 +1,6 @@
 #include "spi_software_manager.hpp"
 
+#include "common/include/config_cache.hpp"
 #include "common/include/dbus_helper.hpp"
 #include "spi_factory.hpp"
 
@@ -71,12 +72,43 @@ sdbusplus::async::task<bool> SPISoftwareManager::initDevice(
         values.push_back((polarity == "High") ? 1 : 0);
     }
 
+    // Layout and UpdateRegions are optional
+    auto& cache = config::ConfigCache::instance();
+
+    std::optional<std::string> layoutName =
+        co_await cache.getProperty<std::string>(ctx, service, path,
+                                                configIface, "Layout");
+
+    enum FlashLayout layout = flashLayoutFlat;
+
+    if (layoutName == "IntelFlashDescriptor")
+    {
+        layout = flashLayoutIntelFlashDescriptor;
+    }
+    else if (layoutName.has_value() && layoutName != "Flat")
+    {
+        error("Unsupported flash layout: {LAYOUT}", "LAYOUT",
+              layoutName.value());
+        co_return false;
+    }
+
+    std::vector<std::string> regions =
+        (co_await cache.getProperty<std::vector<std::string>>(
+             ctx, service, path, configIface, "UpdateRegions"))
+            .value_or(std::vector<std::string>{});
+
+    if (!regions.empty() && layout == flashLayoutFlat)
+    {
+        error("UpdateRegions needs a structured flash layout");
+        co_return false;
+    }
+
     debug("SPI device: {INDEX1}:{INDEX2}", "INDEX1", spiControllerIndex.value(),
           "INDEX2", spiDeviceIndex.value());
 
     auto spiDevice = SPIFactory::instance().create(
         chipType, ctx, spiControllerIndex.value(), spiDeviceIndex.value(),
-        dryRun, names, values, config, this);
+        dryRun, names, values, config, this, layout, regions);
 
     if (spiDevice == nullptr)
     {
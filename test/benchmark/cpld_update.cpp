@@ -0,0 +1,368 @@
+#include "cpld/altera/max10_standard_cpld.hpp"
+#include "cpld/lattice/lattice_xo3_cpld.hpp"
+#include "update_benchmark.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <atomic>
+#include <bitset>
+#include <cstdlib>
+#include <format>
+#include <map>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace phosphor::software::cpld;
+using namespace phosphor::software::benchmark;
+using phosphor::i2c::DeviceModel;
+using phosphor::i2c::ScriptedDevice;
+using phosphor::i2c::Simulator;
+
+// Heap allocations of the driver, the i2c scheduler and the simulator
+static std::atomic<uint64_t> allocations = 0;
+// set while a device model runs, its allocations are not the driver's
+static thread_local bool inModel = false;
+
+void* operator new(size_t size)
+{
+    if (!inModel)
+    {
+        allocations++;
+    }
+
+    if (void* ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace lattice
+{
+
+constexpr uint16_t address = 0x40;
+constexpr size_t pageSize = 16;
+constexpr size_t pageCount = 256;
+constexpr uint32_t userCode = 0x00010203;
+
+static uint8_t reverseBits(uint8_t byte)
+{
+    uint8_t reversed = 0;
+    for (int bit = 0; bit < 8; bit++)
+    {
+        reversed |= ((byte >> bit) & 1) << (7 - bit);
+    }
+    return reversed;
+}
+
+// JED file with 'pageCount' pages of configuration data
+static std::string image()
+{
+    std::string jed = "QF" + std::to_string(pageCount * pageSize * 8) + "*\n";
+    jed += "L000000\n";
+
+    uint32_t checksum = 0;
+    for (size_t page = 0; page < pageCount; page++)
+    {
+        for (size_t i = 0; i < pageSize; i++)
+        {
+            const auto byte = static_cast<uint8_t>(page * 7 + i);
+            jed += std::bitset<8>(byte).to_string();
+            checksum += reverseBits(byte);
+        }
+        jed += "\n";
+    }
+
+    jed += "*\nNOTE END CONFIG DATA*\n";
+    jed += "NOTE User Electronic Signature Data*\n";
+    jed += std::format("UH{:08X}*\n", userCode);
+    jed += std::format("C{:04X}*\n", checksum & 0xFFFF);
+
+    return jed;
+}
+
+// Flash with page addressing and read back, always ready and never failing
+static std::shared_ptr<ScriptedDevice> model()
+{
+    auto device = std::make_shared<ScriptedDevice>();
+    auto flash = std::make_shared<std::map<uint16_t, std::vector<uint8_t>>>();
+    auto pageAddress = std::make_shared<uint16_t>(0);
+
+    device->respond(commandReadDeviceId, {0x61, 0x2b, 0xc0, 0x43});
+    device->respond(commandReadFwVersion, {0x00, 0x01, 0x02, 0x03});
+
+    device->onWrite(commandSetPageAddress,
+                    [pageAddress](std::span<const uint8_t> payload) {
+                        if (payload.size() < 7)
+                        {
+                            return false;
+                        }
+                        *pageAddress = (payload[5] << 8) | payload[6];
+                        return true;
+                    });
+
+    device->onWrite(commandProgramPage,
+                    [flash, pageAddress](std::span<const uint8_t> payload) {
+                        if (payload.size() < 3)
+                        {
+                            return false;
+                        }
+                        (*flash)[*pageAddress].assign(payload.begin() + 3,
+                                                      payload.end());
+                        return true;
+                    });
+
+    // the last two operand bytes of the read page command hold the count
+    auto readCount = std::make_shared<uint16_t>(1);
+
+    device->onWrite(commandReadPage,
+                    [readCount](std::span<const uint8_t> payload) {
+                        if (payload.size() < 3)
+                        {
+                            return false;
+                        }
+                        *readCount = (payload[1] << 8) | payload[2];
+                        return true;
+                    });
+
+    device->onRead(commandReadPage, [flash, pageAddress, readCount]() {
+        std::vector<uint8_t> data;
+        for (uint16_t page = 0; page < *readCount; page++)
+        {
+            auto& content = (*flash)[*pageAddress + page];
+            content.resize(pageSize, 0);
+            data.insert(data.end(), content.begin(), content.end());
+        }
+        return data;
+    });
+
+    return device;
+}
+
+// Forwards to a model without counting its allocations, and samples the
+// allocation count whenever a page is programmed.
+class AllocationProbe : public DeviceModel
+{
+  public:
+    explicit AllocationProbe(std::shared_ptr<DeviceModel> model) :
+        model(std::move(model))
+    {
+        samples.reserve(pageCount);
+    }
+
+    bool write(std::span<const uint8_t> data) override
+    {
+        const uint64_t count = allocations;
+
+        inModel = true;
+        if (!data.empty() && data[0] == commandProgramPage)
+        {
+            samples.push_back(count);
+        }
+        const bool result = model->write(data);
+        inModel = false;
+
+        return result;
+    }
+
+    bool read(std::span<uint8_t> data) override
+    {
+        inModel = true;
+        const bool result = model->read(data);
+        inModel = false;
+
+        return result;
+    }
+
+    // @returns       allocations from programming one page to the next
+    double perPage() const
+    {
+        if (samples.size() < pageCount)
+        {
+            return -1;
+        }
+
+        return double(samples[pageCount - 1] - samples[0]) / (pageCount - 1);
+    }
+
+  private:
+    std::shared_ptr<DeviceModel> model;
+    std::vector<uint64_t> samples;
+};
+
+} // namespace lattice
+
+namespace max10
+{
+
+constexpr uint16_t address = 0x41;
+
+// Only part of CFM0 is programmed, to keep the benchmark short: the driver
+// writes and polls every word, so the time scales linearly with the size.
+constexpr uint32_t startAddr = 0x0004A000;
+constexpr uint32_t endAddr = startAddr + 16 * 1024;
+
+constexpr uint32_t csrBase = 0x00200020;
+constexpr uint32_t csrCtrl = csrBase + 0x04;
+constexpr uint32_t sectorEraseShift = 20;
+constexpr uint32_t sectorEraseNone = 0x7;
+constexpr uint32_t statusWriteSuccess = 0x08;
+constexpr uint32_t statusEraseSuccess = 0x10;
+
+// RPD image of the programmed range
+static std::vector<uint8_t> image()
+{
+    std::vector<uint8_t> rpd(endAddr - startAddr);
+    for (size_t i = 0; i < rpd.size(); i++)
+    {
+        rpd[i] = static_cast<uint8_t>(i * 13);
+    }
+    return rpd;
+}
+
+// On-chip flash behind an Avalon-MM bridge: a 4 byte register address,
+// followed by a little endian value on writes or by a read of the value.
+// Erase and write complete right away.
+class Model : public DeviceModel
+{
+  public:
+    bool write(std::span<const uint8_t> data) override
+    {
+        if (data.size() < 4)
+        {
+            return false;
+        }
+
+        reg = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+
+        if (data.size() < 8)
+        {
+            // register address of a following read
+            return true;
+        }
+
+        const uint32_t value =
+            data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24);
+
+        if (reg == csrCtrl)
+        {
+            ctrl = value;
+            const auto erase = (value >> sectorEraseShift) & sectorEraseNone;
+            if (erase != sectorEraseNone)
+            {
+                status = statusEraseSuccess;
+            }
+        }
+        else if (reg >= startAddr && reg < endAddr)
+        {
+            flash[reg] = value;
+            status = statusWriteSuccess;
+        }
+
+        return true;
+    }
+
+    bool read(std::span<uint8_t> data) override
+    {
+        uint32_t value = 0;
+        if (reg == csrBase)
+        {
+            value = status;
+        }
+        else if (reg == csrCtrl)
+        {
+            value = ctrl;
+        }
+
+        for (size_t i = 0; i < data.size() && i < 4; i++)
+        {
+            data[i] = (value >> (8 * i)) & 0xFF;
+        }
+
+        return true;
+    }
+
+  private:
+    uint32_t reg = 0;
+    uint32_t ctrl = 0xFFFFFFFF;
+    uint32_t status = 0;
+    std::map<uint32_t, uint32_t> flash;
+};
+
+} // namespace max10
+
+sdbusplus::async::task<> run(
+    sdbusplus::async::context& ctx, const std::shared_ptr<Simulator>& simulator,
+    const std::shared_ptr<lattice::AllocationProbe>& probe, bool& success)
+{
+    success = true;
+
+    {
+        LatticeXO3CPLD cpld(ctx, simulatedBus, lattice::address,
+                            "LCMXO3LF-4300C", "", false);
+        const auto jed = lattice::image();
+
+        success &= co_await timeUpdate(
+            "LatticeXO3CPLD", *simulator,
+            [&]() -> sdbusplus::async::task<bool> {
+                co_return co_await cpld.updateFirmware(
+                    reinterpret_cast<const uint8_t*>(jed.data()), jed.size(),
+                    [](int) { return true; });
+            });
+
+        // The page commands are built in fixed size frames. What is left are
+        // the coroutine frames of the driver and of each transfer, and the
+        // status register buffer of waitBusyAndVerify.
+        std::printf("%-16s %8.1f allocations per programmed page\n",
+                    "LatticeXO3CPLD", probe->perPage());
+    }
+
+    {
+        Max10Profile profile{};
+        profile.startAddr = max10::startAddr;
+        profile.endAddr = max10::endAddr;
+
+        Max10StandardCPLD cpld(ctx, simulatedBus, max10::address,
+                               "MAX10_10M16", "AlteraMAX10_10M16Firmware",
+                               profile);
+        const auto rpd = max10::image();
+
+        success &= co_await timeUpdate(
+            "Max10StandardCPLD", *simulator,
+            [&]() -> sdbusplus::async::task<bool> {
+                co_return co_await cpld.updateFirmware(
+                    false, rpd.data(), rpd.size(), [](int) { return true; });
+            });
+    }
+
+    ctx.request_stop();
+}
+
+int main()
+{
+    sdbusplus::async::context ctx;
+
+    auto simulator = installSimulator(ctx);
+    auto probe = std::make_shared<lattice::AllocationProbe>(lattice::model());
+    simulator->addDevice(simulatedBus, lattice::address, probe);
+    simulator->addDevice(simulatedBus, max10::address,
+                         std::make_shared<max10::Model>());
+
+    bool success = false;
+    ctx.spawn(run(ctx, simulator, probe, success));
+    ctx.run();
+
+    return success ? 0 : 1;
+}
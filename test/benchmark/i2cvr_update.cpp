@@ -0,0 +1,360 @@
+#include "i2c-vr/isl69269/isl69269.hpp"
+#include "i2c-vr/mps/mp2x6xx.hpp"
+#include "i2c-vr/xdpe1x2xx/xdpe1x2xx.hpp"
+#include "update_benchmark.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <array>
+#include <cstdio>
+#include <format>
+#include <string>
+#include <vector>
+
+using namespace phosphor::software::VR;
+using namespace phosphor::software::benchmark;
+using phosphor::i2c::ScriptedDevice;
+using phosphor::i2c::Simulator;
+
+// Number of register writes in the generated images
+constexpr size_t registerCount = 300;
+
+namespace isl
+{
+
+constexpr uint16_t address = 0x60;
+constexpr uint32_t deviceId = 0x49D28100;
+constexpr uint32_t deviceCRC = 0x12345678;
+
+constexpr uint8_t regDMAData = 0xC5;
+constexpr uint8_t regDMAAddr = 0xC7;
+constexpr uint8_t gen2RegProgStatus = 0x07;
+constexpr uint8_t gen2RegCRC = 0x3F;
+constexpr uint8_t gen2RegRemainingWrites = 0xC2;
+
+static uint8_t crc8(const std::vector<uint8_t>& data)
+{
+    uint8_t crc = 0;
+    for (auto byte : data)
+    {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static std::string hexLine(const std::vector<uint8_t>& bytes)
+{
+    std::string line;
+    for (auto byte : bytes)
+    {
+        line += std::format("{:02X}", byte);
+    }
+    return line + "\n";
+}
+
+// Gen2 hex file: a format and a device id header, then register writes
+static std::string image()
+{
+    std::string hex;
+    hex += hexLine({0x49, 0x03, address << 1, 0x00, 0x00});
+    hex += hexLine({0x49, 0x06, address << 1, 0xAD, (deviceId >> 24) & 0xFF,
+                    (deviceId >> 16) & 0xFF, (deviceId >> 8) & 0xFF,
+                    deviceId & 0xFF});
+
+    for (size_t i = 0; i < registerCount; i++)
+    {
+        std::vector<uint8_t> data = {address << 1, 0xE0,
+                                     static_cast<uint8_t>(i),
+                                     static_cast<uint8_t>(i >> 8)};
+        std::vector<uint8_t> line = {0x00,
+                                     static_cast<uint8_t>(data.size() + 1)};
+        line.insert(line.end(), data.begin(), data.end());
+        line.push_back(crc8(data));
+        hex += hexLine(line);
+    }
+
+    return hex;
+}
+
+static std::shared_ptr<ScriptedDevice> model()
+{
+    auto device = std::make_shared<ScriptedDevice>();
+    auto dmaAddr = std::make_shared<uint8_t>(0);
+
+    device->onWrite(regDMAAddr, [dmaAddr](std::span<const uint8_t> payload) {
+        *dmaAddr = payload.empty() ? 0 : payload[0];
+        return true;
+    });
+
+    device->onRead(regDMAData, [dmaAddr]() -> std::vector<uint8_t> {
+        switch (*dmaAddr)
+        {
+            case gen2RegRemainingWrites:
+                return {28};
+            case gen2RegProgStatus:
+                return {0x01};
+            case gen2RegCRC:
+                return {deviceCRC & 0xFF, (deviceCRC >> 8) & 0xFF,
+                        (deviceCRC >> 16) & 0xFF, deviceCRC >> 24};
+            default:
+                return {};
+        }
+    });
+
+    device->respond(0xAD, {4, deviceId & 0xFF, (deviceId >> 8) & 0xFF,
+                           (deviceId >> 16) & 0xFF, deviceId >> 24});
+    device->respond(0xAE, {4, 0x03, 0x00, 0x00, 0x02});
+
+    return device;
+}
+
+} // namespace isl
+
+namespace mps
+{
+
+constexpr uint16_t address = 0x61;
+constexpr uint32_t productId = 0x2856;
+constexpr uint16_t configId = 0x0101;
+constexpr uint16_t crcUser = 0xBEEF;
+
+// Type1 ATE image, all registers in configuration 0
+static std::string image()
+{
+    std::string ate;
+    auto addLine = [&ate](uint8_t page, uint8_t reg, const std::string& name,
+                          uint32_t value) {
+        ate += std::format("{:X}\t{:X}\t{:X}\t{}\t{}\t{:04X}\t{}\tW\n",
+                           configId, page, reg, reg, name, value, value);
+    };
+
+    addLine(0, 0x9A, "TRIM_MFR_PRODUCT_ID2", productId);
+    for (size_t i = 0; i < registerCount; i++)
+    {
+        addLine(i % 2, 0x20 + (i % 0x80), "MFR_REG", i);
+    }
+    addLine(0, 0xED, "CRC_USER", crcUser);
+    ate += "END\n";
+
+    return ate;
+}
+
+static std::shared_ptr<ScriptedDevice> model()
+{
+    auto device = std::make_shared<ScriptedDevice>();
+
+    device->respond(0x99, {3, 0x53, 0x50, 0x4D});
+    device->respond(0xAD, {4, productId & 0xFF, productId >> 8, 0, 0});
+    device->respond(0x9E, {configId & 0xFF, configId >> 8});
+    device->respond(0xED, {crcUser & 0xFF, crcUser >> 8});
+
+    return device;
+}
+
+} // namespace mps
+
+namespace xdpe
+{
+
+constexpr uint16_t address = 0x62;
+
+// XDPE192C3E revision E, the remaining writes are reported in bytes of OTP
+constexpr uint8_t deviceId = 0xB8;
+constexpr uint8_t deviceRev = 0x04;
+constexpr uint32_t configSize = 1532;
+constexpr uint32_t scratchPadAddress = 0x2005e400;
+
+constexpr uint8_t cmdFwData = 0xFD;
+constexpr uint8_t cmdFw = 0xFE;
+constexpr uint8_t fwCmdRemaining = 0x10;
+constexpr uint8_t fwCmdGetCRC = 0x2D;
+constexpr uint8_t fwCmdGetHWAddress = 0x2E;
+
+// Sections of the generated image, each programmed one word per transfer
+constexpr std::array<uint8_t, 2> sectionTypes = {0x03, 0x05};
+constexpr size_t sectionWords = 24;
+
+// Same CRC as the driver, over 32 bit words, lsb first
+static uint32_t crc32(const std::vector<uint32_t>& words)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (auto word : words)
+    {
+        crc ^= word;
+        for (int bit = 0; bit < 32; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+        }
+    }
+    return ~crc;
+}
+
+// Configuration file: each section starts with its type, a header word and
+// the CRC of both, and ends with the CRC of the words in between. The
+// checksum in the header is the sum of all section CRCs.
+static std::string image()
+{
+    std::string data;
+    uint32_t checksum = 0;
+
+    for (auto type : sectionTypes)
+    {
+        std::vector<uint32_t> words = {type, sectionWords};
+        words.push_back(crc32(words));
+
+        std::vector<uint32_t> payload;
+        for (size_t i = 0; i < sectionWords - 4; i++)
+        {
+            payload.push_back(static_cast<uint32_t>(type << 24 | i));
+        }
+        words.insert(words.end(), payload.begin(), payload.end());
+        words.push_back(crc32(payload));
+
+        checksum += words[2] + words.back();
+
+        for (size_t i = 0; i < words.size(); i += 4)
+        {
+            data += std::format("{:03X}", i * 4);
+            for (size_t j = i; j < i + 4 && j < words.size(); j++)
+            {
+                data += std::format(" {:08X}", words[j]);
+            }
+            data += "\n";
+        }
+    }
+
+    std::string file;
+    file += std::format("PMBus Address : 0x{:X}\n", address);
+    file += std::format("Checksum : 0x{:08X}\n", checksum);
+    file += "[Configuration Data]\n";
+    file += data;
+    file += "[End Configuration Data]\n";
+
+    return file;
+}
+
+// Firmware commands take their argument and return their result through
+// the data register, which answers with a block of 4 bytes.
+static std::shared_ptr<ScriptedDevice> model()
+{
+    auto device = std::make_shared<ScriptedDevice>();
+    auto result = std::make_shared<uint32_t>(0);
+
+    device->onWrite(cmdFw, [result](std::span<const uint8_t> payload) {
+        if (payload.empty())
+        {
+            return false;
+        }
+
+        switch (payload[0])
+        {
+            case fwCmdRemaining:
+                *result = 20 * configSize;
+                break;
+            case fwCmdGetCRC:
+                *result = 0;
+                break;
+            case fwCmdGetHWAddress:
+                *result = scratchPadAddress;
+                break;
+            default:
+                *result = 0;
+                break;
+        }
+        return true;
+    });
+
+    device->onRead(cmdFwData, [result]() -> std::vector<uint8_t> {
+        return {4, static_cast<uint8_t>(*result & 0xFF),
+                static_cast<uint8_t>((*result >> 8) & 0xFF),
+                static_cast<uint8_t>((*result >> 16) & 0xFF),
+                static_cast<uint8_t>(*result >> 24)};
+    });
+
+    device->respond(0xAD, {2, deviceRev, deviceId});
+
+    return device;
+}
+
+} // namespace xdpe
+
+sdbusplus::async::task<> run(sdbusplus::async::context& ctx,
+                             const std::shared_ptr<Simulator>& simulator,
+                             bool& success)
+{
+    success = true;
+
+    {
+        auto vr = std::make_unique<ISL69269>(ctx, simulatedBus, isl::address,
+                                             ISL69269::Gen::Gen2);
+        const auto hex = isl::image();
+
+        success &= co_await timeUpdate(
+            "ISL69269", *simulator,
+            [&]() -> sdbusplus::async::task<bool> {
+                if (!co_await vr->verifyImage(
+                        reinterpret_cast<const uint8_t*>(hex.data()),
+                        hex.size()))
+                {
+                    co_return false;
+                }
+                co_return co_await vr->updateFirmware(false);
+            });
+    }
+
+    {
+        auto vr = std::make_unique<MP2X6XX>(ctx, simulatedBus, mps::address);
+        const auto ate = mps::image();
+
+        success &= co_await timeUpdate(
+            "MP2X6XX", *simulator,
+            [&]() -> sdbusplus::async::task<bool> {
+                if (!co_await vr->verifyImage(
+                        reinterpret_cast<const uint8_t*>(ate.data()),
+                        ate.size()))
+                {
+                    co_return false;
+                }
+                co_return co_await vr->updateFirmware(false);
+            });
+    }
+
+    {
+        auto vr = std::make_unique<XDPE1X2XX>(ctx, simulatedBus, xdpe::address);
+        const auto config = xdpe::image();
+
+        success &= co_await timeUpdate(
+            "XDPE1X2XX", *simulator,
+            [&]() -> sdbusplus::async::task<bool> {
+                if (!co_await vr->verifyImage(
+                        reinterpret_cast<const uint8_t*>(config.data()),
+                        config.size()))
+                {
+                    co_return false;
+                }
+                co_return co_await vr->updateFirmware(false);
+            });
+    }
+
+    ctx.request_stop();
+}
+
+int main()
+{
+    sdbusplus::async::context ctx;
+
+    auto simulator = installSimulator(ctx);
+    simulator->addDevice(simulatedBus, isl::address, isl::model());
+    simulator->addDevice(simulatedBus, mps::address, mps::model());
+    simulator->addDevice(simulatedBus, xdpe::address, xdpe::model());
+
+    bool success = false;
+    ctx.spawn(run(ctx, simulator, success));
+    ctx.run();
+
+    return success ? 0 : 1;
+}
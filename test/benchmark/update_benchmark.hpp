@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common/include/i2c/i2c_scheduler.hpp"
+#include "common/include/i2c/i2c_simulator.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace phosphor::software::benchmark
+{
+
+// Bus timing of a 400 kHz bus: 9 clocks per byte plus start, address and stop
+constexpr auto transferLatency = std::chrono::microseconds(50);
+constexpr auto byteLatency = std::chrono::microseconds(23);
+
+constexpr uint16_t simulatedBus = 7;
+
+// @brief  Install a simulator as i2c backend for all devices created afterwards
+inline std::shared_ptr<phosphor::i2c::Simulator> installSimulator(
+    sdbusplus::async::context& ctx)
+{
+    auto simulator = std::make_shared<phosphor::i2c::Simulator>();
+    simulator->setLatency(transferLatency, byteLatency);
+
+    phosphor::i2c::Backend::install(simulator);
+    phosphor::i2c::I2CScheduler::instance().attach(ctx);
+
+    return simulator;
+}
+
+// @brief  Time 'update' and print the result in a line per driver
+// @returns  true if the update succeeded
+template <typename Update>
+sdbusplus::async::task<bool> timeUpdate(
+    const std::string& driver, const phosphor::i2c::Simulator& simulator,
+    Update update)
+{
+    const auto transfersBefore = simulator.transfers();
+    const auto start = std::chrono::steady_clock::now();
+
+    const bool success = co_await update();
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    std::printf("%-16s %s %8lld ms %8llu transfers\n", driver.c_str(),
+                success ? "ok    " : "FAILED",
+                static_cast<long long>(elapsed.count()),
+                static_cast<unsigned long long>(simulator.transfers() -
+                                                transfersBefore));
+
+    co_return success;
+}
+
+} // namespace phosphor::software::benchmark
@@ -0,0 +1,98 @@
+#include "../exampledevice/example_device.hpp"
+#include "common/include/component_reader.hpp"
+#include "common/pldm/pldm_package_util.hpp"
+#include "test/create_package/create_pldm_fw_package.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::software;
+using namespace phosphor::software::example_device;
+
+// @returns memfd with a package for the example device
+// @returns -1 on failure
+static int createTestPkgMemfd()
+{
+    uint8_t component_image[] = {0x12, 0x34, 0x83, 0x21};
+
+    size_t sizeOut;
+    std::unique_ptr<uint8_t[]> buf = create_pldm_package_buffer(
+        component_image, sizeof(component_image),
+        std::optional<uint32_t>(exampleVendorIANA),
+        std::optional<std::string>(exampleCompatibleHardware), sizeOut);
+
+    const int fd = memfd_create("test_memfd", 0);
+
+    EXPECT_TRUE(fd >= 0);
+
+    if (fd < 0 || write(fd, (void*)buf.get(), sizeOut) == -1 ||
+        lseek(fd, 0, SEEK_SET) != 0)
+    {
+        ADD_FAILURE() << "Failed to create the package: " << strerror(errno);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+
+    return fd;
+}
+
+TEST(ComponentReaderTest, TestReadsOnlyComponent)
+{
+    const int fd = createTestPkgMemfd();
+
+    ASSERT_TRUE(fd >= 0);
+
+    size_t size = 0;
+    auto header = pldm_package_util::mmapImagePackageLazily(fd, &size);
+
+    ASSERT_NE(header, nullptr);
+
+    auto package = pldm_package_util::parsePLDMPackage(
+        static_cast<uint8_t*>(header.get()), size);
+
+    ASSERT_NE(package, nullptr);
+
+    uint32_t offset = 0;
+    size_t componentSize = 0;
+    std::string version;
+
+    EXPECT_EQ(pldm_package_util::extractMatchingComponentImage(
+                  static_cast<uint8_t*>(header.get()), package,
+                  exampleCompatibleHardware, exampleVendorIANA, &offset,
+                  &componentSize, version),
+              0);
+
+    ComponentReader reader(fd, offset, componentSize);
+
+    close(fd);
+
+    const std::vector<uint8_t> expected = {0x12, 0x34, 0x83, 0x21};
+
+    std::vector<uint8_t> data;
+    EXPECT_TRUE(reader.readAll(data));
+    EXPECT_EQ(data, expected);
+
+    std::array<uint8_t, 8> buf{};
+    EXPECT_EQ(reader.read(1, buf), 3);
+    EXPECT_EQ(buf[0], 0x34);
+    EXPECT_EQ(reader.read(4, buf), 0);
+
+    // the component does not start on a page boundary of the package
+    auto mapping = reader.map();
+
+    ASSERT_NE(mapping, nullptr);
+    EXPECT_TRUE(std::ranges::equal(mapping->data(), expected));
+}
@@ -2,6 +2,7 @@
 #include "test/create_package/create_pldm_fw_package.hpp"
 
 #include <sys/mman.h>
+#include <unistd.h>
 
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/asio/connection.hpp>
@@ -180,6 +181,47 @@ sdbusplus::async::task<> testDeviceStartUpdateInvalidFD(
     co_return;
 }
 
+sdbusplus::async::task<> testDeviceSkipsProgrammedImage(
+    sdbusplus::async::context& ctx, std::unique_ptr<ExampleDevice>& device)
+{
+    // the image of the test package
+    device->programmedImage = std::vector<uint8_t>{0x12, 0x34, 0x83, 0x21};
+
+    const int fd = DeviceTest::createTestPkgMemfd();
+
+    EXPECT_TRUE(fd >= 0);
+
+    if (fd < 0)
+    {
+        co_return;
+    }
+
+    std::unique_ptr<Software> softwareUpdate =
+        std::make_unique<Software>(ctx, *device);
+
+    const Software* newSoftware = softwareUpdate.get();
+
+    const bool success = co_await device->startUpdateAsync(
+        fd, RequestedApplyTimes::Immediate, std::move(softwareUpdate));
+
+    // reported as successful, without programming the device
+    EXPECT_TRUE(success);
+    EXPECT_FALSE(device->deviceSpecificUpdateFunctionCalled);
+    EXPECT_EQ(device->softwareCurrent.get(), newSoftware);
+
+    close(fd);
+
+    ctx.request_stop();
+
+    co_return;
+}
+
+TEST_F(DeviceTest, TestDeviceSkipsProgrammedImage)
+{
+    ctx.spawn(testDeviceSkipsProgrammedImage(ctx, device));
+    ctx.run();
+}
+
 TEST_F(DeviceTest, TestDeviceStartUpdateInvalidFD)
 {
     ctx.spawn(testDeviceStartUpdateInvalidFD(ctx, device));
@@ -123,8 +123,9 @@ class FWUpdateEventsTest : public ::testing::Test
     auto testVerificationFailedAssertDeassert() -> sdbusplus::async::task<void>
     {
         eventServer.expectedEvent = error_intf::VerificationFailed::errName;
-        co_await events.generateVerificationFailed(targetObjectPath,
-                                                   imageIdentifier, true);
+        events.generateVerificationFailed(targetObjectPath, imageIdentifier,
+                                          true);
+        co_await events.flush();
 
         EXPECT_FALSE(eventServer.eventEntries.empty())
             << "Event entry should be created after assert";
@@ -133,8 +134,9 @@ class FWUpdateEventsTest : public ::testing::Test
 
         co_await sdbusplus::async::sleep_for(ctx, 1s);
 
-        co_await events.generateVerificationFailed(targetObjectPath,
-                                                   imageIdentifier, false);
+        events.generateVerificationFailed(targetObjectPath, imageIdentifier,
+                                          false);
+        co_await events.flush();
 
         EXPECT_TRUE(eventServer.eventEntries.back()->isResolved)
             << "Event should be resolved after deassert";
@@ -145,8 +147,8 @@ class FWUpdateEventsTest : public ::testing::Test
     auto testActivateFailedAssertDeassert() -> sdbusplus::async::task<void>
     {
         eventServer.expectedEvent = error_intf::ActivateFailed::errName;
-        co_await events.generateActivateFailed(targetObjectPath,
-                                               imageIdentifier, true);
+        events.generateActivateFailed(targetObjectPath, imageIdentifier, true);
+        co_await events.flush();
 
         EXPECT_FALSE(eventServer.eventEntries.empty())
             << "Event entry should be created after assert";
@@ -155,8 +157,8 @@ class FWUpdateEventsTest : public ::testing::Test
 
         co_await sdbusplus::async::sleep_for(ctx, 1s);
 
-        co_await events.generateActivateFailed(targetObjectPath,
-                                               imageIdentifier, false);
+        events.generateActivateFailed(targetObjectPath, imageIdentifier, false);
+        co_await events.flush();
 
         EXPECT_TRUE(eventServer.eventEntries.back()->isResolved)
             << "Event should be resolved after deassert";
@@ -167,8 +169,9 @@ class FWUpdateEventsTest : public ::testing::Test
     auto testUpdateNotApplicableAssertDeassert() -> sdbusplus::async::task<void>
     {
         eventServer.expectedEvent = error_intf::UpdateNotApplicable::errName;
-        co_await events.generateUpdateNotApplicable(targetObjectPath,
-                                                    imageIdentifier, true);
+        events.generateUpdateNotApplicable(targetObjectPath, imageIdentifier,
+                                           true);
+        co_await events.flush();
 
         EXPECT_FALSE(eventServer.eventEntries.empty())
             << "Event entry should be created after assert";
@@ -177,8 +180,9 @@ class FWUpdateEventsTest : public ::testing::Test
 
         co_await sdbusplus::async::sleep_for(ctx, 1s);
 
-        co_await events.generateUpdateNotApplicable(targetObjectPath,
-                                                    imageIdentifier, false);
+        events.generateUpdateNotApplicable(targetObjectPath, imageIdentifier,
+                                           false);
+        co_await events.flush();
 
         EXPECT_TRUE(eventServer.eventEntries.back()->isResolved)
             << "Event should be resolved after deassert";
@@ -186,11 +190,29 @@ class FWUpdateEventsTest : public ::testing::Test
         ctx.request_stop();
     }
 
+    auto testAssertDeassertQueuedInOrder() -> sdbusplus::async::task<void>
+    {
+        eventServer.expectedEvent = error_intf::VerificationFailed::errName;
+        events.generateVerificationFailed(targetObjectPath, imageIdentifier,
+                                          true);
+        events.generateVerificationFailed(targetObjectPath, imageIdentifier,
+                                          false);
+        co_await events.flush();
+
+        EXPECT_EQ(events.queued(), 0);
+        EXPECT_FALSE(eventServer.eventEntries.empty())
+            << "Event entry should be created after assert";
+        EXPECT_TRUE(eventServer.eventEntries.back()->isResolved)
+            << "Deassert should be committed after the assert";
+
+        ctx.request_stop();
+    }
+
     auto testTargetDetermined() -> sdbusplus::async::task<void>
     {
         eventServer.expectedEvent = event_intf::TargetDetermined::errName;
-        co_await events.generateTargetDetermined(targetObjectPath,
-                                                 imageIdentifier);
+        events.generateTargetDetermined(targetObjectPath, imageIdentifier);
+        co_await events.flush();
 
         ctx.request_stop();
     }
@@ -198,8 +220,8 @@ class FWUpdateEventsTest : public ::testing::Test
     auto testUpdateSuccessful() -> sdbusplus::async::task<void>
     {
         eventServer.expectedEvent = event_intf::UpdateSuccessful::errName;
-        co_await events.generateUpdateSuccessful(targetObjectPath,
-                                                 imageIdentifier);
+        events.generateUpdateSuccessful(targetObjectPath, imageIdentifier);
+        co_await events.flush();
 
         ctx.request_stop();
     }
@@ -207,8 +229,9 @@ class FWUpdateEventsTest : public ::testing::Test
     auto testResetRequired() -> sdbusplus::async::task<void>
     {
         eventServer.expectedEvent = event_intf::ResetRequired::errName;
-        co_await events.generateResetRequired(
-            targetObjectPath, EventIntf::HostTransition::Reboot);
+        events.generateResetRequired(targetObjectPath,
+                                     EventIntf::HostTransition::Reboot);
+        co_await events.flush();
 
         ctx.request_stop();
     }
@@ -235,6 +258,12 @@ TEST_F(FWUpdateEventsTest, TestUpdateNotApplicableAssertDeassert)
     ctx.run();
 }
 
+TEST_F(FWUpdateEventsTest, TestAssertDeassertQueuedInOrder)
+{
+    ctx.spawn(testAssertDeassertQueuedInOrder());
+    ctx.run();
+}
+
 TEST_F(FWUpdateEventsTest, TestTargetDetermined)
 {
     ctx.spawn(testTargetDetermined());
@@ -128,6 +128,19 @@ sdbusplus::async::task<bool> ExampleDevice::updateDevice(
     co_return true;
 }
 
+sdbusplus::async::task<bool> ExampleDevice::isImageProgrammed(
+    const ComponentReader& component)
+{
+    std::vector<uint8_t> image;
+
+    if (!programmedImage.has_value() || !component.readAll(image))
+    {
+        co_return false;
+    }
+
+    co_return image == programmedImage.value();
+}
+
 ExampleSoftware::ExampleSoftware(sdbusplus::async::context& ctx,
                                  ExampleDevice& parent) : Software(ctx, parent)
 {}
@@ -72,7 +72,14 @@ class ExampleDevice : public Device
     sdbusplus::async::task<bool> updateDevice(const uint8_t* image,
                                               size_t image_size) override;
 
+    // Compares the component with 'programmedImage'.
+    sdbusplus::async::task<bool> isImageProgrammed(
+        const ComponentReader& component) override;
+
     bool deviceSpecificUpdateFunctionCalled = false;
+
+    // image the device holds, if known
+    std::optional<std::vector<uint8_t>> programmedImage;
 };
 
 } // namespace phosphor::software::example_device
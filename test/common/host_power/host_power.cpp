@@ -0,0 +1,251 @@
+#include "common/include/host_power.hpp"
+
+#include <sdbusplus/async.hpp>
+#include <xyz/openbmc_project/Common/error.hpp>
+#include <xyz/openbmc_project/State/Host/aserver.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+using namespace phosphor::software::host_power;
+
+class TestHost;
+
+using HostIntf =
+    sdbusplus::aserver::xyz::openbmc_project::state::Host<TestHost>;
+using Transition =
+    sdbusplus::client::xyz::openbmc_project::state::Host<>::Transition;
+
+// time the fake host takes to power on or off
+constexpr auto transitionTime = 100ms;
+
+// Fake host state service, which reaches the requested state after
+// 'transitionTime', or rejects the request if 'failTransitions' is set.
+class TestHost : public HostIntf
+{
+  public:
+    TestHost(sdbusplus::async::context& ctx,
+             const sdbusplus::object_path& path) : HostIntf(ctx, path), ctx(ctx)
+    {
+        current_host_state(stateOn);
+    }
+
+    auto set_property(requested_host_transition_t /*unused*/,
+                      Transition value) -> bool
+    {
+        requests.push_back(value);
+
+        if (failTransitions)
+        {
+            throw sdbusplus::xyz::openbmc_project::Common::Error::
+                Unavailable();
+        }
+
+        ctx.spawn(changeState(value == Transition::Off ? stateOff : stateOn));
+
+        return true;
+    }
+
+    std::vector<Transition> requests;
+    bool failTransitions = false;
+
+  private:
+    sdbusplus::async::task<> changeState(HostState state)
+    {
+        co_await sdbusplus::async::sleep_for(ctx, transitionTime);
+        current_host_state(state);
+    }
+
+    sdbusplus::async::context& ctx;
+};
+
+class HostOffHoldTest : public testing::Test
+{
+  protected:
+    static constexpr auto serviceName = "xyz.openbmc_project.State.Host";
+
+    HostOffHoldTest() :
+        host(ctx, sdbusplus::object_path(
+                      sdbusplus::client::xyz::openbmc_project::state::Host<>::
+                          namespace_path::value) /
+                      "host0"),
+        hold(ctx)
+    {
+        ctx.request_name(serviceName);
+    }
+
+    sdbusplus::async::task<> acquire(std::optional<bool>& result)
+    {
+        result = co_await hold.acquire();
+    }
+
+    sdbusplus::async::task<> release(std::optional<bool>& result)
+    {
+        result = co_await hold.release();
+    }
+
+    // @brief         Wait until each of 'results' is set, or for 5 seconds
+    sdbusplus::async::task<> settle(
+        std::initializer_list<const std::optional<bool>*> results)
+    {
+        for (size_t i = 0; i < 500; i++)
+        {
+            if (std::ranges::all_of(results, [](const auto* result) {
+                    return result->has_value();
+                }))
+            {
+                break;
+            }
+
+            co_await sdbusplus::async::sleep_for(ctx, 10ms);
+        }
+    }
+
+    void run(sdbusplus::async::task<> test)
+    {
+        ctx.spawn(std::move(test));
+        ctx.run();
+    }
+
+    sdbusplus::async::context ctx;
+    TestHost host;
+    HostOffHold hold;
+};
+
+TEST_F(HostOffHoldTest, concurrentAcquireAndRelease)
+{
+    run([](HostOffHoldTest& t) -> sdbusplus::async::task<> {
+        std::optional<bool> first;
+        std::optional<bool> second;
+
+        t.ctx.spawn(t.acquire(first));
+        co_await sdbusplus::async::sleep_for(t.ctx, 10ms);
+
+        // arrives while the first acquire powers the host off
+        EXPECT_TRUE(t.hold.held());
+        t.ctx.spawn(t.acquire(second));
+
+        co_await t.settle({&first, &second});
+        EXPECT_EQ(first, true);
+        EXPECT_EQ(second, true);
+        EXPECT_EQ(t.host.requests, std::vector<Transition>{Transition::Off});
+        EXPECT_EQ(t.host.current_host_state(), stateOff);
+
+        std::optional<bool> released;
+        t.ctx.spawn(t.release(released));
+        co_await t.settle({&released});
+
+        // the other update still holds the host off
+        EXPECT_EQ(released, true);
+        EXPECT_TRUE(t.hold.held());
+        EXPECT_EQ(t.host.requests.size(), 1);
+
+        released.reset();
+        t.ctx.spawn(t.release(released));
+        co_await t.settle({&released});
+
+        EXPECT_EQ(released, true);
+        EXPECT_FALSE(t.hold.held());
+        EXPECT_EQ(t.host.requests,
+                  (std::vector<Transition>{Transition::Off, Transition::On}));
+        EXPECT_EQ(t.host.current_host_state(), stateOn);
+
+        t.ctx.request_stop();
+    }(*this));
+}
+
+TEST_F(HostOffHoldTest, acquireWaitsForRestore)
+{
+    run([](HostOffHoldTest& t) -> sdbusplus::async::task<> {
+        std::optional<bool> acquired;
+        t.ctx.spawn(t.acquire(acquired));
+        co_await t.settle({&acquired});
+        EXPECT_EQ(acquired, true);
+
+        std::optional<bool> released;
+        t.ctx.spawn(t.release(released));
+        co_await sdbusplus::async::sleep_for(t.ctx, 10ms);
+
+        // arrives while the release powers the host back on
+        acquired.reset();
+        t.ctx.spawn(t.acquire(acquired));
+
+        co_await t.settle({&released, &acquired});
+        EXPECT_EQ(released, true);
+        EXPECT_EQ(acquired, true);
+        EXPECT_TRUE(t.hold.held());
+        EXPECT_EQ(t.host.requests,
+                  (std::vector<Transition>{Transition::Off, Transition::On,
+                                           Transition::Off}));
+        EXPECT_EQ(t.host.current_host_state(), stateOff);
+
+        released.reset();
+        t.ctx.spawn(t.release(released));
+        co_await t.settle({&released});
+        EXPECT_EQ(released, true);
+
+        t.ctx.request_stop();
+    }(*this));
+}
+
+TEST_F(HostOffHoldTest, failedPowerOff)
+{
+    run([](HostOffHoldTest& t) -> sdbusplus::async::task<> {
+        t.host.failTransitions = true;
+
+        std::optional<bool> acquired;
+        t.ctx.spawn(t.acquire(acquired));
+        co_await t.settle({&acquired});
+
+        EXPECT_EQ(acquired, false);
+        EXPECT_FALSE(t.hold.held());
+        EXPECT_EQ(t.host.current_host_state(), stateOn);
+
+        // nothing to release after a failed acquire
+        std::optional<bool> released;
+        t.ctx.spawn(t.release(released));
+        co_await t.settle({&released});
+        EXPECT_EQ(released, false);
+
+        // the next update tries again
+        t.host.failTransitions = false;
+        acquired.reset();
+        t.ctx.spawn(t.acquire(acquired));
+        co_await t.settle({&acquired});
+        EXPECT_EQ(acquired, true);
+        EXPECT_EQ(t.host.requests,
+                  (std::vector<Transition>{Transition::Off, Transition::Off}));
+
+        released.reset();
+        t.ctx.spawn(t.release(released));
+        co_await t.settle({&released});
+        EXPECT_EQ(released, true);
+
+        t.ctx.request_stop();
+    }(*this));
+}
+
+TEST_F(HostOffHoldTest, acquireIfOffKeepsHostOn)
+{
+    run([](HostOffHoldTest& t) -> sdbusplus::async::task<> {
+        EXPECT_FALSE(co_await t.hold.acquireIfOff());
+        EXPECT_FALSE(t.hold.held());
+
+        t.host.current_host_state(stateOff);
+
+        EXPECT_TRUE(co_await t.hold.acquireIfOff());
+        EXPECT_TRUE(t.hold.held());
+
+        // the host was off before, so it stays off
+        EXPECT_TRUE(co_await t.hold.release());
+        EXPECT_TRUE(t.host.requests.empty());
+        EXPECT_EQ(t.host.current_host_state(), stateOff);
+
+        t.ctx.request_stop();
+    }(*this));
+}
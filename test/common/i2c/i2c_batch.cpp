@@ -0,0 +1,118 @@
+#include "common/include/i2c/i2c.hpp"
+#include "common/include/i2c/i2c_simulator.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::i2c;
+
+class I2CBatchTest : public testing::Test
+{
+  protected:
+    I2CBatchTest()
+    {
+        device->respond(0x01, {0xAA, 0xBB});
+        simulator->addDevice(1, 0x40, device);
+        Backend::install(simulator);
+        // opened after the backend is installed, so it transfers through it
+        i2c = std::make_unique<I2C>(1, 0x40);
+    }
+
+    ~I2CBatchTest() override
+    {
+        i2c.reset();
+        Backend::install(nullptr);
+    }
+
+    bool send(I2CBatch& batch)
+    {
+        bool result = false;
+
+        auto run = [](sdbusplus::async::context& ctx, const I2C& i2c,
+                      I2CBatch& batch,
+                      bool& result) -> sdbusplus::async::task<> {
+            result = co_await i2c.sendBatch(batch);
+            ctx.request_stop();
+        };
+
+        ctx.spawn(run(ctx, *i2c, batch, result));
+        ctx.run();
+
+        return result;
+    }
+
+    sdbusplus::async::context ctx;
+    std::shared_ptr<Simulator> simulator = std::make_shared<Simulator>();
+    std::shared_ptr<ScriptedDevice> device =
+        std::make_shared<ScriptedDevice>();
+    std::unique_ptr<I2C> i2c;
+};
+
+TEST_F(I2CBatchTest, sendsInOneTransfer)
+{
+    I2CBatch batch;
+
+    const std::vector<uint8_t> select = {0x01};
+    const auto write = batch.write(select);
+    const auto read = batch.read(2);
+
+    ASSERT_TRUE(write.has_value());
+    ASSERT_TRUE(read.has_value());
+    EXPECT_FALSE(batch.succeeded(*read));
+
+    EXPECT_TRUE(send(batch));
+    EXPECT_EQ(simulator->transfers(), 1);
+
+    EXPECT_TRUE(batch.succeeded(*write));
+    EXPECT_TRUE(batch.readData(*write).empty());
+    EXPECT_EQ(std::vector<uint8_t>(batch.readData(*read).begin(),
+                                   batch.readData(*read).end()),
+              (std::vector<uint8_t>{0xAA, 0xBB}));
+}
+
+TEST_F(I2CBatchTest, failedTransferMarksNothingDone)
+{
+    device->onWrite(0x02, [](std::span<const uint8_t>) { return false; });
+
+    I2CBatch batch;
+
+    const std::vector<uint8_t> nacked = {0x02, 0x00};
+    const auto write = batch.write(nacked);
+    const auto read = batch.read(1);
+
+    EXPECT_FALSE(send(batch));
+    EXPECT_EQ(simulator->transfers(), 1);
+    EXPECT_FALSE(batch.succeeded(*write));
+    EXPECT_FALSE(batch.succeeded(*read));
+}
+
+TEST_F(I2CBatchTest, rejectsOversizedWrite)
+{
+    I2CBatch batch;
+
+    const std::vector<uint8_t> data(0x10000);
+    EXPECT_FALSE(batch.write(data).has_value());
+    EXPECT_TRUE(batch.empty());
+
+    EXPECT_TRUE(batch.write(std::span(data).first(0xFFFF)).has_value());
+}
+
+TEST_F(I2CBatchTest, rejectsMessagesBeyondOneTransfer)
+{
+    I2CBatch batch;
+
+    for (size_t i = 0; i < I2CBatch::maxMessages; i++)
+    {
+        ASSERT_TRUE(batch.read(1).has_value());
+    }
+
+    const std::vector<uint8_t> data = {0x01};
+    EXPECT_FALSE(batch.read(1).has_value());
+    EXPECT_FALSE(batch.write(data).has_value());
+    EXPECT_EQ(batch.size(), I2CBatch::maxMessages);
+}
@@ -0,0 +1,47 @@
+#include "common/include/i2c/frame.hpp"
+#include "common/include/utils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using phosphor::i2c::Frame;
+
+TEST(I2CFrameTest, behavesLikeVector)
+{
+    Frame frame = {0x1, 0x2};
+    frame.push_back(0x3);
+
+    std::vector<uint8_t> tail = {0x4, 0x5};
+    frame.insert(frame.end(), tail.begin(), tail.end());
+
+    EXPECT_EQ(frame.size(), 5);
+    EXPECT_EQ(frame.at(4), 0x5);
+    EXPECT_EQ(bytesToInt<uint16_t>(frame), 0x0201);
+
+    frame.resize(7);
+    EXPECT_EQ(frame[6], 0x0);
+
+    frame.clear();
+    EXPECT_TRUE(frame.empty());
+    EXPECT_THROW(frame.at(0), std::out_of_range);
+}
+
+TEST(I2CFrameTest, buildsSameBytesAsVector)
+{
+    const auto frame = buildBytes<Frame>(uint8_t{0x21}, uint16_t{0x1234});
+    const auto vector = buildByteVector(uint8_t{0x21}, uint16_t{0x1234});
+
+    EXPECT_EQ(vector, std::vector<uint8_t>({0x21, 0x34, 0x12}));
+    EXPECT_TRUE(std::ranges::equal(frame, vector));
+}
+
+TEST(I2CFrameTest, overflowThrows)
+{
+    Frame frame(Frame::capacity, 0xFF);
+
+    EXPECT_THROW(frame.push_back(0x0), std::length_error);
+    EXPECT_EQ(frame.size(), Frame::capacity);
+}
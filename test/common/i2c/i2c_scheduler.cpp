@@ -0,0 +1,200 @@
+#include "common/include/i2c/i2c.hpp"
+#include "common/include/i2c/i2c_backend.hpp"
+#include "common/include/i2c/i2c_scheduler.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::i2c;
+using namespace std::literals;
+
+// Backend which records the address of every transfer and holds the bus
+// until it is opened, so the test can queue transfers behind it.
+class GatedBackend : public Backend
+{
+  public:
+    bool transfer(uint16_t /*bus*/, struct i2c_msg* msgs,
+                  uint32_t /*nmsgs*/) override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        order.push_back(msgs[0].addr);
+        cv.wait(lock, [this] { return opened; });
+        return true;
+    }
+
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        opened = true;
+        cv.notify_all();
+    }
+
+    std::vector<uint16_t> transfers()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return order;
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<uint16_t> order;
+    bool opened = false;
+};
+
+class I2CSchedulerTest : public testing::Test
+{
+  protected:
+    I2CSchedulerTest()
+    {
+        Backend::install(backend);
+        I2CScheduler::instance().attach(ctx);
+    }
+
+    ~I2CSchedulerTest() override
+    {
+        backend->open();
+        join();
+        Backend::install(nullptr);
+    }
+
+    // @brief         Start a blocking transfer to 'device' on a thread of
+    //                its own, and wait until it is on the bus or queued.
+    void start(const I2C& device, Priority priority)
+    {
+        auto& scheduler = I2CScheduler::instance();
+        const size_t depth = scheduler.stats(device.bus()).queueDepth;
+
+        threads.emplace_back([&device, priority] {
+            uint8_t data = 0;
+            struct i2c_msg msg = {
+                .addr = device.address(), .flags = 0, .len = 1, .buf = &data};
+            EXPECT_TRUE(I2CScheduler::instance().transferBlocking(
+                device, &msg, 1, priority));
+        });
+
+        const auto deadline = std::chrono::steady_clock::now() + 1s;
+        while (scheduler.stats(device.bus()).queueDepth == depth &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        ASSERT_EQ(scheduler.stats(device.bus()).queueDepth, depth + 1);
+    }
+
+    // @returns       the addresses in the order the bus served them
+    std::vector<uint16_t> finish()
+    {
+        backend->open();
+        join();
+        return backend->transfers();
+    }
+
+    void join()
+    {
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+    }
+
+    sdbusplus::async::context ctx;
+    std::shared_ptr<GatedBackend> backend = std::make_shared<GatedBackend>();
+    std::vector<std::thread> threads;
+};
+
+TEST_F(I2CSchedulerTest, servesByPriority)
+{
+    I2C holder(1, 0x10);
+    I2C bulk(1, 0x11);
+    I2C normal(1, 0x12);
+    I2C high(1, 0x13);
+
+    const auto before = I2CScheduler::instance().stats(1).transactions;
+
+    start(holder, Priority::bulk);
+    start(bulk, Priority::bulk);
+    start(normal, Priority::normal);
+    start(high, Priority::high);
+
+    EXPECT_EQ(finish(), (std::vector<uint16_t>{0x10, 0x13, 0x12, 0x11}));
+    EXPECT_EQ(I2CScheduler::instance().stats(1).transactions - before, 4);
+    EXPECT_EQ(I2CScheduler::instance().stats(1).queueDepth, 0);
+}
+
+TEST_F(I2CSchedulerTest, agedJobGoesFirst)
+{
+    I2C holder(2, 0x20);
+    I2C bulk(2, 0x21);
+    I2C high(2, 0x22);
+
+    start(holder, Priority::normal);
+    start(bulk, Priority::bulk);
+    // longer than the 100 ms after which priorities are ignored
+    std::this_thread::sleep_for(150ms);
+    start(high, Priority::high);
+
+    EXPECT_EQ(finish(), (std::vector<uint16_t>{0x20, 0x21, 0x22}));
+}
+
+TEST_F(I2CSchedulerTest, roundRobinWithinPriority)
+{
+    I2C holder(3, 0x30);
+    I2C first(3, 0x31);
+    I2C second(3, 0x32);
+
+    start(holder, Priority::normal);
+    start(first, Priority::normal);
+    start(first, Priority::normal);
+    start(first, Priority::normal);
+    start(second, Priority::normal);
+
+    EXPECT_EQ(finish(),
+              (std::vector<uint16_t>{0x30, 0x31, 0x32, 0x31, 0x31}));
+}
+
+TEST_F(I2CSchedulerTest, blockingWaitIsBounded)
+{
+    I2C holder(4, 0x40);
+    I2C waiter(4, 0x41);
+
+    start(holder, Priority::bulk);
+
+    uint8_t data = 0;
+    struct i2c_msg msg = {.addr = 0x41, .flags = 0, .len = 1, .buf = &data};
+
+    const auto begin = std::chrono::steady_clock::now();
+    EXPECT_FALSE(I2CScheduler::instance().transferBlocking(waiter, &msg, 1,
+                                                           Priority::high));
+    EXPECT_GE(std::chrono::steady_clock::now() - begin,
+              I2CScheduler::maxBlockingWait);
+
+    // The abandoned transfer is dropped instead of done later
+    EXPECT_EQ(finish(), (std::vector<uint16_t>{0x40}));
+}
+
+TEST_F(I2CSchedulerTest, idleBusRunsOnCaller)
+{
+    I2C device(5, 0x50);
+    backend->open();
+
+    const auto before = I2CScheduler::instance().stats(5);
+
+    uint8_t data = 0;
+    struct i2c_msg msg = {.addr = 0x50, .flags = 0, .len = 1, .buf = &data};
+
+    EXPECT_TRUE(I2CScheduler::instance().transferBlocking(device, &msg, 1));
+    const auto after = I2CScheduler::instance().stats(5);
+    EXPECT_EQ(after.transactions - before.transactions, 1);
+    // not queued, so no wait was accounted
+    EXPECT_EQ(after.totalWait, before.totalWait);
+}
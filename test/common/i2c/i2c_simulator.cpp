@@ -0,0 +1,47 @@
+#include "common/include/i2c/i2c_simulator.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::i2c;
+
+TEST(I2CSimulatorTest, stopsAtFirstNack)
+{
+    Simulator simulator;
+
+    auto device = std::make_shared<ScriptedDevice>();
+    device->respond(0x01, {0xAA});
+    device->onWrite(0x02, [](std::span<const uint8_t>) { return false; });
+    simulator.addDevice(1, 0x40, device);
+
+    uint8_t nacked[] = {0x02, 0x00};
+    uint8_t select[] = {0x01};
+    uint8_t data[1] = {};
+    struct i2c_msg msgs[3] = {
+        {.addr = 0x40, .flags = 0, .len = 2, .buf = nacked},
+        {.addr = 0x40, .flags = 0, .len = 1, .buf = select},
+        {.addr = 0x40, .flags = I2C_M_RD, .len = 1, .buf = data},
+    };
+
+    // the messages after the NACK would succeed, but are not sent
+    EXPECT_FALSE(simulator.transfer(1, msgs, 3));
+    EXPECT_EQ(data[0], 0);
+    EXPECT_EQ(device->writeCount(0x01), 0);
+
+    EXPECT_TRUE(simulator.transfer(1, &msgs[1], 2));
+    EXPECT_EQ(data[0], 0xAA);
+}
+
+TEST(I2CSimulatorTest, nacksUnknownAddress)
+{
+    Simulator simulator;
+
+    uint8_t data[1] = {};
+    struct i2c_msg msg = {.addr = 0x41, .flags = 0, .len = 1, .buf = data};
+
+    EXPECT_FALSE(simulator.transfer(1, &msg, 1));
+    EXPECT_EQ(simulator.transfers(), 1);
+}
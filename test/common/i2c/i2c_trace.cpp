@@ -0,0 +1,55 @@
+#include "common/include/i2c/i2c_trace.hpp"
+
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::i2c;
+using std::chrono::microseconds;
+
+TEST(I2CTraceTest, latencyBuckets)
+{
+    EXPECT_EQ(DeviceTrace::bucket(microseconds(0)), 0);
+    EXPECT_EQ(DeviceTrace::bucket(microseconds(32)), 0);
+    EXPECT_EQ(DeviceTrace::bucket(microseconds(33)), 1);
+    EXPECT_EQ(DeviceTrace::bucket(microseconds(64)), 1);
+    EXPECT_EQ(DeviceTrace::bucket(std::chrono::hours(1)),
+              DeviceTrace::bucketCount - 1);
+}
+
+TEST(I2CTraceTest, recordsPerDevice)
+{
+    auto& trace = I2CTrace::instance();
+    trace.enable();
+
+    uint8_t writeBuf[3] = {};
+    uint8_t readBuf[2] = {};
+    struct i2c_msg msgs[2] = {
+        {.addr = 0x40, .flags = 0, .len = 3, .buf = writeBuf},
+        {.addr = 0x40, .flags = I2C_M_RD, .len = 2, .buf = readBuf},
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    trace.record(3, 0x40, msgs, 2, true, start);
+    trace.record(3, 0x40, msgs, 1, false, start);
+
+    auto devices = trace.snapshot();
+    ASSERT_TRUE(devices.contains({3, 0x40}));
+
+    const auto& device = devices.at({3, 0x40});
+    EXPECT_EQ(device.transactions, 2);
+    EXPECT_EQ(device.errors, 1);
+    EXPECT_EQ(device.bytesWritten, 6);
+    EXPECT_EQ(device.bytesRead, 2);
+
+    uint64_t histogramTotal = 0;
+    for (auto count : device.latency)
+    {
+        histogramTotal += count;
+    }
+    EXPECT_EQ(histogramTotal, 2);
+
+    EXPECT_NE(trace.dump().find("device 3-0040: transactions 2 errors 1"),
+              std::string::npos);
+}
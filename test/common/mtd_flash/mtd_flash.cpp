@@ -0,0 +1,146 @@
+#include "common/include/mtd_flash.hpp"
+
+#include <unistd.h>
+
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::software;
+
+sdbusplus::async::task<> testMTDFlashProgramsImage(
+    sdbusplus::async::context& ctx)
+{
+    constexpr size_t eraseSize = 16;
+
+    const std::string path = std::filesystem::temp_directory_path() /
+                             ("mtd-flash-test-" + std::to_string(getpid()));
+    {
+        // programming can only clear bits, so start from zeroes
+        std::ofstream file(path, std::ios::binary);
+        const std::vector<char> zeroes(8 * eraseSize, 0);
+        file.write(zeroes.data(), zeroes.size());
+    }
+
+    // the last block is only partially covered by the image
+    std::vector<uint8_t> image(3 * eraseSize + 5);
+    std::iota(image.begin(), image.end(), 1);
+
+    auto flash = mtd::MTDFlash::openFile(path, eraseSize);
+    EXPECT_NE(flash, nullptr);
+
+    size_t lastDone = 0;
+    const bool success = co_await flash->write(
+        ctx, image, 2 * eraseSize, [&lastDone](size_t done, size_t total) {
+            EXPECT_GE(done, lastDone);
+            EXPECT_LE(done, total);
+            lastDone = done;
+        });
+
+    EXPECT_TRUE(success);
+    EXPECT_EQ(lastDone, image.size());
+
+    // image does not fit
+    EXPECT_FALSE(co_await flash->write(ctx, image, 6 * eraseSize, {}));
+
+    // only the second block differs, unchanged blocks still count as done
+    image[eraseSize + 3] = 0x00;
+    lastDone = 0;
+    EXPECT_TRUE(co_await flash->write(
+        ctx, image, 2 * eraseSize,
+        [&lastDone](size_t done, size_t) { lastDone = done; },
+        mtd::WriteMode::incremental));
+    EXPECT_EQ(lastDone, image.size());
+
+    flash.reset();
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
+    std::filesystem::remove(path);
+
+    // the rest of the last block is written back as it was
+    std::vector<uint8_t> expected(8 * eraseSize, 0);
+    std::ranges::copy(image, expected.begin() + 2 * eraseSize);
+
+    EXPECT_EQ(content, expected);
+
+    ctx.request_stop();
+
+    co_return;
+}
+
+TEST(MTDFlashTest, TestMTDFlashProgramsImage)
+{
+    sdbusplus::async::context ctx;
+
+    ctx.spawn(testMTDFlashProgramsImage(ctx));
+    ctx.run();
+}
+
+sdbusplus::async::task<> testMTDFlashKeepsNeighbouringRegions(
+    sdbusplus::async::context& ctx)
+{
+    // flash descriptor regions are 4 KiB granular, erase blocks are larger
+    constexpr size_t eraseSize = 64 * 1024;
+    constexpr size_t regionSize = 4096;
+
+    const std::string path =
+        std::filesystem::temp_directory_path() /
+        ("mtd-flash-region-test-" + std::to_string(getpid()));
+
+    std::vector<uint8_t> expected(2 * eraseSize);
+    std::iota(expected.begin(), expected.end(), 7);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(expected.data()),
+                   expected.size());
+    }
+
+    auto flash = mtd::MTDFlash::openFile(path, eraseSize);
+    EXPECT_NE(flash, nullptr);
+
+    const std::vector<uint8_t> region(regionSize, 0x5a);
+
+    size_t lastDone = 0;
+    EXPECT_TRUE(co_await flash->write(
+        ctx, region, 3 * regionSize,
+        [&lastDone](size_t done, size_t) { lastDone = done; }));
+    EXPECT_EQ(lastDone, region.size());
+
+    // a region across two erase blocks
+    EXPECT_TRUE(co_await flash->write(ctx, region, eraseSize - regionSize / 2,
+                                      {}, mtd::WriteMode::incremental));
+
+    flash.reset();
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
+    std::filesystem::remove(path);
+
+    std::ranges::copy(region, expected.begin() + 3 * regionSize);
+    std::ranges::copy(region, expected.begin() + eraseSize - regionSize / 2);
+
+    EXPECT_EQ(content, expected);
+
+    ctx.request_stop();
+
+    co_return;
+}
+
+TEST(MTDFlashTest, TestMTDFlashKeepsNeighbouringRegions)
+{
+    sdbusplus::async::context ctx;
+
+    ctx.spawn(testMTDFlashKeepsNeighbouringRegions(ctx));
+    ctx.run();
+}
@@ -0,0 +1,75 @@
+#include "../exampledevice/example_device.hpp"
+#include "common/pldm/pldm_package_util.hpp"
+#include "test/create_package/create_pldm_fw_package.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::software;
+using namespace phosphor::software::example_device;
+
+// @returns memfd with a package for the example device
+// @returns -1 on failure
+static int createTestPkgMemfd()
+{
+    uint8_t component_image[] = {0x12, 0x34, 0x83, 0x21};
+
+    size_t sizeOut;
+    std::unique_ptr<uint8_t[]> buf = create_pldm_package_buffer(
+        component_image, sizeof(component_image),
+        std::optional<uint32_t>(exampleVendorIANA),
+        std::optional<std::string>(exampleCompatibleHardware), sizeOut);
+
+    const int fd = memfd_create("test_memfd", 0);
+
+    EXPECT_TRUE(fd >= 0);
+
+    if (fd < 0 || write(fd, (void*)buf.get(), sizeOut) == -1 ||
+        lseek(fd, 0, SEEK_SET) != 0)
+    {
+        ADD_FAILURE() << "Failed to create the package: " << strerror(errno);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+
+    return fd;
+}
+
+TEST(PackageIndexTest, TestSharedPerPackage)
+{
+    const int fd = createTestPkgMemfd();
+
+    ASSERT_TRUE(fd >= 0);
+
+    auto index = pldm_package_util::PackageIndex::get(fd);
+
+    ASSERT_NE(index, nullptr);
+
+    // a second device consuming the same package reuses the index
+    EXPECT_EQ(pldm_package_util::PackageIndex::get(fd), index);
+
+    pldm_package_util::ComponentLocation component{};
+
+    EXPECT_EQ(
+        index->find(exampleVendorIANA, exampleCompatibleHardware, component),
+        0);
+    EXPECT_EQ(component.size, 4);
+
+    EXPECT_NE(index->find(exampleVendorIANA + 1, exampleCompatibleHardware,
+                          component),
+              0);
+    EXPECT_NE(index->find(exampleVendorIANA, "com.example.Other", component),
+              0);
+
+    close(fd);
+}
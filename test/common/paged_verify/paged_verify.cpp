@@ -0,0 +1,96 @@
+#include "common/include/paged_verify.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::software;
+
+sdbusplus::async::task<> testPagedVerifierRepairsPages(
+    sdbusplus::async::context& ctx)
+{
+    constexpr size_t pageSize = 4;
+    constexpr size_t pagesPerSector = 4;
+
+    std::vector<uint8_t> image(8 * pageSize);
+    std::iota(image.begin(), image.end(), 0);
+
+    // flash programming can only clear bits, erasing sets them
+    std::vector<uint8_t> flash = image;
+    flash[1 * pageSize] |= 0x80; // page 1 can be programmed again
+    flash[5 * pageSize] = 0x00;  // page 5 needs its sector to be erased
+
+    paged::PagedVerifier verifier(image, pageSize, 3, pagesPerSector);
+
+    verifier.setProgramPage(
+        [&flash](size_t page, std::span<const uint8_t> data)
+            -> sdbusplus::async::task<bool> {
+            for (size_t i = 0; i < data.size(); i++)
+            {
+                flash[page * pageSize + i] &= data[i];
+            }
+            co_return true;
+        },
+        paged::ProgramBits::clear);
+    verifier.setEraseSector(
+        [&flash](size_t sector) -> sdbusplus::async::task<bool> {
+            const size_t sectorSize = pagesPerSector * pageSize;
+            std::fill_n(flash.begin() + sector * sectorSize, sectorSize, 0xff);
+            co_return true;
+        });
+
+    paged::VerifyReport report;
+    const bool success = co_await verifier.verify(
+        [&flash](size_t first, size_t count,
+                 std::vector<uint8_t>& data) -> sdbusplus::async::task<bool> {
+            const auto begin = flash.begin() + first * pageSize;
+            data.assign(begin, begin + count * pageSize);
+            co_return true;
+        },
+        3, report);
+
+    EXPECT_TRUE(success);
+    EXPECT_EQ(flash, image);
+    EXPECT_EQ(report.mismatched, (std::vector<size_t>{1, 5}));
+    EXPECT_EQ(report.reprogrammedPages, 1);
+    EXPECT_EQ(report.rewrittenSectors, 1);
+    EXPECT_EQ(report.passes, 2);
+
+    ctx.request_stop();
+
+    co_return;
+}
+
+TEST(PagedVerifierTest, TestPagedVerifierRepairsPages)
+{
+    sdbusplus::async::context ctx;
+
+    ctx.spawn(testPagedVerifierRepairsPages(ctx));
+    ctx.run();
+}
+
+TEST(PagedVerifierTest, TestCanProgramOverFollowsProgramBits)
+{
+    const std::vector<uint8_t> current = {0xf0};
+    const std::vector<uint8_t> cleared = {0x30};
+    const std::vector<uint8_t> set = {0xf3};
+
+    using paged::PagedVerifier;
+    using paged::ProgramBits;
+
+    EXPECT_TRUE(
+        PagedVerifier::canProgramOver(current, cleared, ProgramBits::clear));
+    EXPECT_FALSE(
+        PagedVerifier::canProgramOver(current, set, ProgramBits::clear));
+    EXPECT_TRUE(PagedVerifier::canProgramOver(current, set, ProgramBits::set));
+    EXPECT_FALSE(
+        PagedVerifier::canProgramOver(current, cleared, ProgramBits::set));
+    EXPECT_FALSE(
+        PagedVerifier::canProgramOver(current, cleared, ProgramBits::unknown));
+}
@@ -0,0 +1,67 @@
+#include "common/include/progress_publisher.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::software;
+
+TEST(ProgressPublisherTest, TestProgressCoalescedAndMonotonic)
+{
+    std::vector<uint8_t> published;
+
+    ProgressPublisher publisher(
+        [&published](uint8_t progress) { published.push_back(progress); },
+        std::chrono::hours(1));
+
+    // the first value is published right away
+    EXPECT_TRUE(publisher.update(10));
+
+    // values within the interval are held back
+    EXPECT_FALSE(publisher.update(20));
+    EXPECT_FALSE(publisher.update(30));
+
+    // values going backwards are dropped
+    EXPECT_FALSE(publisher.update(5));
+
+    publisher.flush();
+
+    // completion is never held back
+    EXPECT_TRUE(publisher.update(100));
+
+    EXPECT_EQ(published, (std::vector<uint8_t>{10, 30, 100}));
+    EXPECT_EQ(publisher.progress(), 100);
+}
+
+TEST(ProgressPublisherTest, TestHeldBackValueScheduled)
+{
+    std::vector<uint8_t> published;
+    std::vector<std::chrono::milliseconds> scheduled;
+
+    ProgressPublisher publisher(
+        [&published](uint8_t progress) { published.push_back(progress); },
+        std::chrono::hours(1),
+        [&scheduled](std::chrono::milliseconds delay) {
+            scheduled.push_back(delay);
+        });
+
+    EXPECT_TRUE(publisher.update(10));
+    EXPECT_TRUE(scheduled.empty());
+
+    // the first value held back arms one flush for the end of the interval
+    EXPECT_FALSE(publisher.update(20));
+    EXPECT_FALSE(publisher.update(30));
+    ASSERT_EQ(scheduled.size(), 1);
+    EXPECT_GT(scheduled[0], std::chrono::minutes(59));
+    EXPECT_LE(scheduled[0], std::chrono::hours(1));
+
+    // the owner flushes when the delay is over
+    publisher.flush();
+    EXPECT_EQ(published, (std::vector<uint8_t>{10, 30}));
+
+    // and the next value held back arms another one
+    EXPECT_FALSE(publisher.update(40));
+    EXPECT_EQ(scheduled.size(), 2);
+}
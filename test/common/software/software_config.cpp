@@ -1,4 +1,5 @@
 
+#include "common/include/config_cache.hpp"
 #include "common/include/software_config.hpp"
 
 #include <fcntl.h>
@@ -6,6 +7,7 @@
 #include <unistd.h>
 
 #include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/async.hpp>
 
 #include <gtest/gtest.h>
 
@@ -55,3 +57,44 @@ TEST(SoftwareConfig, FailureCompatibleInvalidChar)
     catch (std::exception& /*unused*/)
     {}
 }
+
+sdbusplus::async::task<> testConfigCacheLookup(sdbusplus::async::context& ctx)
+{
+    auto& cache = ConfigCache::instance();
+    const std::string intf = "xyz.openbmc_project.Configuration.Example";
+
+    cache.update(objPath, intf,
+                 {{"Bus", uint64_t(5)}, {"Name", std::string("VR0")}});
+
+    // served from the cache, the service does not exist
+    auto bus = co_await cache.getProperty<uint64_t>(ctx, "invalid.service",
+                                                    objPath, intf, "Bus");
+    EXPECT_EQ(bus, 5);
+
+    auto name = co_await cache.getProperty<std::string>(
+        ctx, "invalid.service", objPath, intf, "Name");
+    EXPECT_EQ(name, "VR0");
+
+    // wrong type
+    auto wrongType = co_await cache.getProperty<std::string>(
+        ctx, "invalid.service", objPath, intf, "Bus");
+    EXPECT_FALSE(wrongType.has_value());
+
+    cache.update(objPath, intf, {{"Bus", uint64_t(6)}});
+    bus = co_await cache.getProperty<uint64_t>(ctx, "invalid.service", objPath,
+                                               intf, "Bus");
+    EXPECT_EQ(bus, 6);
+
+    ctx.request_stop();
+
+    co_return;
+}
+
+TEST(SoftwareConfig, ConfigCacheLookup)
+{
+    sdbusplus::async::context ctx;
+
+    ctx.spawn(testConfigCacheLookup(ctx));
+
+    ctx.run();
+}
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <regex>
+#include <set>
 
 #include <gtest/gtest.h>
 
@@ -50,3 +51,20 @@ TEST(SoftwareTest, testGetRandomSoftwareId)
 
     EXPECT_TRUE(swid.starts_with(std::string(mb1ExampleComponent) + "_"));
 }
+
+TEST(SoftwareTest, testGetRandomSoftwareIdUnique)
+{
+    sdbusplus::async::context ctx;
+    ExampleCodeUpdater exampleUpdater(ctx);
+
+    auto device = std::make_unique<ExampleDevice>(ctx, &exampleUpdater);
+
+    // far more ids than the 10000 suffixes of a random number alone
+    std::set<std::string> swids;
+    for (int i = 0; i < 20000; i++)
+    {
+        swids.insert(TestSoftware::wrapGetRandomSoftwareId(*device));
+    }
+
+    EXPECT_EQ(swids.size(), 20000);
+}
@@ -10,11 +10,15 @@
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/async/context.hpp>
 #include <xyz/openbmc_project/Association/Definitions/client.hpp>
+#include <xyz/openbmc_project/Software/Activation/client.hpp>
+#include <xyz/openbmc_project/Software/ActivationProgress/client.hpp>
 #include <xyz/openbmc_project/Software/Update/client.hpp>
 #include <xyz/openbmc_project/Software/Version/client.hpp>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <optional>
 
 #include <gtest/gtest.h>
 
@@ -197,3 +201,283 @@ TEST(SoftwareUpdate, TestSoftwareUpdateFailureCorruptedPackage)
 
     testcaseSoftwareUpdateCommon(fd, false);
 }
+
+sdbusplus::async::task<> testSoftwareUpdateAll(sdbusplus::async::context& ctx,
+                                               int fd, bool expectUpdate)
+{
+    ExampleCodeUpdater exampleUpdater(ctx, true, "v12.345");
+
+    auto& device = exampleUpdater.getDevice();
+
+    uint8_t lastProgress = 0;
+    std::optional<bool> done;
+
+    auto paths = exampleUpdater.startUpdateAll(
+        fd, RequestedApplyTimes::Immediate,
+        [&lastProgress](uint8_t progress) {
+            EXPECT_GE(progress, lastProgress);
+            lastProgress = progress;
+        },
+        [&done](bool success) { done = success; });
+
+    EXPECT_EQ(paths.size(), expectUpdate ? 1 : 0);
+    EXPECT_EQ(device->updateInProgress, expectUpdate);
+
+    ssize_t timeout = 500;
+    while (device->updateInProgress && timeout > 0)
+    {
+        co_await sdbusplus::async::sleep_for(ctx, pollIntervalMs);
+        timeout -= 50;
+    }
+
+    EXPECT_EQ(device->deviceSpecificUpdateFunctionCalled, expectUpdate);
+
+    if (expectUpdate)
+    {
+        EXPECT_EQ(lastProgress, 100);
+        EXPECT_EQ(done, std::optional<bool>(true));
+        EXPECT_EQ(device->softwareCurrent->swid, paths[0].filename());
+    }
+    else
+    {
+        EXPECT_FALSE(done.has_value());
+    }
+
+    ctx.request_stop();
+
+    co_return;
+}
+
+TEST(SoftwareUpdate, TestSoftwareUpdateAllMatchingDevices)
+{
+    const int fd =
+        makeUpdateFd(exampleCompatibleHardware, exampleVendorIANA, false);
+
+    ASSERT_GE(fd, 0);
+
+    sdbusplus::async::context ctx;
+
+    ctx.spawn(testSoftwareUpdateAll(ctx, fd, true));
+
+    ctx.run();
+    close(fd);
+}
+
+sdbusplus::async::task<> testSoftwareUpdateAllViaDbus(
+    sdbusplus::async::context& ctx, int fd)
+{
+    ExampleCodeUpdater exampleUpdater(ctx, true, "v12.345");
+
+    auto& device = exampleUpdater.getDevice();
+
+    const std::string busName = exampleUpdater.getBusName();
+    const auto managerPath =
+        sdbusplus::object_path(sdbusplus::client::xyz::openbmc_project::
+                                   software::Version<>::namespace_path) /
+        busName.substr(busName.rfind('.') + 1);
+
+    // go via dbus to the update interface of the updater itself
+    auto client =
+        sdbusplus::client::xyz::openbmc_project::software::Update<>(ctx)
+            .service(busName)
+            .path(managerPath.str);
+
+    sdbusplus::object_path progressPath =
+        co_await client.start_update(fd, RequestedApplyTimes::Immediate);
+
+    EXPECT_EQ(progressPath, managerPath);
+
+    auto progressClient =
+        sdbusplus::client::xyz::openbmc_project::software::ActivationProgress<>(
+            ctx)
+            .service(busName)
+            .path(progressPath.str);
+
+    uint8_t progress = 0;
+    ssize_t timeout = 500;
+    while (progress < 100 && timeout > 0)
+    {
+        co_await sdbusplus::async::sleep_for(ctx, pollIntervalMs);
+        progress = co_await progressClient.progress();
+        timeout -= 50;
+    }
+
+    EXPECT_EQ(progress, 100);
+    EXPECT_TRUE(device->deviceSpecificUpdateFunctionCalled);
+
+    using Activations = sdbusplus::common::xyz::openbmc_project::software::
+        Activation::Activations;
+
+    auto activationClient =
+        sdbusplus::client::xyz::openbmc_project::software::Activation<>(ctx)
+            .service(busName)
+            .path(progressPath.str);
+
+    auto activation = Activations::Activating;
+    timeout = 500;
+    while (activation == Activations::Activating && timeout > 0)
+    {
+        activation = co_await activationClient.activation();
+        if (activation == Activations::Activating)
+        {
+            co_await sdbusplus::async::sleep_for(ctx, pollIntervalMs);
+            timeout -= 50;
+        }
+    }
+
+    EXPECT_EQ(activation, Activations::Active);
+
+    ssize_t cleanupTimeout = 500;
+    while (device->updateInProgress && cleanupTimeout > 0)
+    {
+        co_await sdbusplus::async::sleep_for(ctx, pollIntervalMs);
+        cleanupTimeout -= 50;
+    }
+
+    ctx.request_stop();
+
+    co_return;
+}
+
+TEST(SoftwareUpdate, TestSoftwareUpdateAllViaDbus)
+{
+    const int fd =
+        makeUpdateFd(exampleCompatibleHardware, exampleVendorIANA, false);
+
+    ASSERT_GE(fd, 0);
+
+    sdbusplus::async::context ctx;
+
+    ctx.spawn(testSoftwareUpdateAllViaDbus(ctx, fd));
+
+    ctx.run();
+    close(fd);
+}
+
+TEST(SoftwareUpdate, TestSoftwareUpdateAllNoMatchingDevice)
+{
+    const int fd = makeUpdateFd("not_compatible", exampleVendorIANA, false);
+
+    ASSERT_GE(fd, 0);
+
+    sdbusplus::async::context ctx;
+
+    ctx.spawn(testSoftwareUpdateAll(ctx, fd, false));
+
+    ctx.run();
+    close(fd);
+}
+
+sdbusplus::async::task<> testSchedulerQueuesSharedResource(
+    sdbusplus::async::context& ctx)
+{
+    update::UpdateScheduler scheduler(ctx);
+
+    std::vector<std::string> order;
+
+    auto job = [&ctx, &order](std::string name) {
+        return [&ctx, &order, name]() -> sdbusplus::async::task<> {
+            order.push_back(name + " start");
+            co_await sdbusplus::async::sleep_for(ctx, pollIntervalMs);
+            order.push_back(name + " end");
+        };
+    };
+
+    EXPECT_TRUE(scheduler.submit("a", {"i2c-1"}, job("a")));
+    EXPECT_FALSE(scheduler.submit("b", {"i2c-1", "i2c-2"}, job("b")));
+
+    // "c" would be free, but must not overtake "b" on i2c-2
+    EXPECT_FALSE(scheduler.submit("c", {"i2c-2"}, job("c")));
+
+    EXPECT_TRUE(scheduler.submit("d", {"i2c-3"}, job("d")));
+
+    EXPECT_EQ(scheduler.running(), 2);
+    EXPECT_EQ(scheduler.queued(), 2);
+
+    ssize_t timeout = 1000;
+    while ((scheduler.running() > 0 || scheduler.queued() > 0) && timeout > 0)
+    {
+        co_await sdbusplus::async::sleep_for(ctx, pollIntervalMs);
+        timeout -= 50;
+    }
+
+    auto index = [&order](const std::string& entry) {
+        return std::ranges::find(order, entry) - order.begin();
+    };
+
+    EXPECT_LT(index("a end"), index("b start"));
+    EXPECT_LT(index("b end"), index("c start"));
+    EXPECT_LT(index("d start"), index("a end"));
+
+    ctx.request_stop();
+
+    co_return;
+}
+
+TEST(SoftwareUpdate, TestSchedulerQueuesSharedResource)
+{
+    sdbusplus::async::context ctx;
+
+    ctx.spawn(testSchedulerQueuesSharedResource(ctx));
+
+    ctx.run();
+}
+
+sdbusplus::async::task<> testSchedulerSharesResource(
+    sdbusplus::async::context& ctx)
+{
+    update::UpdateScheduler scheduler(ctx);
+
+    std::vector<std::string> order;
+
+    auto job = [&ctx, &order](std::string name) {
+        return [&ctx, &order, name]() -> sdbusplus::async::task<> {
+            order.push_back(name + " start");
+            co_await sdbusplus::async::sleep_for(ctx, pollIntervalMs);
+            order.push_back(name + " end");
+        };
+    };
+
+    const std::string host = update::hostPowerResource;
+
+    EXPECT_TRUE(scheduler.submit("a", {"spi-1"}, job("a"), {host}));
+    EXPECT_TRUE(scheduler.submit("b", {"spi-2"}, job("b"), {host}));
+
+    // exclusive, waits for both holders to finish
+    EXPECT_FALSE(scheduler.submit("c", {"i2c-1", host}, job("c")));
+
+    // "d" could share with "a" and "b", but must not overtake "c"
+    EXPECT_FALSE(scheduler.submit("d", {"spi-3"}, job("d"), {host}));
+
+    EXPECT_EQ(scheduler.running(), 2);
+    EXPECT_EQ(scheduler.queued(), 2);
+
+    ssize_t timeout = 1000;
+    while ((scheduler.running() > 0 || scheduler.queued() > 0) && timeout > 0)
+    {
+        co_await sdbusplus::async::sleep_for(ctx, pollIntervalMs);
+        timeout -= 50;
+    }
+
+    auto index = [&order](const std::string& entry) {
+        return std::ranges::find(order, entry) - order.begin();
+    };
+
+    EXPECT_LT(index("b start"), index("a end"));
+    EXPECT_LT(index("a end"), index("c start"));
+    EXPECT_LT(index("b end"), index("c start"));
+    EXPECT_LT(index("c end"), index("d start"));
+
+    ctx.request_stop();
+
+    co_return;
+}
+
+TEST(SoftwareUpdate, TestSchedulerSharesResource)
+{
+    sdbusplus::async::context ctx;
+
+    ctx.spawn(testSchedulerSharesResource(ctx));
+
+    ctx.run();
+}
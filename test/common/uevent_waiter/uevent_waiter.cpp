@@ -0,0 +1,85 @@
+#include "common/include/uevent_waiter.hpp"
+
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+using namespace phosphor::software;
+
+using std::chrono::steady_clock;
+
+class UeventWaiterTest : public testing::Test
+{
+  protected:
+    // @brief         Wait for a condition which becomes true 'after' the
+    //                start of the wait, never if 'after' is std::nullopt.
+    // @returns       whether the wait succeeded
+    bool wait(bool uevents, std::optional<std::chrono::milliseconds> after,
+              std::chrono::milliseconds timeout)
+    {
+        bool result = false;
+
+        auto test = [](UeventWaiterTest& t, bool uevents,
+                       std::optional<std::chrono::milliseconds> after,
+                       std::chrono::milliseconds timeout,
+                       bool& result) -> sdbusplus::async::task<> {
+            UeventWaiter waiter(t.ctx, uevents);
+
+            t.start = steady_clock::now();
+            result = co_await waiter.waitFor(
+                [&t, after] {
+                    t.checks++;
+                    return after.has_value() &&
+                           steady_clock::now() - t.start >= after.value();
+                },
+                timeout);
+            t.elapsed = steady_clock::now() - t.start;
+
+            t.ctx.request_stop();
+        };
+
+        ctx.spawn(test(*this, uevents, after, timeout, result));
+        ctx.run();
+
+        return result;
+    }
+
+    sdbusplus::async::context ctx;
+    steady_clock::time_point start;
+    steady_clock::duration elapsed{};
+    size_t checks = 0;
+};
+
+TEST_F(UeventWaiterTest, conditionAlreadyTrue)
+{
+    EXPECT_TRUE(wait(true, 0ms, 5s));
+    EXPECT_EQ(checks, 1);
+    EXPECT_LT(elapsed, 1s);
+}
+
+TEST_F(UeventWaiterTest, pollingNoticesCondition)
+{
+    // no uevent signals the condition, so only polling notices it
+    EXPECT_TRUE(wait(false, 250ms, 5s));
+    EXPECT_GE(elapsed, 250ms);
+    EXPECT_LT(elapsed, 1s);
+    EXPECT_GT(checks, 2);
+}
+
+TEST_F(UeventWaiterTest, pollingTimesOut)
+{
+    EXPECT_FALSE(wait(false, std::nullopt, 300ms));
+    EXPECT_GE(elapsed, 300ms);
+    EXPECT_LT(elapsed, 1s);
+}
+
+TEST_F(UeventWaiterTest, timesOut)
+{
+    EXPECT_FALSE(wait(true, std::nullopt, 300ms));
+    EXPECT_GE(elapsed, 300ms);
+    EXPECT_LT(elapsed, 1s);
+}
@@ -0,0 +1,80 @@
+#include "common/include/update_timing.hpp"
+
+#include <stdlib.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::software;
+
+TEST(UpdateTimelineTest, TestDriverStagesNestedInUpdateStage)
+{
+    timing::UpdateTimeline timeline("v1");
+
+    timeline.begin("package");
+    timeline.begin("update");
+    timeline.mark("erase");
+    timeline.mark("program");
+    timeline.begin("reset");
+    timeline.finish(true);
+
+    std::vector<std::string> names;
+    for (const auto& stage : timeline.stages)
+    {
+        names.push_back(stage.name);
+    }
+
+    EXPECT_EQ(names,
+              (std::vector<std::string>{"package", "update", "update.erase",
+                                        "update.program", "reset"}));
+    EXPECT_TRUE(timeline.success);
+    EXPECT_EQ(timeline.version, "v1");
+}
+
+TEST(UpdateTimingHistoryTest, TestKeepsLastTimelines)
+{
+    timing::UpdateTimingHistory history("", 2);
+
+    for (const auto* version : {"v1", "v2", "v3"})
+    {
+        timing::UpdateTimeline timeline(version);
+        timeline.begin("update");
+        timeline.finish(true);
+        history.add(std::move(timeline));
+    }
+
+    ASSERT_EQ(history.timelines().size(), 2);
+    EXPECT_EQ(history.timelines().front().version, "v2");
+    EXPECT_EQ(history.timelines().back().version, "v3");
+}
+
+TEST(UpdateTimingHistoryTest, TestDumpsToFile)
+{
+    char dir[] = "/tmp/update_timing_XXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+
+    const std::string path = std::string(dir) + "/timing.txt";
+    timing::UpdateTimingHistory history(path, 8);
+
+    timing::UpdateTimeline timeline("v1");
+    timeline.begin("update");
+    timeline.mark("erase");
+    timeline.finish(false);
+    history.add(std::move(timeline));
+
+    std::ifstream file(path);
+    const std::string content((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+
+    EXPECT_EQ(content, history.dump());
+    EXPECT_NE(content.find("update to v1 started"), std::string::npos);
+    EXPECT_NE(content.find(": failed\n"), std::string::npos);
+    EXPECT_NE(content.find("  update.erase "), std::string::npos);
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,36 @@
+#include "common/include/worker_pool.hpp"
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::software;
+
+TEST(WorkerPoolTest, TestLanesRunInParallelAndInOrder)
+{
+    auto& pool = WorkerPool::instance();
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<void> otherLaneDone;
+    std::promise<std::vector<int>> order;
+
+    auto seen = std::make_shared<std::vector<int>>();
+
+    // lane a is blocked until lane b has run
+    pool.post("test-a", [released] { released.wait(); });
+    pool.post("test-a", [seen] { seen->push_back(1); });
+    pool.post("test-a", [seen, &order] {
+        seen->push_back(2);
+        order.set_value(*seen);
+    });
+    pool.post("test-b", [&otherLaneDone] { otherLaneDone.set_value(); });
+
+    otherLaneDone.get_future().wait();
+    release.set_value();
+
+    EXPECT_EQ(order.get_future().get(), (std::vector<int>{1, 2}));
+    EXPECT_GE(pool.lanes(), 2);
+}
@@ -0,0 +1,146 @@
+#include "spi-flash/flash_layout.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace phosphor::software::spi;
+
+constexpr size_t regionTable = 0x40;
+constexpr size_t flashSize = 0x10000;
+
+// @param signatureOffset  where the descriptor signature is, 0 or 16
+// @returns                an erased descriptor without any used region
+static std::vector<uint8_t> makeDescriptor(size_t signatureOffset)
+{
+    std::vector<uint8_t> data(descriptorSize, 0xff);
+
+    const uint32_t signature = 0x0FF0A55A;
+    const uint32_t flmap0 = (regionTable >> 4) << 16;
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        data[signatureOffset + i] = (signature >> (i * 8)) & 0xff;
+        data[signatureOffset + 4 + i] = (flmap0 >> (i * 8)) & 0xff;
+    }
+
+    return data;
+}
+
+// @param index    index of the region, e.g. 0 for "fd" and 1 for "bios"
+// @param base     offset of the region, in bytes
+// @param limit    offset of the last byte of the region
+static void setRegion(std::vector<uint8_t>& data, size_t index, uint32_t base,
+                      uint32_t limit)
+{
+    const uint32_t flreg = (base >> 12) | ((limit >> 12) << 16);
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        data[regionTable + index * 4 + i] = (flreg >> (i * 8)) & 0xff;
+    }
+}
+
+TEST(FlashLayoutTest, parsesDescriptorOrderedByOffset)
+{
+    auto data = makeDescriptor(16);
+    setRegion(data, 0, 0x0000, 0x0fff);
+    setRegion(data, 1, 0x8000, 0xffff);
+    setRegion(data, 2, 0x1000, 0x7fff);
+
+    auto regions = parseIntelFlashDescriptor(data, flashSize);
+
+    ASSERT_TRUE(regions.has_value());
+    EXPECT_EQ(regions.value(), (std::vector<FlashRegion>{
+                                   {"fd", 0x0000, 0x1000},
+                                   {"me", 0x1000, 0x7000},
+                                   {"bios", 0x8000, 0x8000},
+                               }));
+}
+
+TEST(FlashLayoutTest, parsesSignatureAtOffsetZero)
+{
+    auto data = makeDescriptor(0);
+    setRegion(data, 0, 0x0000, 0x0fff);
+    setRegion(data, 1, 0x1000, 0xffff);
+
+    auto regions = parseIntelFlashDescriptor(data, flashSize);
+
+    ASSERT_TRUE(regions.has_value());
+    EXPECT_EQ(regions->size(), 2);
+}
+
+TEST(FlashLayoutTest, skipsUnusedRegions)
+{
+    auto data = makeDescriptor(16);
+    setRegion(data, 0, 0x0000, 0x0fff);
+    setRegion(data, 1, 0x1000, 0xffff);
+    // base above limit marks an unused region
+    setRegion(data, 2, 0x7fff000, 0x0000);
+    // the other entries are erased
+
+    auto regions = parseIntelFlashDescriptor(data, flashSize);
+
+    ASSERT_TRUE(regions.has_value());
+    EXPECT_EQ(regions.value(), (std::vector<FlashRegion>{
+                                   {"fd", 0x0000, 0x1000},
+                                   {"bios", 0x1000, 0xf000},
+                               }));
+}
+
+TEST(FlashLayoutTest, rejectsMissingSignature)
+{
+    std::vector<uint8_t> data(descriptorSize, 0xff);
+
+    EXPECT_FALSE(parseIntelFlashDescriptor(data, flashSize).has_value());
+}
+
+TEST(FlashLayoutTest, rejectsShortData)
+{
+    auto data = makeDescriptor(16);
+    setRegion(data, 0, 0x0000, 0x0fff);
+    data.resize(descriptorSize - 1);
+
+    EXPECT_FALSE(parseIntelFlashDescriptor(data, flashSize).has_value());
+}
+
+TEST(FlashLayoutTest, rejectsOverlappingRegions)
+{
+    auto data = makeDescriptor(16);
+    setRegion(data, 0, 0x0000, 0x0fff);
+    setRegion(data, 1, 0x4000, 0xffff);
+    setRegion(data, 2, 0x1000, 0x4fff);
+
+    EXPECT_FALSE(parseIntelFlashDescriptor(data, flashSize).has_value());
+}
+
+TEST(FlashLayoutTest, rejectsRegionBeyondFlash)
+{
+    auto data = makeDescriptor(16);
+    setRegion(data, 0, 0x0000, 0x0fff);
+    setRegion(data, 1, 0x1000, 0x1ffff);
+
+    EXPECT_FALSE(parseIntelFlashDescriptor(data, flashSize).has_value());
+}
+
+TEST(FlashLayoutTest, rejectsDescriptorNotAtStart)
+{
+    auto data = makeDescriptor(16);
+    setRegion(data, 0, 0x1000, 0x1fff);
+    setRegion(data, 1, 0x2000, 0xffff);
+
+    EXPECT_FALSE(parseIntelFlashDescriptor(data, flashSize).has_value());
+}
+
+TEST(FlashLayoutTest, findsRegionByName)
+{
+    const std::vector<FlashRegion> regions = {
+        {"fd", 0x0000, 0x1000},
+        {"bios", 0x1000, 0xf000},
+    };
+
+    EXPECT_EQ(findRegion(regions, "bios"),
+              (FlashRegion{"bios", 0x1000, 0xf000}));
+    EXPECT_FALSE(findRegion(regions, "me").has_value());
+}